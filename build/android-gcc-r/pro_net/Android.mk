@@ -15,12 +15,14 @@ LOCAL_SRC_FILES := pro_acceptor.cpp        \
                    pro_service_host.cpp    \
                    pro_service_hub.cpp     \
                    pro_service_pipe.cpp    \
+                   pro_ssl_crypto_pool.cpp \
                    pro_ssl_handshaker.cpp  \
                    pro_ssl_transport.cpp   \
                    pro_tcp_handshaker.cpp  \
                    pro_tcp_transport.cpp   \
                    pro_tp_reactor_task.cpp \
-                   pro_udp_transport.cpp
+                   pro_udp_transport.cpp   \
+                   pro_uring_reactor.cpp
 
 LOCAL_C_INCLUDES    := $(PRO_ROOT_DIR)/src/mbedtls/include
 LOCAL_CFLAGS        := -DPRO_NET_EXPORTS \
@@ -25,6 +25,8 @@ CPPFLAGS="-DNDEBUG                        \
           -D_REENTRANT                    \
           -DPRO_HAS_ATOMOP                \
           -DPRO_HAS_ACCEPT4               \
+          -DPRO_HAS_MMSG                  \
+          -DPRO_HAS_IO_URING              \
           -DPRO_HAS_EPOLL"                \
 CFLAGS="  -O2 -Wall -march=pentium4 -m32" \
 CXXFLAGS="-O2 -Wall -march=pentium4 -m32" \
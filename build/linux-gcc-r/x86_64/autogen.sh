@@ -25,6 +25,9 @@ CPPFLAGS="-DNDEBUG                      \
           -D_REENTRANT                  \
           -DPRO_HAS_ATOMOP              \
           -DPRO_HAS_ACCEPT4             \
+          -DPRO_HAS_MMSG                \
+          -DPRO_HAS_IO_URING            \
+          -DPRO_HAS_MBEDTLS_ASM         \
           -DPRO_HAS_EPOLL"              \
 CFLAGS="  -O2 -Wall -march=nocona -m64" \
 CXXFLAGS="-O2 -Wall -march=nocona -m64" \
@@ -152,6 +152,10 @@ SOURCE=..\..\..\src\pro\pro_net\pro_service_pipe.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\src\pro\pro_net\pro_ssl_crypto_pool.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\..\src\pro\pro_net\pro_ssl_handshaker.cpp
 # End Source File
 # Begin Source File
@@ -174,6 +178,10 @@ SOURCE=..\..\..\src\pro\pro_net\pro_tp_reactor_task.cpp
 
 SOURCE=..\..\..\src\pro\pro_net\pro_udp_transport.cpp
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\..\src\pro\pro_net\pro_uring_reactor.cpp
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
@@ -244,6 +252,10 @@ SOURCE=..\..\..\src\pro\pro_net\pro_service_pipe.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\src\pro\pro_net\pro_ssl_crypto_pool.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\..\src\pro\pro_net\pro_ssl_handshaker.h
 # End Source File
 # Begin Source File
@@ -266,6 +278,10 @@ SOURCE=..\..\..\src\pro\pro_net\pro_tp_reactor_task.h
 
 SOURCE=..\..\..\src\pro\pro_net\pro_udp_transport.h
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\..\src\pro\pro_net\pro_uring_reactor.h
+# End Source File
 # End Group
 # Begin Group "Resource Files"
 
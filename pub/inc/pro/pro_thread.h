@@ -72,6 +72,48 @@ PRO_UINT64
 PRO_CALLTYPE
 ProGetThreadId();
 
+/*
+ * the names show up in ps/top/perf. at most 15 chars on Linux.
+ * it's a no-op on the systems that don't support it
+ */
+void
+PRO_CALLTYPE
+ProSetThreadName(const char* name);
+
+/*
+ * binds the calling thread to the cpus in "cpuMask" (bit i for cpu i, so
+ * only the cpus 0 ~ 63 can be used).
+ * returns false if it fails or isn't supported
+ */
+bool
+PRO_CALLTYPE
+ProSetThreadAffinity(PRO_UINT64 cpuMask);
+
+/*
+ * returns 0 if it fails or isn't supported
+ */
+PRO_UINT64
+PRO_CALLTYPE
+ProGetThreadAffinity();
+
+/*
+ * the first cpu of each physical core that the calling thread may run on,
+ * ordered by the numa node. the hyperthread siblings are skipped.
+ * returns the number of the cpus written to "cpus"
+ */
+unsigned long
+PRO_CALLTYPE
+ProGetCoreCpus(unsigned long* cpus,
+               unsigned long  count);
+
+/*
+ * the cpu time of a running thread in microseconds, where "threadId" is
+ * returned by ProGetThreadId(). returns -1 if it's unavailable
+ */
+PRO_INT64
+PRO_CALLTYPE
+ProGetThreadCpuTime(PRO_UINT64 threadId);
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
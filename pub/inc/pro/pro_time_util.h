@@ -159,6 +159,13 @@ PRO_INT64
 PRO_CALLTYPE
 ProGetTickCount64();
 
+/*
+ * a monotonic tick in microseconds, for the short intervals
+ */
+PRO_INT64
+PRO_CALLTYPE
+ProGetMicroTickCount64();
+
 void
 PRO_CALLTYPE
 ProSleep(PRO_UINT32 milliseconds);
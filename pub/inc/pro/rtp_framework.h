@@ -193,6 +193,7 @@ extern "C" {
 #endif
 
 class  IProReactor;           /* Ӧ.μ"pro_net.h" */
+class  IProSendBuffer;        /* ͻ.μ"pro_net.h" */
 class  IRtpService;           /* rtp */
 struct PRO_SSL_CLIENT_CONFIG; /* ͻssl */
 struct PRO_SSL_CTX;           /* ssl */
@@ -326,6 +327,8 @@ public:
     virtual void PRO_CALLTYPE SetTick_i(PRO_INT64 tick) = 0;
 
     virtual PRO_INT64 PRO_CALLTYPE GetTick_i() const = 0;
+
+    virtual IProSendBuffer* PRO_CALLTYPE GetSendBuffer_i() = 0;
 };
 #endif /* ____IRtpPacket____ */
 
@@ -450,6 +453,9 @@ public:
      *
      * false,ʾͳ,ϲӦûԴ
      * OnSendSession(...)صȡ
+     *
+     * tcp/sslỰpacket,ǳpacketֱ,
+     * ͬһpacketԷỰ.packet֮ٱ޸
      */
     virtual bool PRO_CALLTYPE SendPacket(
         IRtpPacket* packet,
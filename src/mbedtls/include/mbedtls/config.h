@@ -80,6 +80,15 @@ ProFree(void* p);
  * Comment to disable the use of assembly code.
  */
 //// #define MBEDTLS_HAVE_ASM
+////
+//// [[[[
+////
+#if defined(PRO_HAS_MBEDTLS_ASM)
+#define MBEDTLS_HAVE_ASM
+#endif
+////
+//// ]]]]
+////
 
 /**
  * \def MBEDTLS_NO_UDBL_DIVISION
@@ -1492,7 +1501,7 @@ ProFree(void* p);
  *
  * Comment this macro to disable support for SSL session tickets
  */
-//// #define MBEDTLS_SSL_SESSION_TICKETS
+#define MBEDTLS_SSL_SESSION_TICKETS
 
 /**
  * \def MBEDTLS_SSL_EXPORT_KEYS
@@ -1688,6 +1697,15 @@ ProFree(void* p);
  * This modules adds support for the AES-NI instructions on x86-64
  */
 //// #define MBEDTLS_AESNI_C
+////
+//// [[[[
+////
+#if defined(PRO_HAS_MBEDTLS_ASM)
+#define MBEDTLS_AESNI_C
+#endif
+////
+//// ]]]]
+////
 
 /**
  * \def MBEDTLS_AES_C
@@ -2670,7 +2688,7 @@ ProFree(void* p);
  *
  * Requires: MBEDTLS_SSL_CACHE_C
  */
-//// #define MBEDTLS_SSL_CACHE_C
+#define MBEDTLS_SSL_CACHE_C
 
 /**
  * \def MBEDTLS_SSL_COOKIE_C
@@ -2692,7 +2710,7 @@ ProFree(void* p);
  *
  * Requires: MBEDTLS_CIPHER_C
  */
-//// #define MBEDTLS_SSL_TICKET_C
+#define MBEDTLS_SSL_TICKET_C
 
 /**
  * \def MBEDTLS_SSL_CLI_C
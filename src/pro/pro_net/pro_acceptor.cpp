@@ -61,6 +61,54 @@ MakeNonce_i()
     return (n);
 }
 
+static
+PRO_INT64
+PRO_CALLTYPE
+OpenListenSocket_i(pbsd_sockaddr_in* localAddr,
+                   bool              reusePort)
+{
+    assert(localAddr != NULL);
+
+    const PRO_INT64 sockId = pbsd_socket(AF_INET, SOCK_STREAM, 0);
+    if (sockId == -1)
+    {
+        return (-1);
+    }
+
+    int option;
+    option = DEFAULT_RECV_BUF_SIZE;
+    pbsd_setsockopt(sockId, SOL_SOCKET, SO_RCVBUF, &option, sizeof(int));
+    option = DEFAULT_SEND_BUF_SIZE;
+    pbsd_setsockopt(sockId, SOL_SOCKET, SO_SNDBUF, &option, sizeof(int));
+    option = 1;
+    pbsd_setsockopt(sockId, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(int));
+
+#if !defined(WIN32) && !defined(_WIN32_WCE) && defined(SO_REUSEPORT)
+    if (reusePort)
+    {
+        option = 1;
+        pbsd_setsockopt(sockId, SOL_SOCKET, SO_REUSEPORT, &option, sizeof(int));
+    }
+#endif
+
+#if defined(WIN32) || defined(_WIN32_WCE)
+    if (pbsd_bind(sockId, localAddr, false) != 0
+#else
+    if (pbsd_bind(sockId, localAddr, true ) != 0
+#endif
+        ||
+        pbsd_getsockname(sockId, localAddr) != 0
+        ||
+        pbsd_listen(sockId) != 0)
+    {
+        ProCloseSockId(sockId);
+
+        return (-1);
+    }
+
+    return (sockId);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -79,6 +127,7 @@ CProAcceptor::CProAcceptor(bool enableServiceExt)
     m_reactorTask      = NULL;
     m_sockId           = -1;
     m_sockIdUn         = -1;
+    m_shardCount       = 0;
     m_timeoutInSeconds = DEFAULT_TIMEOUT;
 
     memset(&m_localAddr  , 0, sizeof(pbsd_sockaddr_in));
@@ -99,6 +148,16 @@ CProAcceptor::~CProAcceptor()
 #endif
     m_sockId   = -1;
     m_sockIdUn = -1;
+
+    int       i = 0;
+    const int c = (int)m_shardSockIds.size();
+
+    for (; i < c; ++i)
+    {
+        ProCloseSockId(m_shardSockIds[i]);
+    }
+
+    m_shardSockIds.clear();
 }
 
 bool
@@ -137,9 +196,11 @@ CProAcceptor::Init(IProAcceptorObserver* observer,
         return (false);
     }
 
-    PRO_INT64        sockId   = -1;
-    PRO_INT64        sockIdUn = -1;
-    pbsd_sockaddr_un localAddrUn;
+    PRO_INT64                sockId     = -1;
+    PRO_INT64                sockIdUn   = -1;
+    unsigned long            shardCount = 0;
+    CProStlVector<PRO_INT64> shardSockIds;
+    pbsd_sockaddr_un         localAddrUn;
     memset(&localAddrUn, 0, sizeof(pbsd_sockaddr_un));
 
     {
@@ -152,40 +213,47 @@ CProAcceptor::Init(IProAcceptorObserver* observer,
             return (false);
         }
 
-        sockId = pbsd_socket(AF_INET, SOCK_STREAM, 0);
+        /*
+         * with PRO_REACTOR_OPTIONS::shardedAccept, the kernel spreads the
+         * connections over one SO_REUSEPORT socket per I/O reactor, and the
+         * first one decides the port
+         */
+        shardCount = reactorTask->GetAcceptShardCount();
+
+        sockId = OpenListenSocket_i(&localAddr, shardCount > 0);
         if (sockId == -1)
         {
             goto EXIT;
         }
 
-        int option;
-        option = DEFAULT_RECV_BUF_SIZE;
-        pbsd_setsockopt(sockId, SOL_SOCKET, SO_RCVBUF, &option, sizeof(int));
-        option = DEFAULT_SEND_BUF_SIZE;
-        pbsd_setsockopt(sockId, SOL_SOCKET, SO_SNDBUF, &option, sizeof(int));
-        option = 1;
-        pbsd_setsockopt(sockId, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(int));
+        SetEdgeTriggered(reactorTask->IsEdgeTriggered());
 
-#if defined(WIN32) || defined(_WIN32_WCE)
-        if (pbsd_bind(sockId, &localAddr, false) != 0)
-#else
-        if (pbsd_bind(sockId, &localAddr, true ) != 0)
-#endif
+        if (shardCount > 0)
         {
-            goto EXIT;
-        }
+            if (!reactorTask->AddAcceptShard(sockId, this, 0))
+            {
+                goto EXIT;
+            }
 
-        if (pbsd_getsockname(sockId, &localAddr) != 0)
-        {
-            goto EXIT;
-        }
+            for (int i = 1; i < (int)shardCount; ++i)
+            {
+                pbsd_sockaddr_in shardAddr = localAddr;
 
-        if (pbsd_listen(sockId) != 0)
-        {
-            goto EXIT;
-        }
+                const PRO_INT64 shardSockId = OpenListenSocket_i(&shardAddr, true);
+                if (shardSockId == -1)
+                {
+                    goto EXIT;
+                }
 
-        if (!reactorTask->AddHandler(sockId, this, PRO_MASK_ACCEPT))
+                shardSockIds.push_back(shardSockId);
+
+                if (!reactorTask->AddAcceptShard(shardSockId, this, i))
+                {
+                    goto EXIT;
+                }
+            }
+        }
+        else if (!reactorTask->AddHandler(sockId, this, PRO_MASK_ACCEPT))
         {
             goto EXIT;
         }
@@ -198,6 +266,7 @@ CProAcceptor::Init(IProAcceptorObserver* observer,
             goto EXIT;
         }
 
+        int option;
         option = DEFAULT_RECV_BUF_SIZE;
         pbsd_setsockopt(sockIdUn, SOL_SOCKET, SO_RCVBUF, &option, sizeof(int));
         option = DEFAULT_SEND_BUF_SIZE;
@@ -234,6 +303,8 @@ CProAcceptor::Init(IProAcceptorObserver* observer,
         m_reactorTask      = reactorTask;
         m_sockId           = sockId;
         m_sockIdUn         = sockIdUn;
+        m_shardCount       = shardCount;
+        m_shardSockIds     = shardSockIds;
         m_localAddr        = localAddr;
         m_localAddrUn      = localAddrUn;
         m_timeoutInSeconds = timeoutInSeconds;
@@ -243,10 +314,26 @@ CProAcceptor::Init(IProAcceptorObserver* observer,
 
 EXIT:
 
-    reactorTask->RemoveHandler(sockId  , this, PRO_MASK_ACCEPT);
+    if (shardCount > 0)
+    {
+        reactorTask->RemoveAcceptShard(sockId, this, 0);
+    }
+    else
+    {
+        reactorTask->RemoveHandler(sockId, this, PRO_MASK_ACCEPT);
+    }
     reactorTask->RemoveHandler(sockIdUn, this, PRO_MASK_ACCEPT);
     ProCloseSockId(sockId);
     ProCloseSockId(sockIdUn);
+
+    int       i = 0;
+    const int c = (int)shardSockIds.size();
+
+    for (; i < c; ++i)
+    {
+        reactorTask->RemoveAcceptShard(shardSockIds[i], this, i + 1);
+        ProCloseSockId(shardSockIds[i]);
+    }
 #if !defined(WIN32) && !defined(_WIN32_WCE)
     if (sockIdUn != -1)
     {
@@ -271,9 +358,24 @@ CProAcceptor::Fini()
             return;
         }
 
-        m_reactorTask->RemoveHandler(m_sockId  , this, PRO_MASK_ACCEPT);
+        if (m_shardCount > 0)
+        {
+            m_reactorTask->RemoveAcceptShard(m_sockId, this, 0);
+        }
+        else
+        {
+            m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_ACCEPT);
+        }
         m_reactorTask->RemoveHandler(m_sockIdUn, this, PRO_MASK_ACCEPT);
 
+        int       i = 0;
+        const int c = (int)m_shardSockIds.size();
+
+        for (; i < c; ++i)
+        {
+            m_reactorTask->RemoveAcceptShard(m_shardSockIds[i], this, i + 1);
+        }
+
         handshaker2Nonce = m_handshaker2Nonce;
         m_handshaker2Nonce.clear();
         m_reactorTask = NULL;
@@ -327,11 +429,44 @@ CProAcceptor::GetLocalPort() const
 void
 PRO_CALLTYPE
 CProAcceptor::OnInput(PRO_INT64 sockId)
+{
+    /*
+     * accept until EAGAIN, but no more than PRO_EDGE_BUDGET times, and
+     * then the rest is accepted in the next round
+     */
+    int i = 0;
+
+    for (; i < PRO_EDGE_BUDGET; ++i)
+    {
+        if (!DoAccept(sockId))
+        {
+            return;
+        }
+    }
+
+    if (!IsEdgeTriggered())
+    {
+        return;
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_observer != NULL && m_reactorTask != NULL &&
+            (sockId == m_sockId || sockId == m_sockIdUn || IsShard_i(sockId)))
+        {
+            m_reactorTask->RaiseHandlerEvent(sockId, this, PRO_MASK_ACCEPT);
+        }
+    }
+}
+
+bool
+CProAcceptor::DoAccept(PRO_INT64 sockId)
 {
     assert(sockId != -1);
     if (sockId == -1)
     {
-        return;
+        return (false);
     }
 
     IProAcceptorObserver* observer   = NULL;
@@ -345,39 +480,61 @@ CProAcceptor::OnInput(PRO_INT64 sockId)
 
         if (m_observer == NULL || m_reactorTask == NULL)
         {
-            return;
+            return (false);
         }
 
-        if (sockId == m_sockId)
+        if (sockId == m_sockId || IsShard_i(sockId))
         {
-            newSockId  = pbsd_accept(m_sockId, &remoteAddr);
             unixSocket = false;
         }
         else if (sockId == m_sockIdUn)
         {
-            pbsd_sockaddr_un remoteAddrUn;
-            newSockId  = pbsd_accept_un(m_sockIdUn, &remoteAddrUn);
             unixSocket = true;
         }
         else
         {
-            return;
+            return (false);
         }
+    }
 
-        if (newSockId == -1)
-        {
-            return;
-        }
+    /*
+     * the listening sockets are closed in the destructor only, so the
+     * shards accept out of the lock in parallel
+     */
+    if (unixSocket)
+    {
+        pbsd_sockaddr_un remoteAddrUn;
+        newSockId = pbsd_accept_un(sockId, &remoteAddrUn);
+    }
+    else
+    {
+        newSockId = pbsd_accept(sockId, &remoteAddr);
+    }
 
-        int option;
-        option = DEFAULT_RECV_BUF_SIZE;
-        pbsd_setsockopt(newSockId, SOL_SOCKET, SO_RCVBUF, &option, sizeof(int));
-        option = DEFAULT_SEND_BUF_SIZE;
-        pbsd_setsockopt(newSockId, SOL_SOCKET, SO_SNDBUF, &option, sizeof(int));
-        if (!unixSocket)
+    if (newSockId == -1)
+    {
+        return (false);
+    }
+
+    int option;
+    option = DEFAULT_RECV_BUF_SIZE;
+    pbsd_setsockopt(newSockId, SOL_SOCKET, SO_RCVBUF, &option, sizeof(int));
+    option = DEFAULT_SEND_BUF_SIZE;
+    pbsd_setsockopt(newSockId, SOL_SOCKET, SO_SNDBUF, &option, sizeof(int));
+    if (!unixSocket)
+    {
+        option = 1;
+        pbsd_setsockopt(newSockId, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(int));
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_observer == NULL || m_reactorTask == NULL)
         {
-            option = 1;
-            pbsd_setsockopt(newSockId, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(int));
+            ProCloseSockId(newSockId);
+
+            return (false);
         }
 
         /*
@@ -387,7 +544,7 @@ CProAcceptor::OnInput(PRO_INT64 sockId)
         {
             ProCloseSockId(newSockId);
 
-            return;
+            return (true);
         }
 
         if (m_enableServiceExt)
@@ -414,7 +571,7 @@ CProAcceptor::OnInput(PRO_INT64 sockId)
                 ProCloseSockId(newSockId);
             }
 
-            return;
+            return (true);
         }
 
         m_observer->AddRef();
@@ -440,6 +597,25 @@ CProAcceptor::OnInput(PRO_INT64 sockId)
         0  /* nonce */
         );
     observer->Release();
+
+    return (true);
+}
+
+bool
+CProAcceptor::IsShard_i(PRO_INT64 sockId) const
+{
+    int       i = 0;
+    const int c = (int)m_shardSockIds.size();
+
+    for (; i < c; ++i)
+    {
+        if (m_shardSockIds[i] == sockId)
+        {
+            return (true);
+        }
+    }
+
+    return (false);
 }
 
 void
@@ -71,6 +71,10 @@ private:
 
     virtual void PRO_CALLTYPE OnInput(PRO_INT64 sockId);
 
+    bool DoAccept(PRO_INT64 sockId); /* returns true if a connection is taken */
+
+    bool IsShard_i(PRO_INT64 sockId) const;
+
     virtual void PRO_CALLTYPE OnError(
         PRO_INT64 sockId,
         long      errorCode
@@ -98,6 +102,8 @@ private:
     CProTpReactorTask*                         m_reactorTask;
     PRO_INT64                                  m_sockId;
     PRO_INT64                                  m_sockIdUn;
+    unsigned long                              m_shardCount;
+    CProStlVector<PRO_INT64>                   m_shardSockIds; /* shards 1 ~ n-1. shard 0 is m_sockId */
     pbsd_sockaddr_in                           m_localAddr;
     pbsd_sockaddr_un                           m_localAddrUn;
     unsigned long                              m_timeoutInSeconds;
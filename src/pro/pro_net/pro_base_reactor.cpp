@@ -21,16 +21,55 @@
 #include "pro_handler_mgr.h"
 #include "pro_notify_pipe.h"
 #include "../pro_util/pro_bsd_wrapper.h"
+#include "../pro_util/pro_functor_command.h"
+#include "../pro_util/pro_stl.h"
+#include "../pro_util/pro_thread.h"
 #include "../pro_util/pro_thread_mutex.h"
+#include "../pro_util/pro_time_util.h"
+#include "../pro_util/pro_timer_factory.h"
+
+#if defined(WIN32) || defined(_WIN32_WCE)
+#include <windows.h>
+#endif
+
+#include <cassert>
+#include <cstring>
 
 /////////////////////////////////////////////////////////////////////////////
 ////
 
 CProBaseReactor::CProBaseReactor()
 {
-    m_threadId   = 0;
-    m_wantExit   = false;
-    m_notifyPipe = new CProNotifyPipe;
+    m_threadId      = 0;
+    m_wantExit      = false;
+    m_notifyPipe    = new CProNotifyPipe;
+    m_tasks         = NULL;
+    m_busyPollUs    = 0;
+    m_lastEventTick = 0;
+    m_spinCount     = 0;
+    m_spinHitCount  = 0;
+}
+
+CProBaseReactor::~CProBaseReactor()
+{
+    PRO_REACTOR_TASK* task = PopTasks_i();
+
+    while (task != NULL)
+    {
+        PRO_REACTOR_TASK* const next = task->next;
+        DestroyTask_i(task);
+        task = next;
+    }
+
+    int       i = 0;
+    const int c = (int)m_retiredPipes.size();
+
+    for (; i < c; ++i)
+    {
+        delete m_retiredPipes[i];
+    }
+
+    m_retiredPipes.clear();
 }
 
 unsigned long
@@ -47,3 +86,516 @@ CProBaseReactor::GetHandlerCount() const
 
     return (count);
 }
+
+void
+PRO_CALLTYPE
+CProBaseReactor::GetWakeupCounts(PRO_UINT64& wakeups,
+                                 PRO_UINT64& coalesced) const
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        wakeups   = m_notifyPipe->GetWakeupCount();
+        coalesced = m_notifyPipe->GetCoalescedCount();
+    }
+}
+
+bool
+PRO_CALLTYPE
+CProBaseReactor::RaiseEvent(PRO_INT64         sockId,
+                            CProEventHandler* handler,
+                            unsigned long     mask)
+{
+    return (false);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProBaseReactor::DropRaisedEvents(PRO_INT64 sockId)
+{
+    return (0);
+}
+
+bool
+PRO_CALLTYPE
+CProBaseReactor::InitTimers(bool timingWheel)
+{
+    return (false);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProBaseReactor::ScheduleTimer(IProOnTimer* onTimer,
+                               PRO_UINT64   timeSpan,
+                               bool         recurring,
+                               PRO_INT64    userData)
+{
+    return (0);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProBaseReactor::ScheduleHeartbeatTimer(IProOnTimer* onTimer,
+                                        PRO_INT64    userData)
+{
+    return (0);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProBaseReactor::JoinHeartbeatGroup(PRO_HEARTBEAT_ENTRY* entry,
+                                    IProOnTimer*         onTimer,
+                                    PRO_INT64            userData)
+{
+    return (0);
+}
+
+bool
+PRO_CALLTYPE
+CProBaseReactor::LeaveHeartbeatGroup(PRO_HEARTBEAT_ENTRY* entry,
+                                     unsigned long        timerId)
+{
+    return (false);
+}
+
+bool
+PRO_CALLTYPE
+CProBaseReactor::UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds)
+{
+    return (false);
+}
+
+bool
+PRO_CALLTYPE
+CProBaseReactor::CancelTimer(unsigned long timerId)
+{
+    return (false);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProBaseReactor::GetTimerCount() const
+{
+    return (0);
+}
+
+bool
+CProBaseReactor::PostCommand(IProFunctorCommand* command)
+{
+    assert(command != NULL);
+    if (command == NULL)
+    {
+        return (false);
+    }
+
+    PRO_REACTOR_TASK* const task = new PRO_REACTOR_TASK;
+    task->command = command;
+
+    if (!PushTask_i(task))
+    {
+        delete task;
+
+        return (false);
+    }
+
+    return (true);
+}
+
+bool
+CProBaseReactor::PostTask(IProOnTimer*  onTimer,
+                          unsigned long taskId,
+                          PRO_INT64     userData)
+{
+    assert(onTimer != NULL);
+    if (onTimer == NULL)
+    {
+        return (false);
+    }
+
+    PRO_REACTOR_TASK* const task = new PRO_REACTOR_TASK;
+    task->onTimer  = onTimer;
+    task->taskId   = taskId;
+    task->userData = userData;
+
+    onTimer->AddRef();
+
+    if (!PushTask_i(task))
+    {
+        onTimer->Release();
+        delete task;
+
+        return (false);
+    }
+
+    return (true);
+}
+
+void
+CProBaseReactor::RunCommands()
+{
+    PRO_REACTOR_TASK* task = PopTasks_i();
+
+    while (task != NULL)
+    {
+        PRO_REACTOR_TASK* const next = task->next;
+
+        if (task->command != NULL)
+        {
+            task->command->Execute();
+        }
+        else
+        {
+            task->onTimer->OnTimer(task->taskId, task->userData);
+        }
+
+        DestroyTask_i(task);
+        task = next;
+    }
+}
+
+bool
+CProBaseReactor::PushTask_i(PRO_REACTOR_TASK* task)
+{
+    /*
+     * the owner of the reactor stops the posting threads before it deletes
+     * the reactor, so a stale "m_wantExit" only lets a task in the queue,
+     * which the destructor cleans up
+     */
+    if (m_wantExit)
+    {
+        return (false);
+    }
+
+#if defined(WIN32) || defined(_WIN32_WCE)
+
+    PRO_REACTOR_TASK* head = NULL;
+
+    do
+    {
+        head       = m_tasks;
+        task->next = head;
+    }
+    while (::InterlockedCompareExchangePointer(
+        (void* volatile*)&m_tasks, task, head) != head);
+
+#elif defined(PRO_HAS_ATOMOP)
+
+    PRO_REACTOR_TASK* head = NULL;
+
+    do
+    {
+        head       = m_tasks;
+        task->next = head;
+    }
+    while (__sync_val_compare_and_swap(&m_tasks, head, task) != head);
+
+#else
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        task->next = m_tasks;
+        m_tasks    = task;
+    }
+
+#endif
+
+    m_notifyPipe->Notify();
+
+    return (true);
+}
+
+PRO_REACTOR_TASK*
+CProBaseReactor::PopTasks_i()
+{
+    if (m_tasks == NULL)
+    {
+        return (NULL);
+    }
+
+    /*
+     * the whole stack is taken at once, so there is no ABA problem
+     */
+#if defined(WIN32) || defined(_WIN32_WCE)
+    PRO_REACTOR_TASK* task = (PRO_REACTOR_TASK*)::InterlockedExchangePointer(
+        (void* volatile*)&m_tasks, NULL);
+#elif defined(PRO_HAS_ATOMOP)
+    PRO_REACTOR_TASK* task = __sync_lock_test_and_set(&m_tasks, (PRO_REACTOR_TASK*)NULL);
+#else
+    PRO_REACTOR_TASK* task = NULL;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        task    = m_tasks;
+        m_tasks = NULL;
+    }
+#endif
+
+    PRO_REACTOR_TASK* prev = NULL;
+
+    while (task != NULL)
+    {
+        PRO_REACTOR_TASK* const next = task->next;
+        task->next = prev;
+        prev       = task;
+        task       = next;
+    }
+
+    return (prev);
+}
+
+void
+CProBaseReactor::DestroyTask_i(PRO_REACTOR_TASK* task)
+{
+    if (task->command != NULL)
+    {
+        task->command->Destroy();
+    }
+    else
+    {
+        task->onTimer->Release();
+    }
+
+    delete task;
+}
+
+PRO_INT64
+CProBaseReactor::GetCpuTime() const
+{
+    PRO_INT64 cpuTime = -1;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_threadId != 0 && !m_wantExit)
+        {
+            cpuTime = ProGetThreadCpuTime(m_threadId);
+        }
+    }
+
+    return (cpuTime);
+}
+
+PRO_UINT64
+CProBaseReactor::SampleIoBytes()
+{
+    PRO_UINT64 ioBytes = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        const CProStlMap<PRO_INT64, PRO_HANDLER_INFO>& handlers = m_handlerMgr.GetAllHandlers();
+
+        CProStlMap<PRO_INT64, PRO_HANDLER_INFO>::const_iterator       itr = handlers.begin();
+        CProStlMap<PRO_INT64, PRO_HANDLER_INFO>::const_iterator const end = handlers.end();
+
+        for (; itr != end; ++itr)
+        {
+            ioBytes += itr->second.handler->SampleIoBytes();
+        }
+    }
+
+    return (ioBytes);
+}
+
+CProEventHandler*
+CProBaseReactor::FindHandlerByIoBytes(PRO_UINT64 ioBytes,
+                                      PRO_UINT64 maxIoBytes,
+                                      PRO_INT64& sockId) const
+{
+    CProEventHandler* handler = NULL;
+    PRO_UINT64        diff    = 0;
+
+    sockId = -1;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        const CProStlMap<PRO_INT64, PRO_HANDLER_INFO>& handlers = m_handlerMgr.GetAllHandlers();
+
+        CProStlMap<PRO_INT64, PRO_HANDLER_INFO>::const_iterator       itr = handlers.begin();
+        CProStlMap<PRO_INT64, PRO_HANDLER_INFO>::const_iterator const end = handlers.end();
+
+        for (; itr != end; ++itr)
+        {
+            CProEventHandler* const handler2 = itr->second.handler;
+            const PRO_UINT64        ioBytes2 = handler2->GetSampledIoBytes();
+            if (ioBytes2 == 0 || ioBytes2 >= maxIoBytes)
+            {
+                continue;
+            }
+
+            const PRO_UINT64 diff2 = ioBytes2 > ioBytes ? ioBytes2 - ioBytes : ioBytes - ioBytes2;
+            if (handler == NULL || diff2 < diff)
+            {
+                handler = handler2;
+                sockId  = itr->first;
+                diff    = diff2;
+            }
+        }
+
+        if (handler != NULL)
+        {
+            handler->AddRef();
+        }
+    }
+
+    return (handler);
+}
+
+void
+CProBaseReactor::SetBusyPoll(unsigned long busyPollUs)
+{
+    m_busyPollUs = busyPollUs;
+}
+
+void
+CProBaseReactor::GetBusyPollCounts(PRO_UINT64& spins,
+                                   PRO_UINT64& hits) const
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        spins = m_spinCount;
+        hits  = m_spinHitCount;
+    }
+}
+
+#if defined(PRO_HAS_MMSG)
+
+PRO_UDP_BATCH*
+CProBaseReactor::GetUdpBatch(size_t slotSize,
+                             size_t ctrlSize,
+                             size_t count)
+{
+    assert(slotSize > 0);
+    assert(count > 0);
+    if (slotSize == 0 || count == 0)
+    {
+        return (NULL);
+    }
+
+    PRO_UDP_BATCH& batch = m_udpBatch;
+
+    if (slotSize == batch.slotSize && ctrlSize == batch.ctrlSize &&
+        count <= batch.count)
+    {
+        return (&batch);
+    }
+
+    /*
+     * the buffers only grow, so the transports with different slots take
+     * turns without reallocation
+     */
+    if (slotSize * count > batch.buf.Size())
+    {
+        if (!batch.buf.Resize(slotSize * count))
+        {
+            batch.count = 0;
+
+            return (NULL);
+        }
+    }
+
+    if (ctrlSize > 0 && ctrlSize * count > batch.ctrlBuf.Size())
+    {
+        if (!batch.ctrlBuf.Resize(ctrlSize * count))
+        {
+            batch.count = 0;
+
+            return (NULL);
+        }
+    }
+
+    if (count > batch.msgs.size())
+    {
+        batch.msgs.resize(count);
+        batch.iovs.resize(count);
+        batch.addrs.resize(count);
+    }
+
+    char* const slots = (char*)batch.buf.Data();
+    char* const ctrls = (char*)batch.ctrlBuf.Data();
+
+    int       i = 0;
+    const int c = (int)count;
+
+    for (; i < c; ++i)
+    {
+        batch.iovs[i].iov_base = slots + slotSize * i;
+        batch.iovs[i].iov_len  = slotSize;
+
+        memset(&batch.msgs[i], 0, sizeof(pbsd_mmsghdr));
+        batch.msgs[i].msg_hdr.msg_name    = &batch.addrs[i];
+        batch.msgs[i].msg_hdr.msg_iov     = &batch.iovs[i];
+        batch.msgs[i].msg_hdr.msg_iovlen  = 1;
+        batch.msgs[i].msg_hdr.msg_control = ctrlSize > 0 ? ctrls + ctrlSize * i : NULL;
+    }
+
+    batch.slotSize = slotSize;
+    batch.ctrlSize = ctrlSize;
+    batch.count    = count;
+
+    return (&batch);
+}
+
+#endif /* PRO_HAS_MMSG */
+
+bool
+CProBaseReactor::WantBusyPoll() const
+{
+    if (m_busyPollUs == 0 || m_lastEventTick == 0)
+    {
+        return (false);
+    }
+
+    return (ProGetMicroTickCount64() - m_lastEventTick < (PRO_INT64)m_busyPollUs);
+}
+
+bool
+CProBaseReactor::CountBusyPoll(bool spinning,
+                               bool useful)
+{
+    if (m_busyPollUs == 0)
+    {
+        return (false);
+    }
+
+    if (spinning)
+    {
+        ++m_spinCount;
+        if (useful)
+        {
+            ++m_spinHitCount;
+        }
+    }
+
+    /*
+     * the window restarts at each useful round, so an idle reactor falls
+     * asleep after "m_busyPollUs"
+     */
+    if (useful)
+    {
+        m_lastEventTick = ProGetMicroTickCount64();
+    }
+
+    return (spinning && !useful);
+}
+
+void
+CProBaseReactor::ReplaceNotifyPipe(CProNotifyPipe* newPipe)
+{
+    assert(newPipe != NULL);
+    if (newPipe == NULL || newPipe == m_notifyPipe)
+    {
+        return;
+    }
+
+    if (m_notifyPipe != NULL)
+    {
+        m_retiredPipes.push_back(m_notifyPipe);
+    }
+
+    m_notifyPipe = newPipe;
+}
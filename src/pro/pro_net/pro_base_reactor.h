@@ -21,13 +21,70 @@
 
 #include "pro_event_handler.h"
 #include "pro_handler_mgr.h"
+#include "pro_net.h"
 #include "../pro_util/pro_bsd_wrapper.h"
+#include "../pro_util/pro_buffer.h"
+#include "../pro_util/pro_stl.h"
 #include "../pro_util/pro_thread_mutex.h"
 
 /////////////////////////////////////////////////////////////////////////////
 ////
 
 class CProNotifyPipe;
+class IProFunctorCommand;
+class IProOnTimer;
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+/*
+ * a command or a task, linked into the lock-free stack of the reactor
+ */
+struct PRO_REACTOR_TASK
+{
+    PRO_REACTOR_TASK()
+    {
+        command  = NULL;
+        onTimer  = NULL;
+        taskId   = 0;
+        userData = 0;
+        next     = NULL;
+    }
+
+    IProFunctorCommand* command;
+    IProOnTimer*        onTimer;
+    unsigned long       taskId;
+    PRO_INT64           userData;
+    PRO_REACTOR_TASK*   next;
+};
+
+#if defined(PRO_HAS_MMSG)
+
+/*
+ * the recvmmsg() slots of a reactor. they are used only in the reactor
+ * thread, so all the udp transports of the reactor share one set
+ */
+struct PRO_UDP_BATCH
+{
+    PRO_UDP_BATCH()
+    {
+        slotSize = 0;
+        ctrlSize = 0;
+        count    = 0;
+    }
+
+    size_t                          slotSize;
+    size_t                          ctrlSize;
+    size_t                          count;
+    CProBuffer                      buf;
+    CProBuffer                      ctrlBuf;
+    CProStlVector<pbsd_mmsghdr>     msgs;
+    CProStlVector<pbsd_iovec>       iovs;
+    CProStlVector<pbsd_sockaddr_in> addrs;
+    CProStlVector<PRO_DATAGRAM>     datagrams; /* for the batch upcall */
+};
+
+#endif /* PRO_HAS_MMSG */
 
 /////////////////////////////////////////////////////////////////////////////
 ////
@@ -38,9 +95,7 @@ public:
 
     CProBaseReactor();
 
-    virtual ~CProBaseReactor()
-    {
-    }
+    virtual ~CProBaseReactor();
 
     virtual bool PRO_CALLTYPE Init() = 0;
 
@@ -59,10 +114,170 @@ public:
 
     virtual unsigned long PRO_CALLTYPE GetHandlerCount() const;
 
+    /*
+     * the wakeups written by the other threads, and the ones coalesced into
+     * a pending wakeup
+     */
+    virtual void PRO_CALLTYPE GetWakeupCounts(
+        PRO_UINT64& wakeups,
+        PRO_UINT64& coalesced
+        ) const;
+
+    /*
+     * queues an upcall of the registered handler as if its descriptor were
+     * ready. it's used by the edge-triggered handlers.
+     * returns false if the reactor doesn't support that
+     */
+    virtual bool PRO_CALLTYPE RaiseEvent(
+        PRO_INT64         sockId,
+        CProEventHandler* handler,
+        unsigned long     mask
+        );
+
+    /*
+     * drops the queued upcalls raised for a descriptor, and returns their
+     * mask. it's used when a handler is moved to another reactor
+     */
+    virtual unsigned long PRO_CALLTYPE DropRaisedEvents(PRO_INT64 sockId);
+
+    /*
+     * the timers of the reactor run in its own thread.
+     * returns false if the reactor doesn't support that
+     */
+    virtual bool PRO_CALLTYPE InitTimers(bool timingWheel);
+
+    virtual unsigned long PRO_CALLTYPE ScheduleTimer(
+        IProOnTimer* onTimer,
+        PRO_UINT64   timeSpan,
+        bool         recurring,
+        PRO_INT64    userData
+        );
+
+    virtual unsigned long PRO_CALLTYPE ScheduleHeartbeatTimer(
+        IProOnTimer* onTimer,
+        PRO_INT64    userData
+        );
+
+    virtual unsigned long PRO_CALLTYPE JoinHeartbeatGroup(
+        PRO_HEARTBEAT_ENTRY* entry,
+        IProOnTimer*         onTimer,
+        PRO_INT64            userData
+        );
+
+    virtual bool PRO_CALLTYPE LeaveHeartbeatGroup(
+        PRO_HEARTBEAT_ENTRY* entry,
+        unsigned long        timerId
+        );
+
+    virtual bool PRO_CALLTYPE UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds);
+
+    virtual bool PRO_CALLTYPE CancelTimer(unsigned long timerId);
+
+    virtual unsigned long PRO_CALLTYPE GetTimerCount() const;
+
     virtual void PRO_CALLTYPE WorkerRun() = 0;
 
+    /*
+     * queues a command that runs in the reactor thread after a round of the
+     * upcalls, so no upcall of the reactor is in progress at that time.
+     * the posting threads don't take any lock.
+     * returns false if the reactor is exiting
+     */
+    bool PostCommand(IProFunctorCommand* command);
+
+    /*
+     * the same as PostCommand(...), but it calls onTimer->OnTimer(taskId,
+     * userData) once. "onTimer" is held with a reference until then
+     */
+    bool PostTask(
+        IProOnTimer*  onTimer,
+        unsigned long taskId,
+        PRO_INT64     userData
+        );
+
+    /*
+     * the cpu time of the reactor thread in microseconds, or -1
+     */
+    PRO_INT64 GetCpuTime() const;
+
+    /*
+     * samples the handlers, and returns the sum of their bytes since the
+     * last sample. please refer to CProEventHandler::SampleIoBytes()
+     */
+    PRO_UINT64 SampleIoBytes();
+
+    /*
+     * finds the handler whose sampled bytes are the nearest to "ioBytes",
+     * and less than "maxIoBytes". the handler is returned with a reference
+     */
+    CProEventHandler* FindHandlerByIoBytes(
+        PRO_UINT64 ioBytes,
+        PRO_UINT64 maxIoBytes,
+        PRO_INT64& sockId
+        ) const;
+
+    /*
+     * after a useful round, the reactor polls without blocking for
+     * "busyPollUs" microseconds before it goes to sleep. 0 means off.
+     * it must be set before the reactor thread runs
+     */
+    void SetBusyPoll(unsigned long busyPollUs);
+
+    /*
+     * the rounds polled without blocking, and the ones of them that found
+     * something to do
+     */
+    void GetBusyPollCounts(
+        PRO_UINT64& spins,
+        PRO_UINT64& hits
+        ) const;
+
+#if defined(PRO_HAS_MMSG)
+
+    /*
+     * returns the shared slots laid out as "count" slots of "slotSize"
+     * bytes, with "ctrlSize" bytes of cmsgs each if it's not 0.
+     * in the reactor thread only. returns NULL if out of memory
+     */
+    PRO_UDP_BATCH* GetUdpBatch(
+        size_t slotSize,
+        size_t ctrlSize,
+        size_t count
+        );
+
+#endif
+
 protected:
 
+    /*
+     * the reactor calls it in the loop, and once more after the loop.
+     * it runs the commands and the tasks in the posted order
+     */
+    void RunCommands();
+
+    /*
+     * returns true if the reactor should poll instead of sleeping
+     */
+    bool WantBusyPoll() const;
+
+    /*
+     * the reactor calls it after each round with m_lock held.
+     * returns true if it was an empty spin, after which the reactor yields
+     * the cpu to the other runnable threads
+     */
+    bool CountBusyPoll(
+        bool spinning,
+        bool useful
+        );
+
+    /*
+     * the reactor calls it with m_lock held, after the old pipe is broken.
+     * the old pipe isn't deleted until the reactor is deleted, because the
+     * posting threads use "m_notifyPipe" without the lock.
+     * a retired pipe is never waited on again, so its Notify() never writes
+     */
+    void ReplaceNotifyPipe(CProNotifyPipe* newPipe);
+
     virtual unsigned long PRO_CALLTYPE AddRef()
     {
         return (1);
@@ -80,6 +295,26 @@ protected:
     CProHandlerMgr          m_handlerMgr;
     CProNotifyPipe*         m_notifyPipe;
     mutable CProThreadMutex m_lock;
+
+private:
+
+    bool PushTask_i(PRO_REACTOR_TASK* task);
+
+    PRO_REACTOR_TASK* PopTasks_i(); /* in the posted order */
+
+    static void DestroyTask_i(PRO_REACTOR_TASK* task);
+
+private:
+
+    PRO_REACTOR_TASK* volatile     m_tasks; /* the newest first */
+    CProStlVector<CProNotifyPipe*> m_retiredPipes;
+#if defined(PRO_HAS_MMSG)
+    PRO_UDP_BATCH                  m_udpBatch;
+#endif
+    unsigned long                  m_busyPollUs;
+    PRO_INT64                      m_lastEventTick;
+    PRO_UINT64                     m_spinCount;
+    PRO_UINT64                     m_spinHitCount;
 };
 
 /////////////////////////////////////////////////////////////////////////////
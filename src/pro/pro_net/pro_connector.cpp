@@ -159,8 +159,8 @@ CProConnector::Init(IProConnectorObserver* observer,
         m_localAddr        = localAddr;
         m_remoteAddr       = remoteAddr;
         m_timeoutInSeconds = timeoutInSeconds;
-        m_timerId0         = reactorTask->ScheduleTimer(this, 0, false, 0);
-        m_timerId1         = reactorTask->ScheduleTimer(this, (PRO_UINT64)timeoutInSeconds * 1000, false, 0);
+        m_timerId0         = reactorTask->ScheduleHandlerTimer(this, 0, false, 0);
+        m_timerId1         = reactorTask->ScheduleHandlerTimer(this, (PRO_UINT64)timeoutInSeconds * 1000, false, 0);
     }
 
     return (true);
@@ -180,8 +180,8 @@ CProConnector::Fini()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId0);
-        m_reactorTask->CancelTimer(m_timerId1);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId0);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId1);
         m_timerId0 = 0;
         m_timerId1 = 0;
 
@@ -287,8 +287,8 @@ CProConnector::OnOutput(PRO_INT64 sockId)
 
 EXIT:
 
-        m_reactorTask->CancelTimer(m_timerId0);
-        m_reactorTask->CancelTimer(m_timerId1);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId0);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId1);
         m_timerId0 = 0;
         m_timerId1 = 0;
 
@@ -361,8 +361,8 @@ CProConnector::OnError(PRO_INT64 sockId,
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId0);
-        m_reactorTask->CancelTimer(m_timerId1);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId0);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId1);
         m_timerId0 = 0;
         m_timerId1 = 0;
 
@@ -429,8 +429,8 @@ CProConnector::OnHandshakeOk(IProTcpHandshaker* handshaker,
             sockId = -1;
         }
 
-        m_reactorTask->CancelTimer(m_timerId0);
-        m_reactorTask->CancelTimer(m_timerId1);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId0);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId1);
         m_timerId0 = 0;
         m_timerId1 = 0;
 
@@ -502,8 +502,8 @@ CProConnector::OnHandshakeError(IProTcpHandshaker* handshaker,
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId0);
-        m_reactorTask->CancelTimer(m_timerId1);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId0);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId1);
         m_timerId0 = 0;
         m_timerId1 = 0;
 
@@ -639,8 +639,8 @@ CProConnector::OnTimer(unsigned long timerId,
         }
         while (0);
 
-        m_reactorTask->CancelTimer(m_timerId0);
-        m_reactorTask->CancelTimer(m_timerId1);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId0);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId1);
         m_timerId0 = 0;
         m_timerId1 = 0;
 
@@ -22,11 +22,18 @@
 #include "../pro_util/pro_bsd_wrapper.h"
 #include "../pro_util/pro_thread.h"
 #include "../pro_util/pro_time_util.h"
+#include "../pro_util/pro_timer_factory.h"
 #include "../pro_util/pro_z.h"
 #include <cassert>
 
 #if defined(PRO_HAS_EPOLL)
 
+#include <sched.h>
+
+#if !defined(PRO_LACKS_TIMERFD)
+#include <sys/timerfd.h>
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -49,20 +56,51 @@
 #define PRO_EPOLLHUP     EPOLLHUP
 #define PRO_EPOLLERR     EPOLLERR
 
-static char g_s_buffer[1024];
+/////////////////////////////////////////////////////////////////////////////
+////
+
+/*
+ * epoll_event.data carries the descriptor and the registration generation,
+ * so a stale event of a reused descriptor can be recognized
+ */
+static inline
+PRO_UINT64
+MakeEventTag_i(PRO_INT64     sockId,
+               unsigned long generation)
+{
+    return (((PRO_UINT64)(generation & 0xFFFFFFFF) << 32) | (PRO_UINT32)sockId);
+}
 
 /////////////////////////////////////////////////////////////////////////////
 ////
 
 CProEpollReactor::CProEpollReactor()
 {
-    m_epfd = -1;
+    m_epfd         = -1;
+    m_timerfd      = -1;
+    m_armedTick    = -1;
+    m_raisedBySelf = false;
+
+    m_raised.reserve(PRO_EPOLLFD_GETSIZE);
+    m_raised2.reserve(PRO_EPOLLFD_GETSIZE);
 }
 
 CProEpollReactor::~CProEpollReactor()
 {
     Fini();
 
+    m_timerFactory.Stop();
+
+    if (m_timerfd != -1)
+    {
+        pbsd_epoll_event ev;
+        memset(&ev, 0, sizeof(pbsd_epoll_event));
+        pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, m_timerfd, &ev);
+
+        close(m_timerfd);
+        m_timerfd = -1;
+    }
+
     if (m_epfd != -1)
     {
         pbsd_epoll_event ev;
@@ -76,14 +114,23 @@ CProEpollReactor::~CProEpollReactor()
 
         for (; itr != end; ++itr)
         {
-            ev.data.fd = (int)itr->first;
-            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, ev.data.fd, &ev);
+            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, (int)itr->first, &ev);
         }
 
         close(m_epfd);
         m_epfd = -1;
     }
 
+    int       i = 0;
+    const int c = (int)m_raised.size();
+
+    for (; i < c; ++i)
+    {
+        m_raised[i].handler->Release();
+    }
+
+    m_raised.clear();
+
     delete m_notifyPipe;
     m_notifyPipe = NULL;
 }
@@ -118,12 +165,7 @@ CProEpollReactor::Init()
             return (false);
         }
 
-        pbsd_epoll_event ev;
-        memset(&ev, 0, sizeof(pbsd_epoll_event));
-        ev.events  = PRO_EPOLLIN_SET;
-        ev.data.fd = (int)sockId;
-
-        if (pbsd_epoll_ctl(m_epfd, EPOLL_CTL_ADD, ev.data.fd, &ev) != 0)
+        if (!m_handlerMgr.AddHandler(sockId, this, PRO_MASK_READ))
         {
             close(m_epfd);
             m_epfd = -1;
@@ -131,9 +173,14 @@ CProEpollReactor::Init()
             return (false);
         }
 
-        if (!m_handlerMgr.AddHandler(sockId, this, PRO_MASK_READ))
+        pbsd_epoll_event ev;
+        memset(&ev, 0, sizeof(pbsd_epoll_event));
+        ev.events   = PRO_EPOLLIN_SET;
+        ev.data.u64 = MakeEventTag_i(sockId, m_handlerMgr.FindHandler(sockId).generation);
+
+        if (pbsd_epoll_ctl(m_epfd, EPOLL_CTL_ADD, (int)sockId, &ev) != 0)
         {
-            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, ev.data.fd, &ev);
+            m_handlerMgr.RemoveHandler(sockId, PRO_MASK_READ);
             close(m_epfd);
             m_epfd = -1;
 
@@ -237,39 +284,37 @@ CProEpollReactor::AddHandler(PRO_INT64         sockId,
             events |= PRO_EPOLLEX_SET;
         }
 
+        if (!m_handlerMgr.AddHandler(sockId, handler, mask))
+        {
+            return (false);
+        }
+
+        const PRO_HANDLER_INFO newInfo = m_handlerMgr.FindHandler(sockId);
+
         pbsd_epoll_event ev;
         memset(&ev, 0, sizeof(pbsd_epoll_event));
-        ev.events  = events;
-        ev.data.fd = (int)sockId;
+        ev.events   = (unsigned short)events;
+        ev.data.u64 = MakeEventTag_i(sockId, newInfo.generation);
+        if (handler->IsEdgeTriggered())
+        {
+            ev.events |= EPOLLET;
+        }
 
         int retc = -1;
         if (oldEvents == 0)
         {
-            retc = pbsd_epoll_ctl(m_epfd, EPOLL_CTL_ADD, ev.data.fd, &ev);
+            retc = pbsd_epoll_ctl(m_epfd, EPOLL_CTL_ADD, (int)sockId, &ev);
         }
         else
         {
-            retc = pbsd_epoll_ctl(m_epfd, EPOLL_CTL_MOD, ev.data.fd, &ev);
+            retc = pbsd_epoll_ctl(m_epfd, EPOLL_CTL_MOD, (int)sockId, &ev);
         }
         if (retc != 0)
-        {
-            return (false);
-        }
-
-        if (!m_handlerMgr.AddHandler(sockId, handler, mask))
         {
             /*
              * rollback
              */
-            if (oldEvents == 0)
-            {
-                pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, ev.data.fd, &ev);
-            }
-            else
-            {
-                ev.events = oldEvents;
-                pbsd_epoll_ctl(m_epfd, EPOLL_CTL_MOD, ev.data.fd, &ev);
-            }
+            m_handlerMgr.RemoveHandler(sockId, mask);
 
             return (false);
         }
@@ -357,16 +402,20 @@ CProEpollReactor::RemoveHandler(PRO_INT64     sockId,
 
         pbsd_epoll_event ev;
         memset(&ev, 0, sizeof(pbsd_epoll_event));
-        ev.events  = events;
-        ev.data.fd = (int)sockId;
+        ev.events   = (unsigned short)events;
+        ev.data.u64 = MakeEventTag_i(sockId, oldInfo.generation);
+        if (oldInfo.handler->IsEdgeTriggered())
+        {
+            ev.events |= EPOLLET;
+        }
 
         if (events == 0)
         {
-            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, ev.data.fd, &ev);
+            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, (int)sockId, &ev);
         }
         else
         {
-            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_MOD, ev.data.fd, &ev);
+            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_MOD, (int)sockId, &ev);
         }
 
         m_handlerMgr.RemoveHandler(sockId, mask);
@@ -378,38 +427,330 @@ CProEpollReactor::RemoveHandler(PRO_INT64     sockId,
     }
 }
 
-void
+bool
 PRO_CALLTYPE
-CProEpollReactor::WorkerRun()
+CProEpollReactor::RaiseEvent(PRO_INT64         sockId,
+                             CProEventHandler* handler,
+                             unsigned long     mask)
 {
+    mask &= (PRO_MASK_WRITE | PRO_MASK_READ);
+
+    assert(sockId != -1);
+    assert(handler != NULL);
+    assert(mask != 0);
+    if (sockId == -1 || handler == NULL || mask == 0)
+    {
+        return (false);
+    }
+
     {
         CProThreadMutexGuard mon(m_lock);
 
-        m_threadId = ProGetThreadId();
+        if (m_epfd == -1 || m_wantExit)
+        {
+            return (false);
+        }
+
+        const PRO_HANDLER_INFO* const info = m_handlerMgr.FindHandlerFast(sockId);
+        if (info == NULL || info->handler != handler)
+        {
+            return (false);
+        }
+
+        mask &= info->mask; /* for example, the reading is suspended */
+        if (mask == 0)
+        {
+            return (true);
+        }
+
+        PRO_EPOLL_READY_INFO raised;
+        raised.handler = handler;
+        raised.sockId  = sockId;
+        raised.mask    = mask;
+
+        raised.handler->AddRef();
+        m_raised.push_back(raised);
+
+        /*
+         * the reactor thread polls without blocking next time
+         */
+        if (ProGetThreadId() == m_threadId)
+        {
+            m_raisedBySelf = true;
+        }
+        else
+        {
+            m_notifyPipe->Notify();
+        }
     }
 
-    while (1)
+    return (true);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProEpollReactor::DropRaisedEvents(PRO_INT64 sockId)
+{
+    unsigned long mask = 0;
+
     {
-        {
-            CProThreadMutexGuard mon(m_lock);
+        CProThreadMutexGuard mon(m_lock);
 
-            if (m_epfd == -1 || m_wantExit)
+        CProStlVector<PRO_EPOLL_READY_INFO>::iterator itr = m_raised.begin();
+
+        while (itr != m_raised.end())
+        {
+            if (itr->sockId != sockId)
             {
-                break;
+                ++itr;
+                continue;
             }
+
+            PRO_SET_BITS(mask, itr->mask);
+            itr->handler->Release();
+            itr = m_raised.erase(itr);
+        }
+    }
+
+    return (mask);
+}
+
+bool
+PRO_CALLTYPE
+CProEpollReactor::InitTimers(bool timingWheel)
+{
+#if defined(PRO_LACKS_TIMERFD)
+    return (false);
+#else
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_epfd == -1 || m_timerfd != -1 || m_wantExit)
+        {
+            return (false);
+        }
+
+        m_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (m_timerfd == -1)
+        {
+            return (false);
+        }
+
+        pbsd_epoll_event ev;
+        memset(&ev, 0, sizeof(pbsd_epoll_event));
+        ev.events   = PRO_EPOLLIN_SET;
+        ev.data.u64 = MakeEventTag_i(m_timerfd, 0); /* no generation */
+
+        if (pbsd_epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_timerfd, &ev) != 0)
+        {
+            close(m_timerfd);
+            m_timerfd = -1;
+
+            return (false);
+        }
+
+        if (!m_timerFactory.Start(false, timingWheel, false)) /* no worker thread */
+        {
+            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, m_timerfd, &ev);
+            close(m_timerfd);
+            m_timerfd = -1;
+
+            return (false);
+        }
+    }
+
+    return (true);
+#endif
+}
+
+unsigned long
+PRO_CALLTYPE
+CProEpollReactor::ScheduleTimer(IProOnTimer* onTimer,
+                                PRO_UINT64   timeSpan,
+                                bool         recurring,
+                                PRO_INT64    userData)
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_epfd == -1 || m_timerfd == -1 || m_wantExit)
+        {
+            return (0);
+        }
+
+        timerId = m_timerFactory.ScheduleTimer(onTimer, timeSpan, recurring, userData);
+        if (timerId != 0)
+        {
+            SetTimer_i();
+        }
+    }
+
+    return (timerId);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProEpollReactor::ScheduleHeartbeatTimer(IProOnTimer* onTimer,
+                                         PRO_INT64    userData)
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_epfd == -1 || m_timerfd == -1 || m_wantExit)
+        {
+            return (0);
+        }
+
+        timerId = m_timerFactory.ScheduleHeartbeatTimer(onTimer, userData);
+        if (timerId != 0)
+        {
+            SetTimer_i();
+        }
+    }
+
+    return (timerId);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProEpollReactor::JoinHeartbeatGroup(PRO_HEARTBEAT_ENTRY* entry,
+                                     IProOnTimer*         onTimer,
+                                     PRO_INT64            userData)
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_epfd == -1 || m_timerfd == -1 || m_wantExit)
+        {
+            return (0);
+        }
+
+        timerId = m_timerFactory.JoinHeartbeatGroup(entry, onTimer, userData);
+        if (timerId != 0)
+        {
+            SetTimer_i();
+        }
+    }
+
+    return (timerId);
+}
+
+bool
+PRO_CALLTYPE
+CProEpollReactor::LeaveHeartbeatGroup(PRO_HEARTBEAT_ENTRY* entry,
+                                      unsigned long        timerId)
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_epfd == -1 || m_timerfd == -1)
+        {
+            return (false);
+        }
+    }
+
+    return (m_timerFactory.LeaveHeartbeatGroup(entry, timerId));
+}
+
+bool
+PRO_CALLTYPE
+CProEpollReactor::UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds)
+{
+    bool ret = false;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_epfd == -1 || m_timerfd == -1 || m_wantExit)
+        {
+            return (false);
+        }
+
+        ret = m_timerFactory.UpdateHeartbeatTimers(htbtIntervalInSeconds);
+        if (ret)
+        {
+            SetTimer_i();
+        }
+    }
+
+    return (ret);
+}
+
+bool
+PRO_CALLTYPE
+CProEpollReactor::CancelTimer(unsigned long timerId)
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_epfd == -1 || m_timerfd == -1)
+        {
+            return (false);
         }
+    }
+
+    /*
+     * the timer may release the last reference of the handler.
+     * a stale armed timerfd only causes a spurious wakeup
+     */
+    return (m_timerFactory.CancelTimer(timerId));
+}
+
+unsigned long
+PRO_CALLTYPE
+CProEpollReactor::GetTimerCount() const
+{
+    return (m_timerFactory.GetTimerCount());
+}
+
+void
+PRO_CALLTYPE
+CProEpollReactor::WorkerRun()
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        m_threadId = ProGetThreadId();
+    }
+
+    /*
+     * one lock per wakeup. the handlers are looked up in the dense table and
+     * collected into the preallocated ready array, so there is no heap
+     * allocation on the dispatch path
+     */
+    while (1)
+    {
+        RunCommands();
 
         /*
          * epoll_wait(...)
          */
-        const int retc = pbsd_epoll_wait(m_epfd, m_events, PRO_EPOLLFD_GETSIZE, -1);
-        if (retc <= 0)
+        int timeout = m_raisedBySelf ? 0 : -1;
+        m_raisedBySelf = false;
+
+        bool spinning = false;
+        if (timeout != 0 && WantBusyPoll())
         {
-            ProSleep(1);
-            continue;
+            timeout  = 0;
+            spinning = true;
         }
 
-        CProStlMap<PRO_INT64, PRO_HANDLER_INFO> handlers;
+        if (timeout != 0 && !m_notifyPipe->BeginWait())
+        {
+            timeout = 0;
+        }
+
+        const int retc = pbsd_epoll_wait(m_epfd, m_events, PRO_EPOLLFD_GETSIZE, timeout);
+        m_notifyPipe->EndWait();
+
+        int  readyCount = 0;
+        bool timerReady = false;
 
         {
             CProThreadMutexGuard mon(m_lock);
@@ -419,6 +760,8 @@ CProEpollReactor::WorkerRun()
                 break;
             }
 
+            m_raised2.swap(m_raised);
+
             for (int i = 0; i < retc; ++i)
             {
                 const pbsd_epoll_event& ev = m_events[i];
@@ -427,81 +770,203 @@ CProEpollReactor::WorkerRun()
                     continue;
                 }
 
-                const PRO_HANDLER_INFO info = m_handlerMgr.FindHandler(ev.data.fd);
-                if (info.handler == NULL)
+                if (m_timerfd != -1 && ev.data.u64 == MakeEventTag_i(m_timerfd, 0))
                 {
+                    timerReady = true;
                     continue;
                 }
 
-                if ((ev.events & PRO_EPOLLERR) != 0)
+                const PRO_INT64               sockId = (int)(PRO_UINT32)ev.data.u64;
+                const PRO_HANDLER_INFO* const info   = m_handlerMgr.FindHandlerFast(sockId);
+                if (info == NULL || info->generation != (unsigned long)(ev.data.u64 >> 32))
                 {
-                    info.handler->AddRef();
-                    PRO_HANDLER_INFO& info2 = handlers[ev.data.fd]; /* insert */
-                    info2.handler = info.handler;
-                    PRO_SET_BITS(info2.mask, PRO_MASK_ERROR);
-                    continue;
+                    continue; /* stale */
                 }
 
-                if ((ev.events & PRO_EPOLLOUT_SET) != 0)
+                unsigned long mask = 0;
+
+                if ((ev.events & PRO_EPOLLERR) != 0)
                 {
-                    info.handler->AddRef();
-                    PRO_HANDLER_INFO& info2 = handlers[ev.data.fd]; /* insert */
-                    info2.handler = info.handler;
-                    PRO_SET_BITS(info2.mask, PRO_MASK_WRITE);
+                    PRO_SET_BITS(mask, PRO_MASK_ERROR);
                 }
-
-                if ((ev.events & (PRO_EPOLLIN_SET | PRO_EPOLLHUP)) != 0)
+                else
                 {
-                    info.handler->AddRef();
-                    PRO_HANDLER_INFO& info2 = handlers[ev.data.fd]; /* insert */
-                    info2.handler = info.handler;
-                    PRO_SET_BITS(info2.mask, PRO_MASK_READ);
+                    if ((ev.events & PRO_EPOLLOUT_SET) != 0)
+                    {
+                        PRO_SET_BITS(mask, PRO_MASK_WRITE);
+                    }
+                    if ((ev.events & (PRO_EPOLLIN_SET | PRO_EPOLLHUP)) != 0)
+                    {
+                        PRO_SET_BITS(mask, PRO_MASK_READ);
+                    }
+                    if ((ev.events & PRO_EPOLLEX_SET) != 0)
+                    {
+                        PRO_SET_BITS(mask, PRO_MASK_EXCEPTION);
+                    }
                 }
 
-                if ((ev.events & PRO_EPOLLEX_SET) != 0)
+                if (mask == 0)
                 {
-                    info.handler->AddRef();
-                    PRO_HANDLER_INFO& info2 = handlers[ev.data.fd]; /* insert */
-                    info2.handler = info.handler;
-                    PRO_SET_BITS(info2.mask, PRO_MASK_EXCEPTION);
+                    continue;
                 }
+
+                PRO_EPOLL_READY_INFO& ready = m_ready[readyCount];
+                ++readyCount;
+
+                ready.handler = info->handler;
+                ready.sockId  = sockId;
+                ready.mask    = mask;
+                ready.handler->AddRef();
             } /* end of for (...) */
+
+            spinning = CountBusyPoll(spinning, readyCount > 0 || timerReady || m_raised2.size() > 0);
         }
 
-        CProStlMap<PRO_INT64, PRO_HANDLER_INFO>::const_iterator       itr = handlers.begin();
-        CProStlMap<PRO_INT64, PRO_HANDLER_INFO>::const_iterator const end = handlers.end();
+        if (retc < 0 || (retc == 0 && timeout != 0))
+        {
+            ProSleep(1);
+        }
+        else if (spinning)
+        {
+            sched_yield(); /* usleep(0) would oversleep by the timer slack */
+        }
 
-        for (; itr != end; ++itr)
+        for (int j = 0; j < readyCount; ++j)
         {
-            const PRO_INT64         sockId = itr->first;
-            const PRO_HANDLER_INFO& info   = itr->second;
+            const PRO_EPOLL_READY_INFO& ready = m_ready[j];
 
-            if (PRO_BIT_ENABLED(info.mask, PRO_MASK_ERROR))
+            if (PRO_BIT_ENABLED(ready.mask, PRO_MASK_ERROR))
             {
-                info.handler->OnError(sockId, -1);
-                info.handler->Release();
+                ready.handler->OnError(ready.sockId, -1);
+                ready.handler->Release();
                 continue;
             }
 
-            if (PRO_BIT_ENABLED(info.mask, PRO_MASK_WRITE))
+            if (PRO_BIT_ENABLED(ready.mask, PRO_MASK_WRITE))
+            {
+                ready.handler->OnOutput(ready.sockId);
+            }
+
+            if (PRO_BIT_ENABLED(ready.mask, PRO_MASK_READ))
             {
-                info.handler->OnOutput(sockId);
-                info.handler->Release();
+                ready.handler->OnInput(ready.sockId);
             }
 
-            if (PRO_BIT_ENABLED(info.mask, PRO_MASK_READ))
+            if (PRO_BIT_ENABLED(ready.mask, PRO_MASK_EXCEPTION))
             {
-                info.handler->OnInput(sockId);
-                info.handler->Release();
+                ready.handler->OnException(ready.sockId);
             }
 
-            if (PRO_BIT_ENABLED(info.mask, PRO_MASK_EXCEPTION))
+            ready.handler->Release();
+        }
+
+        int       k = 0;
+        const int c = (int)m_raised2.size();
+
+        for (; k < c; ++k)
+        {
+            const PRO_EPOLL_READY_INFO& raised = m_raised2[k];
+
+            if (PRO_BIT_ENABLED(raised.mask, PRO_MASK_WRITE))
             {
-                info.handler->OnException(sockId);
-                info.handler->Release();
+                raised.handler->OnOutput(raised.sockId);
             }
+
+            if (PRO_BIT_ENABLED(raised.mask, PRO_MASK_READ))
+            {
+                raised.handler->OnInput(raised.sockId);
+            }
+
+            raised.handler->Release();
+        }
+
+        m_raised2.clear();
+
+        if (timerReady)
+        {
+            PollTimers();
         }
     } /* end of while (...) */
+
+    RunCommands(); /* the rest */
+}
+
+void
+CProEpollReactor::SetTimer_i()
+{
+#if !defined(PRO_LACKS_TIMERFD)
+    const PRO_INT64 nextTick = m_timerFactory.GetNextExpireTick();
+    if (nextTick < 0 || (m_armedTick >= 0 && nextTick >= m_armedTick))
+    {
+        return;
+    }
+
+    const PRO_INT64 delta = nextTick - ProGetTickCount64();
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(struct itimerspec));
+    if (delta > 0)
+    {
+        its.it_value.tv_sec  = (time_t)(delta / 1000);
+        its.it_value.tv_nsec = (long)(delta % 1000) * 1000000;
+    }
+    else
+    {
+        its.it_value.tv_nsec = 1; /* as soon as possible */
+    }
+
+    if (timerfd_settime(m_timerfd, 0, &its, NULL) == 0)
+    {
+        m_armedTick = nextTick;
+    }
+#endif
+}
+
+void
+CProEpollReactor::PollTimers()
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_timerfd == -1)
+        {
+            return;
+        }
+
+        PRO_UINT64 expirations = 0;
+        int        retc        = -1;
+
+        do
+        {
+            retc = (int)read(m_timerfd, &expirations, sizeof(PRO_UINT64));
+        }
+        while (retc < 0 && errno == EINTR);
+
+        /*
+         * the timer was re-armed after it became readable, and nothing has
+         * expired. an unexpected error or short read falls through, so the
+         * timers won't stall
+         */
+        if (retc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+
+        m_armedTick = -1;
+    }
+
+    m_timerFactory.Poll();
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_timerfd == -1 || m_wantExit)
+        {
+            return;
+        }
+
+        SetTimer_i();
+    }
 }
 
 void
@@ -514,14 +979,12 @@ CProEpollReactor::OnInput(PRO_INT64 sockId)
         return;
     }
 
-    const int recvSize = pbsd_recv(sockId, g_s_buffer, sizeof(g_s_buffer), 0); /* connected */
-    if (recvSize > 0 && recvSize <= (int)sizeof(g_s_buffer)
-        ||
-        recvSize < 0 && pbsd_errno((void*)&pbsd_recv) == PBSD_EWOULDBLOCK)
+    if (sockId != m_notifyPipe->GetReaderSockId())
     {
-        m_notifyPipe->EnableNotify();
+        return;
     }
-    else
+
+    if (!m_notifyPipe->Drain())
     {
         OnError(sockId, -1);
     }
@@ -557,21 +1020,22 @@ CProEpollReactor::OnError(PRO_INT64 sockId,
             return;
         }
 
-        pbsd_epoll_event ev;
-        memset(&ev, 0, sizeof(pbsd_epoll_event));
-        ev.events  = PRO_EPOLLIN_SET;
-        ev.data.fd = (int)newSockId;
-
-        if (pbsd_epoll_ctl(m_epfd, EPOLL_CTL_ADD, ev.data.fd, &ev) != 0)
+        if (!m_handlerMgr.AddHandler(newSockId, this, PRO_MASK_READ))
         {
             delete newPipe;
 
             return;
         }
 
-        if (!m_handlerMgr.AddHandler(newSockId, this, PRO_MASK_READ))
+        pbsd_epoll_event ev;
+        memset(&ev, 0, sizeof(pbsd_epoll_event));
+        ev.events   = PRO_EPOLLIN_SET;
+        ev.data.u64 = MakeEventTag_i(
+            newSockId, m_handlerMgr.FindHandler(newSockId).generation);
+
+        if (pbsd_epoll_ctl(m_epfd, EPOLL_CTL_ADD, (int)newSockId, &ev) != 0)
         {
-            pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, ev.data.fd, &ev);
+            m_handlerMgr.RemoveHandler(newSockId, PRO_MASK_READ);
             delete newPipe;
 
             return;
@@ -580,16 +1044,13 @@ CProEpollReactor::OnError(PRO_INT64 sockId,
         /*
          * unregister old
          */
-        ev.data.fd = (int)sockId;
-        pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, ev.data.fd, &ev);
+        pbsd_epoll_ctl(m_epfd, EPOLL_CTL_DEL, (int)sockId, &ev);
         m_handlerMgr.RemoveHandler(sockId, PRO_MASK_READ);
-        delete m_notifyPipe;
-        m_notifyPipe = NULL;
 
         /*
          * register new
          */
-        m_notifyPipe = newPipe;
+        ReplaceNotifyPipe(newPipe);
     }
 }
 
@@ -20,12 +20,23 @@
 #define PRO_EPOLL_REACTOR_H
 
 #include "pro_base_reactor.h"
+#include "../pro_util/pro_timer_factory.h"
 
 #if defined(PRO_HAS_EPOLL)
 
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+struct PRO_EPOLL_READY_INFO
+{
+    CProEventHandler* handler;
+    PRO_INT64         sockId;
+    unsigned long     mask;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
 class CProEpollReactor : public CProBaseReactor
 {
 public:
@@ -49,10 +60,53 @@ public:
         unsigned long mask
         );
 
+    virtual bool PRO_CALLTYPE RaiseEvent(
+        PRO_INT64         sockId,
+        CProEventHandler* handler,
+        unsigned long     mask
+        );
+
+    virtual unsigned long PRO_CALLTYPE DropRaisedEvents(PRO_INT64 sockId);
+
+    virtual bool PRO_CALLTYPE InitTimers(bool timingWheel);
+
+    virtual unsigned long PRO_CALLTYPE ScheduleTimer(
+        IProOnTimer* onTimer,
+        PRO_UINT64   timeSpan,
+        bool         recurring,
+        PRO_INT64    userData
+        );
+
+    virtual unsigned long PRO_CALLTYPE ScheduleHeartbeatTimer(
+        IProOnTimer* onTimer,
+        PRO_INT64    userData
+        );
+
+    virtual unsigned long PRO_CALLTYPE JoinHeartbeatGroup(
+        PRO_HEARTBEAT_ENTRY* entry,
+        IProOnTimer*         onTimer,
+        PRO_INT64            userData
+        );
+
+    virtual bool PRO_CALLTYPE LeaveHeartbeatGroup(
+        PRO_HEARTBEAT_ENTRY* entry,
+        unsigned long        timerId
+        );
+
+    virtual bool PRO_CALLTYPE UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds);
+
+    virtual bool PRO_CALLTYPE CancelTimer(unsigned long timerId);
+
+    virtual unsigned long PRO_CALLTYPE GetTimerCount() const;
+
     virtual void PRO_CALLTYPE WorkerRun();
 
 private:
 
+    void SetTimer_i();
+
+    void PollTimers();
+
     virtual void PRO_CALLTYPE OnInput(PRO_INT64 sockId);
 
     virtual void PRO_CALLTYPE OnError(
@@ -62,8 +116,16 @@ private:
 
 private:
 
-    int              m_epfd;
-    pbsd_epoll_event m_events[PRO_EPOLLFD_GETSIZE]; /* sizeof(epoll_event) is 16 */
+    int                  m_epfd;
+    int                  m_timerfd;
+    PRO_INT64            m_armedTick;
+    CProTimerFactory     m_timerFactory;
+    pbsd_epoll_event     m_events[PRO_EPOLLFD_GETSIZE]; /* sizeof(epoll_event) is 16 */
+    PRO_EPOLL_READY_INFO m_ready[PRO_EPOLLFD_GETSIZE];
+
+    CProStlVector<PRO_EPOLL_READY_INFO> m_raised;
+    CProStlVector<PRO_EPOLL_READY_INFO> m_raised2;     /* swapped with m_raised */
+    bool                                m_raisedBySelf;
 };
 
 /////////////////////////////////////////////////////////////////////////////
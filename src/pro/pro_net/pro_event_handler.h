@@ -37,6 +37,11 @@ static const unsigned long PRO_MASK_READ      = 1 << 3;
 static const unsigned long PRO_MASK_EXCEPTION = 1 << 4;
 static const unsigned long PRO_MASK_ERROR     = 1 << 5;
 
+/*
+ * the max reads or accepts of an edge-triggered handler per wakeup
+ */
+static const int           PRO_EDGE_BUDGET    = 16;
+
 class CProBaseReactor;
 
 /////////////////////////////////////////////////////////////////////////////
@@ -86,6 +91,14 @@ public:
     {
     }
 
+    /*
+     * the handler has been moved to another reactor, in the thread of the
+     * old one. the timers held by the old reactor should be rescheduled
+     */
+    virtual void PRO_CALLTYPE OnReactorMoved()
+    {
+    }
+
     void SetReactor(CProBaseReactor* reactor)
     {
         m_reactor = reactor;
@@ -96,6 +109,35 @@ public:
         return (m_reactor);
     }
 
+    void SetTimerReactor(CProBaseReactor* reactor)
+    {
+        m_timerReactor = reactor;
+    }
+
+    CProBaseReactor* GetTimerReactor() const
+    {
+        return (m_timerReactor);
+    }
+
+    PRO_HEARTBEAT_ENTRY* GetHeartbeatEntry()
+    {
+        return (&m_htbtEntry);
+    }
+
+    /*
+     * an edge-triggered handler should read or accept until EAGAIN.
+     * it's set before the handler is registered
+     */
+    void SetEdgeTriggered(bool edgeTriggered)
+    {
+        m_edgeTriggered = edgeTriggered;
+    }
+
+    bool IsEdgeTriggered() const
+    {
+        return (m_edgeTriggered);
+    }
+
     void AddMask(unsigned long mask)
     {
         PRO_SET_BITS(m_mask, mask);
@@ -111,12 +153,43 @@ public:
         return (m_mask);
     }
 
+    /*
+     * the bytes received or sent in the reactor thread. they're read by the
+     * load balancer without lock, so they're estimates
+     */
+    void AddIoBytes(size_t bytes)
+    {
+        m_ioBytes += bytes;
+    }
+
+    /*
+     * returns the bytes since the last sample
+     */
+    PRO_UINT64 SampleIoBytes()
+    {
+        const PRO_UINT64 ioBytes = m_ioBytes;
+        m_ioRate         = ioBytes - m_ioBytesSampled;
+        m_ioBytesSampled = ioBytes;
+
+        return (m_ioRate);
+    }
+
+    PRO_UINT64 GetSampledIoBytes() const
+    {
+        return (m_ioRate);
+    }
+
 protected:
 
     CProEventHandler()
     {
-        m_reactor = NULL;
-        m_mask    = 0;
+        m_reactor        = NULL;
+        m_timerReactor   = NULL;
+        m_edgeTriggered  = false;
+        m_mask           = 0;
+        m_ioBytes        = 0;
+        m_ioBytesSampled = 0;
+        m_ioRate         = 0;
     }
 
     virtual ~CProEventHandler()
@@ -125,8 +198,14 @@ protected:
 
 private:
 
-    CProBaseReactor* m_reactor;
-    unsigned long    m_mask;
+    CProBaseReactor*    m_reactor;
+    CProBaseReactor*    m_timerReactor; /* the reactor holding the timers */
+    bool                m_edgeTriggered;
+    unsigned long       m_mask;
+    PRO_HEARTBEAT_ENTRY m_htbtEntry;
+    PRO_UINT64          m_ioBytes;
+    PRO_UINT64          m_ioBytesSampled;
+    PRO_UINT64          m_ioRate;         /* the bytes of the last sample */
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,8 @@
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+#define PRO_DENSE_SOCKID_MAX (1024 * 1024)
+
 CProHandlerMgr::~CProHandlerMgr()
 {
     CProStlMap<PRO_INT64, PRO_HANDLER_INFO>::const_iterator       itr = m_sockId2HandlerInfo.begin();
@@ -38,6 +40,7 @@ CProHandlerMgr::~CProHandlerMgr()
     }
 
     m_sockId2HandlerInfo.clear();
+    m_fd2HandlerInfo.clear();
 }
 
 bool
@@ -57,9 +60,41 @@ CProHandlerMgr::AddHandler(PRO_INT64         sockId,
         m_sockId2HandlerInfo.find(sockId);
     if (itr == m_sockId2HandlerInfo.end())
     {
+        ++m_generation;
+        m_generation &= 0xFFFFFFFF;
+        if (m_generation == 0)
+        {
+            m_generation = 1;
+        }
+
         PRO_HANDLER_INFO info;
-        info.handler = handler;
-        info.mask    = mask;
+        info.handler    = handler;
+        info.mask       = mask;
+        info.generation = m_generation;
+
+        if (IsDense_i(sockId))
+        {
+            if (sockId >= (PRO_INT64)m_fd2HandlerInfo.size())
+            {
+                size_t size = m_fd2HandlerInfo.size() * 2;
+                if (size < 64)
+                {
+                    size = 64;
+                }
+                if (size < (size_t)sockId + 1)
+                {
+                    size = (size_t)sockId + 1;
+                }
+                if (size > PRO_DENSE_SOCKID_MAX)
+                {
+                    size = PRO_DENSE_SOCKID_MAX;
+                }
+
+                m_fd2HandlerInfo.resize(size);
+            }
+
+            m_fd2HandlerInfo[(size_t)sockId] = info;
+        }
 
         info.handler->AddRef();
         m_sockId2HandlerInfo[sockId] = info;
@@ -73,6 +108,11 @@ CProHandlerMgr::AddHandler(PRO_INT64         sockId,
     {
         PRO_SET_BITS(info.mask, mask);
 
+        if (IsDense_i(sockId))
+        {
+            m_fd2HandlerInfo[(size_t)sockId].mask = info.mask;
+        }
+
         return (true);
     }
     else
@@ -100,6 +140,18 @@ CProHandlerMgr::RemoveHandler(PRO_INT64     sockId,
     PRO_HANDLER_INFO& info = itr->second;
     PRO_CLR_BITS(info.mask, mask);
 
+    if (IsDense_i(sockId))
+    {
+        if (info.mask == 0)
+        {
+            m_fd2HandlerInfo[(size_t)sockId] = PRO_HANDLER_INFO();
+        }
+        else
+        {
+            m_fd2HandlerInfo[(size_t)sockId].mask = info.mask;
+        }
+    }
+
     if (info.mask == 0)
     {
         info.handler->Release();
@@ -139,14 +191,37 @@ CProHandlerMgr::FindHandler(PRO_INT64 sockId) const
         return (info);
     }
 
+    const PRO_HANDLER_INFO* const info2 = FindHandlerFast(sockId);
+    if (info2 != NULL)
+    {
+        info = *info2;
+    }
+
+    return (info);
+}
+
+const PRO_HANDLER_INFO*
+CProHandlerMgr::FindHandlerSlow_i(PRO_INT64 sockId) const
+{
+    if (IsDense_i(sockId))
+    {
+        return (NULL); /* beyond the index, so it's not registered */
+    }
+
     CProStlMap<PRO_INT64, PRO_HANDLER_INFO>::const_iterator const itr =
         m_sockId2HandlerInfo.find(sockId);
-    if (itr != m_sockId2HandlerInfo.end())
+    if (itr == m_sockId2HandlerInfo.end())
     {
-        info = itr->second;
+        return (NULL);
     }
 
-    return (info);
+    return (&itr->second);
+}
+
+bool
+CProHandlerMgr::IsDense_i(PRO_INT64 sockId) const
+{
+    return (sockId >= 0 && sockId < PRO_DENSE_SOCKID_MAX);
 }
 
 const CProStlMap<PRO_INT64, PRO_HANDLER_INFO>&
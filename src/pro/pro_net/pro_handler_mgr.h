@@ -32,12 +32,14 @@ struct PRO_HANDLER_INFO
 {
     PRO_HANDLER_INFO()
     {
-        handler = NULL;
-        mask    = 0;
+        handler    = NULL;
+        mask       = 0;
+        generation = 0;
     }
 
     CProEventHandler* handler;
     unsigned long     mask;
+    unsigned long     generation; /* 1 ~ 0xFFFFFFFF, changes per registration */
 
     DECLARE_SGI_POOL(0);
 };
@@ -51,6 +53,7 @@ public:
 
     CProHandlerMgr()
     {
+        m_generation = 0;
     }
 
     ~CProHandlerMgr();
@@ -72,11 +75,42 @@ public:
 
     const PRO_HANDLER_INFO FindHandler(PRO_INT64 sockId) const;
 
+    /*
+     * O(1) lookup for the dispatch path. returns NULL if not found
+     */
+    const PRO_HANDLER_INFO* FindHandlerFast(PRO_INT64 sockId) const
+    {
+        if (sockId >= 0 && sockId < (PRO_INT64)m_fd2HandlerInfo.size())
+        {
+            const PRO_HANDLER_INFO& info = m_fd2HandlerInfo[(size_t)sockId];
+            if (info.handler != NULL)
+            {
+                return (&info);
+            }
+
+            return (NULL);
+        }
+
+        return (FindHandlerSlow_i(sockId));
+    }
+
     const CProStlMap<PRO_INT64, PRO_HANDLER_INFO>& GetAllHandlers() const;
 
 private:
 
+    const PRO_HANDLER_INFO* FindHandlerSlow_i(PRO_INT64 sockId) const;
+
+    bool IsDense_i(PRO_INT64 sockId) const;
+
+private:
+
+    /*
+     * the map holds all the handlers, and the vector is an index of the
+     * small descriptors that the dispatch path looks up without a tree walk
+     */
     CProStlMap<PRO_INT64, PRO_HANDLER_INFO> m_sockId2HandlerInfo;
+    CProStlVector<PRO_HANDLER_INFO>         m_fd2HandlerInfo;
+    unsigned long                           m_generation;
 
     DECLARE_SGI_POOL(0);
 };
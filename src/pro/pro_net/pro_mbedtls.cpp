@@ -27,11 +27,17 @@
 #include "mbedtls/entropy.h"
 #include "mbedtls/md.h"
 #include "mbedtls/net_sockets.h"
+#include "mbedtls/platform_util.h"
 #include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_internal.h"
+#include "mbedtls/ssl_ticket.h"
 #include "mbedtls/threading.h"
 #include "mbedtls/x509_crt.h"
 
 #include <cassert>
+#include <cstdio>
+#include <cstring>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -40,7 +46,11 @@ extern "C" {
 /////////////////////////////////////////////////////////////////////////////
 ////
 
-#define MAGIC_BYTES (1024 * 16)
+#define MAGIC_BYTES          (1024 * 16)
+#define DEFAULT_SESSION_LIFE (60 * 60 * 24)
+#define MAX_SAVED_SESSIONS   1000
+#define RECORD_BUFFER_BYTES  (MBEDTLS_SSL_IN_BUFFER_LEN + MBEDTLS_SSL_OUT_BUFFER_LEN)
+#define RECORD_CTR_BYTES     8
 
 /////////////////////////////////////////////////////////////////////////////
 ////
@@ -256,9 +266,17 @@ struct PRO_SSL_SERVER_CONFIG : public mbedtls_ssl_config
         mbedtls_entropy_init(&entropy);
         mbedtls_ctr_drbg_init(&rng);
         mbedtls_ssl_config_init(this);
+        mbedtls_ssl_ticket_init(&ticket);
+        mbedtls_ssl_cache_init(&cache);
 
         sha1Profile = mbedtls_x509_crt_profile_default;
         sha1Profile.allowed_mds |= MBEDTLS_X509_ID_FLAG(MBEDTLS_MD_SHA1);
+        ticketReady    = false;
+        dynamicBuffers = false;
+        fullCount      = 0;
+        resumedCount   = 0;
+        ctxCount       = 0;
+        bufferBytes    = 0;
 
         return (true);
     }
@@ -266,6 +284,8 @@ struct PRO_SSL_SERVER_CONFIG : public mbedtls_ssl_config
     void Fini()
     {
         pro_ssl_config_free(this);
+        mbedtls_ssl_cache_free(&cache);
+        mbedtls_ssl_ticket_free(&ticket);
 
         CProStlMap<CProStlString, PRO_SSL_AUTH_ITEM>::iterator       itr = sni2Auth.begin();
         CProStlMap<CProStlString, PRO_SSL_AUTH_ITEM>::iterator const end = sni2Auth.end();
@@ -290,6 +310,16 @@ struct PRO_SSL_SERVER_CONFIG : public mbedtls_ssl_config
     PRO_SSL_SUITE_LIST                           suites;
     PRO_SSL_ALPN_LIST                            alpns;
     mbedtls_x509_crt_profile                     sha1Profile;
+    mbedtls_ssl_ticket_context                   ticket;
+    mbedtls_ssl_cache_context                    cache;
+    bool                                         ticketReady;
+    bool                                         dynamicBuffers;
+
+    mutable PRO_UINT64                           fullCount;
+    mutable PRO_UINT64                           resumedCount;
+    mutable PRO_UINT64                           ctxCount;
+    mutable PRO_UINT64                           bufferBytes; /* the record buffers */
+    mutable CProThreadMutex                      lock;
 
     DECLARE_SGI_POOL(0);
 };
@@ -324,12 +354,28 @@ struct PRO_SSL_CLIENT_CONFIG : public mbedtls_ssl_config
 
         sha1Profile = mbedtls_x509_crt_profile_default;
         sha1Profile.allowed_mds |= MBEDTLS_X509_ID_FLAG(MBEDTLS_MD_SHA1);
+        reuse          = false;
+        dynamicBuffers = false;
+        fullCount      = 0;
+        resumedCount   = 0;
+        ctxCount       = 0;
+        bufferBytes    = 0;
 
         return (true);
     }
 
     void Fini()
     {
+        CProStlMap<CProStlString, mbedtls_ssl_session*>::iterator       itr = sessions.begin();
+        CProStlMap<CProStlString, mbedtls_ssl_session*>::iterator const end = sessions.end();
+
+        for (; itr != end; ++itr)
+        {
+            mbedtls_ssl_session_free(itr->second);
+            ProFree(itr->second);
+        }
+
+        sessions.clear();
         pro_ssl_config_free(this);
         alpns.Fini();
         suites.Fini();
@@ -344,6 +390,15 @@ struct PRO_SSL_CLIENT_CONFIG : public mbedtls_ssl_config
     PRO_SSL_SUITE_LIST       suites;
     PRO_SSL_ALPN_LIST        alpns;
     mbedtls_x509_crt_profile sha1Profile;
+    bool                     reuse;
+    bool                     dynamicBuffers;
+
+    mutable CProStlMap<CProStlString, mbedtls_ssl_session*> sessions; /* server ===> session */
+    mutable PRO_UINT64                                      fullCount;
+    mutable PRO_UINT64                                      resumedCount;
+    mutable PRO_UINT64                                      ctxCount;
+    mutable PRO_UINT64                                      bufferBytes; /* the record buffers */
+    mutable CProThreadMutex                                 lock;
 
     DECLARE_SGI_POOL(0);
 };
@@ -353,14 +408,41 @@ struct PRO_SSL_CTX : public mbedtls_ssl_context
     PRO_SSL_CTX(PRO_INT64 theSockId, PRO_UINT64 theNonce)
         : sockId(theSockId), nonce(pbsd_hton64(theNonce))
     {
-        sentBytes = 0;
-        recvBytes = 0;
-    }
-
-    const PRO_INT64  sockId;
-    const PRO_UINT64 nonce; /* network byte order */
-    PRO_INT64        sentBytes;
-    PRO_INT64        recvBytes;
+        sentBytes    = 0;
+        recvBytes    = 0;
+        serverConfig = NULL;
+        clientConfig = NULL;
+        resumed      = false;
+        counted      = false;
+        released     = false;
+        inHdrOffset  = 0;
+        inMsgOffset  = 0;
+        outHdrOffset = 0;
+        outMsgOffset = 0;
+        memset(inCtr , 0, sizeof(inCtr));
+        memset(outCtr, 0, sizeof(outCtr));
+    }
+
+    const PRO_INT64              sockId;
+    const PRO_UINT64             nonce; /* network byte order */
+    PRO_INT64                    sentBytes;
+    PRO_INT64                    recvBytes;
+    const PRO_SSL_SERVER_CONFIG* serverConfig;
+    const PRO_SSL_CLIENT_CONFIG* clientConfig;
+    CProStlString                sessionKey;   /* for the client */
+    bool                         resumed;
+    bool                         counted;
+
+    /*
+     * the saved state of the released record buffers
+     */
+    bool                         released;
+    size_t                       inHdrOffset;
+    size_t                       inMsgOffset;
+    size_t                       outHdrOffset;
+    size_t                       outMsgOffset;
+    unsigned char                inCtr[RECORD_CTR_BYTES];  /* the implicit sequence numbers */
+    unsigned char                outCtr[RECORD_CTR_BYTES];
 
     DECLARE_SGI_POOL(0);
 };
@@ -698,6 +780,237 @@ ProRecv_i(void*          ctx,
     }
 }
 
+static
+void
+ProSessionKey_i(const char*    serverHostName,
+                PRO_INT64      sockId,
+                CProStlString& key)
+{
+    key = "";
+
+    if (serverHostName != NULL && serverHostName[0] != '\0')
+    {
+        key = serverHostName;
+
+        return;
+    }
+
+    pbsd_sockaddr_in remoteAddr;
+    if (pbsd_getpeername(sockId, &remoteAddr) != 0)
+    {
+        return;
+    }
+
+    char remoteIp[64] = "";
+    char theKey[100]  = "";
+    sprintf(
+        theKey,
+        "%s:%u",
+        pbsd_inet_ntoa(remoteAddr.sin_addr.s_addr, remoteIp),
+        (unsigned int)pbsd_ntoh16(remoteAddr.sin_port)
+        );
+    key = theKey;
+}
+
+static
+void
+ProSaveSession_i(PRO_SSL_CTX* ctx)
+{
+    assert(ctx != NULL);
+    assert(ctx->clientConfig != NULL);
+
+    mbedtls_ssl_session* const session =
+        (mbedtls_ssl_session*)ProCalloc(1, sizeof(mbedtls_ssl_session));
+    if (session == NULL)
+    {
+        return;
+    }
+
+    mbedtls_ssl_session_init(session);
+
+    if (mbedtls_ssl_get_session(ctx, session) != 0)
+    {
+        mbedtls_ssl_session_free(session);
+        ProFree(session);
+
+        return;
+    }
+
+    mbedtls_ssl_session* oldSession = NULL;
+
+    {
+        CProThreadMutexGuard mon(ctx->clientConfig->lock);
+
+        CProStlMap<CProStlString, mbedtls_ssl_session*>& sessions =
+            ctx->clientConfig->sessions;
+
+        CProStlMap<CProStlString, mbedtls_ssl_session*>::iterator itr =
+            sessions.find(ctx->sessionKey);
+        if (itr != sessions.end())
+        {
+            oldSession = itr->second;
+            sessions.erase(itr);
+        }
+        else if (sessions.size() >= MAX_SAVED_SESSIONS)
+        {
+            itr        = sessions.begin();
+            oldSession = itr->second;
+            sessions.erase(itr);
+        }
+        else
+        {
+        }
+
+        sessions[ctx->sessionKey] = session;
+    }
+
+    if (oldSession != NULL)
+    {
+        mbedtls_ssl_session_free(oldSession);
+        ProFree(oldSession);
+    }
+}
+
+static
+void
+ProDropSession_i(PRO_SSL_CTX* ctx)
+{
+    assert(ctx != NULL);
+    assert(ctx->clientConfig != NULL);
+
+    mbedtls_ssl_session* oldSession = NULL;
+
+    {
+        CProThreadMutexGuard mon(ctx->clientConfig->lock);
+
+        CProStlMap<CProStlString, mbedtls_ssl_session*>& sessions =
+            ctx->clientConfig->sessions;
+
+        CProStlMap<CProStlString, mbedtls_ssl_session*>::iterator const itr =
+            sessions.find(ctx->sessionKey);
+        if (itr == sessions.end())
+        {
+            return;
+        }
+
+        oldSession = itr->second;
+        sessions.erase(itr);
+    }
+
+    mbedtls_ssl_session_free(oldSession);
+    ProFree(oldSession);
+}
+
+static
+bool
+ProMflCode_i(unsigned long  maxFragmentLength,
+             unsigned char& mflCode)
+{
+    switch (maxFragmentLength)
+    {
+    case 0:
+        {
+            mflCode = MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+            break;
+        }
+
+    case 512:
+        {
+            mflCode = MBEDTLS_SSL_MAX_FRAG_LEN_512;
+            break;
+        }
+
+    case 1024:
+        {
+            mflCode = MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+            break;
+        }
+
+    case 2048:
+        {
+            mflCode = MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+            break;
+        }
+
+    case 4096:
+        {
+            mflCode = MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+            break;
+        }
+
+    default:
+        {
+            return (false);
+        }
+    } /* end of switch (...) */
+
+    return (true);
+}
+
+static
+bool
+ProIsDynamic_i(const PRO_SSL_CTX* ctx)
+{
+    assert(ctx != NULL);
+
+    if (ctx->serverConfig != NULL)
+    {
+        return (ctx->serverConfig->dynamicBuffers);
+    }
+    if (ctx->clientConfig != NULL)
+    {
+        return (ctx->clientConfig->dynamicBuffers);
+    }
+
+    return (false);
+}
+
+static
+void
+ProCountBuffers_i(const PRO_SSL_CTX* ctx,
+                  int                ctxDelta,
+                  int                bytesDelta)
+{
+    assert(ctx != NULL);
+
+    if (ctx->serverConfig != NULL)
+    {
+        CProThreadMutexGuard mon(ctx->serverConfig->lock);
+
+        ctx->serverConfig->ctxCount    += ctxDelta;
+        ctx->serverConfig->bufferBytes += bytesDelta;
+    }
+
+    if (ctx->clientConfig != NULL)
+    {
+        CProThreadMutexGuard mon(ctx->clientConfig->lock);
+
+        ctx->clientConfig->ctxCount    += ctxDelta;
+        ctx->clientConfig->bufferBytes += bytesDelta;
+    }
+}
+
+/*
+ * nothing is buffered in the records, and no handshake is running
+ */
+static
+bool
+ProIsIdle_i(const PRO_SSL_CTX* ctx)
+{
+    assert(ctx != NULL);
+
+    return (
+        ctx->state                == MBEDTLS_SSL_HANDSHAKE_OVER &&
+        ctx->handshake            == NULL                       &&
+        ctx->in_left              == 0                          &&
+        ctx->in_msglen            == 0                          &&
+        ctx->in_offt              == NULL                       &&
+        ctx->in_hslen             == 0                          &&
+        ctx->keep_current_message == 0                          &&
+        ctx->out_left             == 0
+        );
+}
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -1374,6 +1687,174 @@ ProSslServerConfig_SetSniAuthLevel(PRO_SSL_SERVER_CONFIG* config,
     return (true);
 }
 
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslServerConfig_EnableSessionTickets(PRO_SSL_SERVER_CONFIG* config,
+                                        bool                   enable,
+                                        unsigned long          lifetimeInSeconds) /* = 0 */
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return (false);
+    }
+
+    if (!enable)
+    {
+        mbedtls_ssl_conf_session_tickets_cb(config, NULL, NULL, NULL);
+
+        return (true);
+    }
+
+    if (lifetimeInSeconds == 0)
+    {
+        lifetimeInSeconds = DEFAULT_SESSION_LIFE;
+    }
+
+    /*
+     * mbedtls keeps two keys and rotates them once per lifetime
+     */
+    if (!config->ticketReady)
+    {
+        if (mbedtls_ssl_ticket_setup(&config->ticket, &ProRngs_i, config,
+            MBEDTLS_CIPHER_AES_256_GCM, (uint32_t)lifetimeInSeconds) != 0)
+        {
+            return (false);
+        }
+
+        config->ticketReady = true;
+    }
+    else
+    {
+        config->ticket.ticket_lifetime = (uint32_t)lifetimeInSeconds;
+    }
+
+    mbedtls_ssl_conf_session_tickets_cb(config,
+        &mbedtls_ssl_ticket_write, &mbedtls_ssl_ticket_parse, &config->ticket);
+
+    return (true);
+}
+
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslServerConfig_SetSessionCache(PRO_SSL_SERVER_CONFIG* config,
+                                   unsigned long          maxEntries,
+                                   unsigned long          timeoutInSeconds) /* = 0 */
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return (false);
+    }
+
+    if (maxEntries == 0)
+    {
+        mbedtls_ssl_conf_session_cache(config, NULL, NULL, NULL);
+
+        return (true);
+    }
+
+    if (timeoutInSeconds == 0)
+    {
+        timeoutInSeconds = DEFAULT_SESSION_LIFE;
+    }
+
+    mbedtls_ssl_cache_set_max_entries(&config->cache, (int)maxEntries);
+    mbedtls_ssl_cache_set_timeout(&config->cache, (int)timeoutInSeconds);
+    mbedtls_ssl_conf_session_cache(config,
+        &config->cache, &mbedtls_ssl_cache_get, &mbedtls_ssl_cache_set);
+
+    return (true);
+}
+
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslServerConfig_GetHandshakeCounts(const PRO_SSL_SERVER_CONFIG* config,
+                                      PRO_UINT64*                  fullCount,    /* = NULL */
+                                      PRO_UINT64*                  resumedCount) /* = NULL */
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return;
+    }
+
+    CProThreadMutexGuard mon(config->lock);
+
+    if (fullCount != NULL)
+    {
+        *fullCount    = config->fullCount;
+    }
+    if (resumedCount != NULL)
+    {
+        *resumedCount = config->resumedCount;
+    }
+}
+
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslServerConfig_EnableDynamicBuffers(PRO_SSL_SERVER_CONFIG* config,
+                                        bool                   enable)
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return;
+    }
+
+    config->dynamicBuffers = enable;
+}
+
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslServerConfig_SetMaxFragmentLength(PRO_SSL_SERVER_CONFIG* config,
+                                        unsigned long          maxFragmentLength)
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return (false);
+    }
+
+    unsigned char mflCode = MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+    if (!ProMflCode_i(maxFragmentLength, mflCode))
+    {
+        return (false);
+    }
+
+    return (mbedtls_ssl_conf_max_frag_len(config, mflCode) == 0);
+}
+
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslServerConfig_GetBufferInfo(const PRO_SSL_SERVER_CONFIG* config,
+                                 PRO_UINT64*                  ctxCount,    /* = NULL */
+                                 PRO_UINT64*                  bufferBytes) /* = NULL */
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return;
+    }
+
+    CProThreadMutexGuard mon(config->lock);
+
+    if (ctxCount != NULL)
+    {
+        *ctxCount    = config->ctxCount;
+    }
+    if (bufferBytes != NULL)
+    {
+        *bufferBytes = config->bufferBytes;
+    }
+}
+
 /*-------------------------------------------------------------------------*/
 
 PRO_NET_API
@@ -1407,6 +1888,8 @@ ProSslClientConfig_Create()
         goto EXIT;
     }
 
+    mbedtls_ssl_conf_session_tickets(config, MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
+
     config->suites.suites->push_back(PRO_SSL_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256);
     config->suites.suites->push_back(PRO_SSL_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256);
     config->suites.suites->push_back(PRO_SSL_DHE_RSA_WITH_CHACHA20_POLY1305_SHA256);
@@ -1770,6 +2253,109 @@ ProSslClientConfig_SetAuthLevel(PRO_SSL_CLIENT_CONFIG* config,
     return (true);
 }
 
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslClientConfig_EnableSessionReuse(PRO_SSL_CLIENT_CONFIG* config,
+                                      bool                   enable)
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return;
+    }
+
+    config->reuse = enable;
+    mbedtls_ssl_conf_session_tickets(config, enable
+        ? MBEDTLS_SSL_SESSION_TICKETS_ENABLED : MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
+}
+
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslClientConfig_GetHandshakeCounts(const PRO_SSL_CLIENT_CONFIG* config,
+                                      PRO_UINT64*                  fullCount,    /* = NULL */
+                                      PRO_UINT64*                  resumedCount) /* = NULL */
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return;
+    }
+
+    CProThreadMutexGuard mon(config->lock);
+
+    if (fullCount != NULL)
+    {
+        *fullCount    = config->fullCount;
+    }
+    if (resumedCount != NULL)
+    {
+        *resumedCount = config->resumedCount;
+    }
+}
+
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslClientConfig_EnableDynamicBuffers(PRO_SSL_CLIENT_CONFIG* config,
+                                        bool                   enable)
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return;
+    }
+
+    config->dynamicBuffers = enable;
+}
+
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslClientConfig_SetMaxFragmentLength(PRO_SSL_CLIENT_CONFIG* config,
+                                        unsigned long          maxFragmentLength)
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return (false);
+    }
+
+    unsigned char mflCode = MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+    if (!ProMflCode_i(maxFragmentLength, mflCode))
+    {
+        return (false);
+    }
+
+    return (mbedtls_ssl_conf_max_frag_len(config, mflCode) == 0);
+}
+
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslClientConfig_GetBufferInfo(const PRO_SSL_CLIENT_CONFIG* config,
+                                 PRO_UINT64*                  ctxCount,    /* = NULL */
+                                 PRO_UINT64*                  bufferBytes) /* = NULL */
+{
+    assert(config != NULL);
+    if (config == NULL)
+    {
+        return;
+    }
+
+    CProThreadMutexGuard mon(config->lock);
+
+    if (ctxCount != NULL)
+    {
+        *ctxCount    = config->ctxCount;
+    }
+    if (bufferBytes != NULL)
+    {
+        *bufferBytes = config->bufferBytes;
+    }
+}
+
 /*-------------------------------------------------------------------------*/
 
 PRO_NET_API
@@ -1797,6 +2383,8 @@ ProSslCtx_Creates(const PRO_SSL_SERVER_CONFIG* config,
         return (NULL);
     }
 
+    ctx->serverConfig = config;
+    ProCountBuffers_i(ctx, 1, RECORD_BUFFER_BYTES);
     mbedtls_ssl_set_bio(ctx, ctx, &ProSend_i, &ProRecv_i, NULL);
 
     return (ctx);
@@ -1841,6 +2429,26 @@ ProSslCtx_Createc(const PRO_SSL_CLIENT_CONFIG* config,
         return (NULL);
     }
 
+    ctx->clientConfig = config;
+    ProCountBuffers_i(ctx, 1, RECORD_BUFFER_BYTES);
+
+    if (config->reuse)
+    {
+        ProSessionKey_i(serverHostName, sockId, ctx->sessionKey);
+    }
+
+    if (!ctx->sessionKey.empty())
+    {
+        CProThreadMutexGuard mon(config->lock);
+
+        CProStlMap<CProStlString, mbedtls_ssl_session*>::const_iterator const itr =
+            config->sessions.find(ctx->sessionKey);
+        if (itr != config->sessions.end())
+        {
+            mbedtls_ssl_set_session(ctx, itr->second); /* a full handshake if failed */
+        }
+    }
+
     mbedtls_ssl_set_bio(ctx, ctx, &ProSend_i, &ProRecv_i, NULL);
 
     return (ctx);
@@ -1856,10 +2464,215 @@ ProSslCtx_Delete(PRO_SSL_CTX* ctx)
         return;
     }
 
+    ProCountBuffers_i(ctx, -1, ctx->released ? 0 : -RECORD_BUFFER_BYTES);
     pro_ssl_free(ctx);
     delete ctx;
 }
 
+PRO_NET_API
+int
+PRO_CALLTYPE
+ProSslCtx_Handshake(PRO_SSL_CTX* ctx)
+{
+    assert(ctx != NULL);
+    if (ctx == NULL)
+    {
+        return (MBEDTLS_ERR_SSL_BAD_INPUT_DATA);
+    }
+
+    int ret = 0;
+
+    while (ctx->state != MBEDTLS_SSL_HANDSHAKE_OVER)
+    {
+        /*
+         * the client sets "resume" before the ServerHello and clears it if
+         * the server refuses, so keep the last value before the wrapup
+         */
+        if (ctx->handshake != NULL)
+        {
+            ctx->resumed = ctx->handshake->resume != 0;
+        }
+
+        ret = mbedtls_ssl_handshake_step(ctx);
+        if (ret != 0)
+        {
+            break;
+        }
+    }
+
+    if (ret != 0)
+    {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE &&
+            !ctx->sessionKey.empty())
+        {
+            ProDropSession_i(ctx);
+        }
+
+        return (ret);
+    }
+
+    if (ctx->counted)
+    {
+        return (0);
+    }
+
+    ctx->counted = true;
+
+    if (ctx->serverConfig != NULL)
+    {
+        CProThreadMutexGuard mon(ctx->serverConfig->lock);
+
+        if (ctx->resumed)
+        {
+            ++ctx->serverConfig->resumedCount;
+        }
+        else
+        {
+            ++ctx->serverConfig->fullCount;
+        }
+    }
+
+    if (ctx->clientConfig != NULL)
+    {
+        {
+            CProThreadMutexGuard mon(ctx->clientConfig->lock);
+
+            if (ctx->resumed)
+            {
+                ++ctx->clientConfig->resumedCount;
+            }
+            else
+            {
+                ++ctx->clientConfig->fullCount;
+            }
+        }
+
+        if (!ctx->sessionKey.empty())
+        {
+            ProSaveSession_i(ctx);
+        }
+    }
+
+    return (0);
+}
+
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslCtx_IsResumed(PRO_SSL_CTX* ctx)
+{
+    assert(ctx != NULL);
+    if (ctx == NULL)
+    {
+        return (false);
+    }
+
+    return (ctx->resumed);
+}
+
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslCtx_ReleaseBuffers(PRO_SSL_CTX* ctx)
+{
+    assert(ctx != NULL);
+    if (ctx == NULL)
+    {
+        return (false);
+    }
+
+    if (ctx->released)
+    {
+        return (true);
+    }
+
+    if (!ProIsDynamic_i(ctx) || !ProIsIdle_i(ctx))
+    {
+        return (false);
+    }
+
+    /*
+     * for tls, the implicit sequence numbers live in the 8 bytes before
+     * the record headers
+     */
+    ctx->inHdrOffset  = ctx->in_hdr  - ctx->in_buf;
+    ctx->inMsgOffset  = ctx->in_msg  - ctx->in_buf;
+    ctx->outHdrOffset = ctx->out_hdr - ctx->out_buf;
+    ctx->outMsgOffset = ctx->out_msg - ctx->out_buf;
+    memcpy(ctx->inCtr , ctx->in_ctr , RECORD_CTR_BYTES);
+    memcpy(ctx->outCtr, ctx->out_ctr, RECORD_CTR_BYTES);
+
+    mbedtls_platform_zeroize(ctx->in_buf , MBEDTLS_SSL_IN_BUFFER_LEN);
+    mbedtls_platform_zeroize(ctx->out_buf, MBEDTLS_SSL_OUT_BUFFER_LEN);
+    ProFree(ctx->in_buf);
+    ProFree(ctx->out_buf);
+
+    ctx->in_buf   = NULL;
+    ctx->in_ctr   = NULL;
+    ctx->in_hdr   = NULL;
+    ctx->in_len   = NULL;
+    ctx->in_iv    = NULL;
+    ctx->in_msg   = NULL;
+    ctx->out_buf  = NULL;
+    ctx->out_ctr  = NULL;
+    ctx->out_hdr  = NULL;
+    ctx->out_len  = NULL;
+    ctx->out_iv   = NULL;
+    ctx->out_msg  = NULL;
+    ctx->released = true;
+
+    ProCountBuffers_i(ctx, 0, -RECORD_BUFFER_BYTES);
+
+    return (true);
+}
+
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslCtx_AcquireBuffers(PRO_SSL_CTX* ctx)
+{
+    assert(ctx != NULL);
+    if (ctx == NULL)
+    {
+        return (false);
+    }
+
+    if (!ctx->released)
+    {
+        return (true);
+    }
+
+    unsigned char* const inBuf  = (unsigned char*)ProCalloc(1, MBEDTLS_SSL_IN_BUFFER_LEN);
+    unsigned char* const outBuf = (unsigned char*)ProCalloc(1, MBEDTLS_SSL_OUT_BUFFER_LEN);
+    if (inBuf == NULL || outBuf == NULL)
+    {
+        ProFree(inBuf);
+        ProFree(outBuf);
+
+        return (false);
+    }
+
+    ctx->in_buf   = inBuf;
+    ctx->in_hdr   = inBuf + ctx->inHdrOffset;
+    ctx->in_ctr   = ctx->in_hdr - RECORD_CTR_BYTES;
+    ctx->in_len   = ctx->in_hdr + 3;
+    ctx->in_iv    = ctx->in_hdr + 5;
+    ctx->in_msg   = inBuf + ctx->inMsgOffset;
+    ctx->out_buf  = outBuf;
+    ctx->out_hdr  = outBuf + ctx->outHdrOffset;
+    ctx->out_ctr  = ctx->out_hdr - RECORD_CTR_BYTES;
+    ctx->out_len  = ctx->out_hdr + 3;
+    ctx->out_iv   = ctx->out_hdr + 5;
+    ctx->out_msg  = outBuf + ctx->outMsgOffset;
+    ctx->released = false;
+    memcpy(ctx->in_ctr , ctx->inCtr , RECORD_CTR_BYTES);
+    memcpy(ctx->out_ctr, ctx->outCtr, RECORD_CTR_BYTES);
+
+    ProCountBuffers_i(ctx, 0, RECORD_BUFFER_BYTES);
+
+    return (true);
+}
+
 PRO_NET_API
 PRO_SSL_SUITE_ID
 PRO_CALLTYPE
@@ -334,6 +334,125 @@ ProSslServerConfig_SetSniAuthLevel(PRO_SSL_SERVER_CONFIG* config,
                                    const char*            sniName,
                                    PRO_SSL_AUTH_LEVEL     level);
 
+/*
+ * : ûûỰƱ(RFC 5077)
+ *
+ * :
+ * config            : SSLö
+ * enable            : Ƿ
+ * lifetimeInSeconds : ƱݵЧ(). 0ʾ86400
+ *
+ * ֵ: trueɹ, falseʧ
+ *
+ * ˵: Ĭ,ỰƱǽõ
+ *
+ *       ƱԿڴ,ÿЧֻһ,ֻǰԿȻ
+ *       δڵƱ. server,֮ǰǩƱȫʧЧ
+ */
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslServerConfig_EnableSessionTickets(PRO_SSL_SERVER_CONFIG* config,
+                                        bool                   enable,
+                                        unsigned long          lifetimeInSeconds); /* = 0 */
+
+/*
+ * : ûỰ
+ *
+ * :
+ * config           : SSLö
+ * maxEntries       : ĻỰ. 0ʾ
+ * timeoutInSeconds : ĻỰЧ(). 0ʾ86400
+ *
+ * ֵ: trueɹ, falseʧ
+ *
+ * ˵: Ĭ,Ựǽõ
+ *
+ *       Ự水ỰidָỰ,ڲֻ֧ỰƱݵclient
+ */
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslServerConfig_SetSessionCache(PRO_SSL_SERVER_CONFIG* config,
+                                   unsigned long          maxEntries,
+                                   unsigned long          timeoutInSeconds); /* = 0 */
+
+/*
+ * : ȡִ
+ *
+ * :
+ * config       : SSLö
+ * fullCount    : ֵĴ
+ * resumedCount : ָỰִ
+ *
+ * ֵ: 
+ *
+ * ˵: ֻͳͨProSslCtx_Handshake(...)ɵ
+ */
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslServerConfig_GetHandshakeCounts(const PRO_SSL_SERVER_CONFIG* config,
+                                      PRO_UINT64*                  fullCount,     /* = NULL */
+                                      PRO_UINT64*                  resumedCount); /* = NULL */
+
+/*
+ * : ǷSSL¼շ
+ *
+ * :
+ * config : SSLö
+ * enable : Ƿ
+ *
+ * ֵ: 
+ *
+ * ˵: ÿSSLĹ̶ռԼ33KBļ¼(շ16KB).ú,
+ *       ӿ(ûδļ¼δ)ʱͷŻ,շʱٷ,
+ *       ʺϴڿе.ÿοкָշʱһη.
+ *       ȱʡ.μProSslCtx_ReleaseBuffers(...)
+ */
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslServerConfig_EnableDynamicBuffers(PRO_SSL_SERVER_CONFIG* config,
+                                        bool                   enable);
+
+/*
+ * : SSL¼Ƭ(max_fragment_length, RFC6066)
+ *
+ * :
+ * config            : SSLö
+ * maxFragmentLength : 512, 1024, 2048, 4096, 0ʾ(16KB)
+ *
+ * ֵ: trueɹ, falseʧ
+ *
+ * ˵: ˽ܿͻķƬ,ֻƱ˷ļ¼.
+ *       ȱʡ
+ */
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslServerConfig_SetMaxFragmentLength(PRO_SSL_SERVER_CONFIG* config,
+                                        unsigned long          maxFragmentLength);
+
+/*
+ * : ȡSSLĸ¼ֽ
+ *
+ * :
+ * config      : SSLö
+ * ctxCount    : ʹøõSSLĸ
+ * bufferBytes : Щĵǰռõļ¼ֽ
+ *
+ * ֵ: 
+ *
+ * ˵: bufferBytes/ctxCountÿӵļ¼
+ */
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslServerConfig_GetBufferInfo(const PRO_SSL_SERVER_CONFIG* config,
+                                 PRO_UINT64*                  ctxCount,     /* = NULL */
+                                 PRO_UINT64*                  bufferBytes); /* = NULL */
+
 /*-------------------------------------------------------------------------*/
 
 /*
@@ -486,6 +605,104 @@ PRO_CALLTYPE
 ProSslClientConfig_SetAuthLevel(PRO_SSL_CLIENT_CONFIG* config,
                                 PRO_SSL_AUTH_LEVEL     level);
 
+/*
+ * : ûûỰ
+ *
+ * :
+ * config : SSLö
+ * enable : Ƿ
+ *
+ * ֵ: 
+ *
+ * ˵: Ĭ,Ựǽõ
+ *
+ *       ú,ֳɹĻỰ(serverǩƱ)server
+ *       ö. ProSslCtx_Createc(...)Ϊͬһserverʱ,
+ *       ָûỰ.ûserverʱ,serverip:˿ڱ
+ */
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslClientConfig_EnableSessionReuse(PRO_SSL_CLIENT_CONFIG* config,
+                                      bool                   enable);
+
+/*
+ * : ȡִ
+ *
+ * :
+ * config       : SSLö
+ * fullCount    : ֵĴ
+ * resumedCount : ָỰִ
+ *
+ * ֵ: 
+ *
+ * ˵: ֻͳͨProSslCtx_Handshake(...)ɵ
+ */
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslClientConfig_GetHandshakeCounts(const PRO_SSL_CLIENT_CONFIG* config,
+                                      PRO_UINT64*                  fullCount,     /* = NULL */
+                                      PRO_UINT64*                  resumedCount); /* = NULL */
+
+/*
+ * : ǷSSL¼շ
+ *
+ * :
+ * config : SSLö
+ * enable : Ƿ
+ *
+ * ֵ: 
+ *
+ * ˵: ÿSSLĹ̶ռԼ33KBļ¼(շ16KB).ú,
+ *       ӿ(ûδļ¼δ)ʱͷŻ,շʱٷ,
+ *       ʺϴڿе.ÿοкָշʱһη.
+ *       ȱʡ.μProSslCtx_ReleaseBuffers(...)
+ */
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslClientConfig_EnableDynamicBuffers(PRO_SSL_CLIENT_CONFIG* config,
+                                        bool                   enable);
+
+/*
+ * : SSL¼Ƭ(max_fragment_length, RFC6066)
+ *
+ * :
+ * config            : SSLö
+ * maxFragmentLength : 512, 1024, 2048, 4096, 0ʾ(16KB)
+ *
+ * ֵ: trueɹ, falseʧ
+ *
+ * ˵: ͻ÷Ƭ,ͬ˫ļ¼ó,
+ *       Զ(Ƕʽ豸)ʹýСļ¼.
+ *       ȱʡ
+ */
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslClientConfig_SetMaxFragmentLength(PRO_SSL_CLIENT_CONFIG* config,
+                                        unsigned long          maxFragmentLength);
+
+/*
+ * : ȡSSLĸ¼ֽ
+ *
+ * :
+ * config      : SSLö
+ * ctxCount    : ʹøõSSLĸ
+ * bufferBytes : Щĵǰռõļ¼ֽ
+ *
+ * ֵ: 
+ *
+ * ˵: bufferBytes/ctxCountÿӵļ¼
+ */
+PRO_NET_API
+void
+PRO_CALLTYPE
+ProSslClientConfig_GetBufferInfo(const PRO_SSL_CLIENT_CONFIG* config,
+                                 PRO_UINT64*                  ctxCount,     /* = NULL */
+                                 PRO_UINT64*                  bufferBytes); /* = NULL */
+
 /*-------------------------------------------------------------------------*/
 
 /*
@@ -551,6 +768,70 @@ void
 PRO_CALLTYPE
 ProSslCtx_Delete(PRO_SSL_CTX* ctx);
 
+/*
+ * : ִSSL/TLS
+ *
+ * :
+ * ctx : SSLĶ
+ *
+ * ֵ: 0ʾ,ͬmbedtls_ssl_handshake(...)
+ *
+ * ˵: ÷ͬmbedtls_ssl_handshake(...).,úͳֺͻָ
+ *       ỰĴ,ΪûỰõclientֳɹĻỰ
+ */
+PRO_NET_API
+int
+PRO_CALLTYPE
+ProSslCtx_Handshake(PRO_SSL_CTX* ctx);
+
+/*
+ * : Ƿָ֮ǰĻỰ
+ *
+ * :
+ * ctx : SSLĶ
+ *
+ * ֵ: trueָ˻Ự, false
+ *
+ * ˵: SSL/TLSɺ
+ */
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslCtx_IsResumed(PRO_SSL_CTX* ctx);
+
+/*
+ * : ͷSSLĵļ¼
+ *
+ * :
+ * ctx : SSLĶ
+ *
+ * ֵ: trueͷ, falseδðӲ
+ *
+ * ˵: Ҫ˰.ͷʱ¼,û״̬.
+ *       ͷźmbedtls_ssl_read/write/close_notify(...)֮ǰ,
+ *       ȵProSslCtx_AcquireBuffers(...).
+ *       CProSslTransportշĿеԶ,ʹһ㲻Ҫֱӵ
+ */
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslCtx_ReleaseBuffers(PRO_SSL_CTX* ctx);
+
+/*
+ * : ·SSLĵļ¼
+ *
+ * :
+ * ctx : SSLĶ
+ *
+ * ֵ: trueɹ(δͷŵ), falseڴ治
+ *
+ * ˵: μProSslCtx_ReleaseBuffers(...)
+ */
+PRO_NET_API
+bool
+PRO_CALLTYPE
+ProSslCtx_AcquireBuffers(PRO_SSL_CTX* ctx);
+
 /*
  * : ȡc/sЭ̵ĻỰ׼
  *
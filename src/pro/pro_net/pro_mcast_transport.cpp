@@ -35,15 +35,17 @@
 ////
 
 CProMcastTransport*
-CProMcastTransport::CreateInstance(size_t recvPoolSize)     /* = 0 */
+CProMcastTransport::CreateInstance(bool   batchUpcall,
+                                   size_t recvPoolSize) /* = 0 */
 {
-    CProMcastTransport* const trans = new CProMcastTransport(recvPoolSize);
+    CProMcastTransport* const trans = new CProMcastTransport(batchUpcall, recvPoolSize);
 
     return (trans);
 }
 
-CProMcastTransport::CProMcastTransport(size_t recvPoolSize) /* = 0 */
-: CProUdpTransport(recvPoolSize)
+CProMcastTransport::CProMcastTransport(bool   batchUpcall,
+                                       size_t recvPoolSize) /* = 0 */
+: CProUdpTransport(batchUpcall, recvPoolSize)
 {
 }
 
@@ -181,6 +183,17 @@ CProMcastTransport::Init(IProTransportObserver* observer,
         option = 0;
         pbsd_setsockopt(sockId, IPPROTO_IP, IP_MULTICAST_LOOP, &option, sizeof(int));
 
+        if (!InitBatch_i(sockId, reactorTask))
+        {
+            pbsd_setsockopt(
+                sockId, IPPROTO_IP, IP_DROP_MEMBERSHIP, &mreq, sizeof(struct ip_mreq));
+            ProCloseSockId(sockId);
+
+            return (false);
+        }
+
+        SetEdgeTriggered(reactorTask->IsEdgeTriggered());
+
         if (!reactorTask->AddHandler(sockId, this, PRO_MASK_READ))
         {
             pbsd_setsockopt(
@@ -214,7 +227,7 @@ CProMcastTransport::Fini()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
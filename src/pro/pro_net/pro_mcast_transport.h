@@ -28,7 +28,10 @@ class CProMcastTransport : public CProUdpTransport
 {
 public:
 
-    static CProMcastTransport* CreateInstance(size_t recvPoolSize); /* = 0 */
+    static CProMcastTransport* CreateInstance(
+        bool   batchUpcall,
+        size_t recvPoolSize /* = 0 */
+        );
 
     bool Init(
         IProTransportObserver* observer,
@@ -50,7 +53,10 @@ public:
 
 private:
 
-    CProMcastTransport(size_t recvPoolSize); /* = 0 */
+    CProMcastTransport(
+        bool   batchUpcall,
+        size_t recvPoolSize /* = 0 */
+        );
 
     virtual ~CProMcastTransport();
 };
@@ -91,11 +91,21 @@ IProReactor*
 PRO_CALLTYPE
 ProCreateReactor(unsigned long ioThreadCount,
                  long          ioThreadPriority) /* = 0 */
+{
+    return (ProCreateReactorEx(ioThreadCount, ioThreadPriority, NULL));
+}
+
+PRO_NET_API
+IProReactor*
+PRO_CALLTYPE
+ProCreateReactorEx(unsigned long              ioThreadCount,
+                   long                       ioThreadPriority, /* = 0 */
+                   const PRO_REACTOR_OPTIONS* options)          /* = NULL */
 {
     ProNetInit();
 
     CProTpReactorTask* const reactorTask = new CProTpReactorTask;
-    if (!reactorTask->Start(ioThreadCount, ioThreadPriority))
+    if (!reactorTask->Start(ioThreadCount, ioThreadPriority, options))
     {
         delete reactorTask;
 
@@ -425,7 +435,39 @@ ProCreateUdpTransport(IProTransportObserver* observer,
 {
     ProNetInit();
 
-    CProUdpTransport* const trans = CProUdpTransport::CreateInstance(recvPoolSize);
+    CProUdpTransport* const trans = CProUdpTransport::CreateInstance(false, recvPoolSize);
+    if (trans == NULL)
+    {
+        return (NULL);
+    }
+
+    if (!trans->Init(observer, (CProTpReactorTask*)reactor, localIp, localPort,
+        defaultRemoteIp, defaultRemotePort, sockBufSizeRecv, sockBufSizeSend))
+    {
+        trans->Release();
+
+        return (NULL);
+    }
+
+    return (trans);
+}
+
+PRO_NET_API
+IProTransport*
+PRO_CALLTYPE
+ProCreateUdpTransportEx(IProTransportBatchObserver* observer,
+                        IProReactor*                reactor,
+                        const char*                 localIp,           /* = NULL */
+                        unsigned short              localPort,         /* = 0 */
+                        size_t                      sockBufSizeRecv,   /* = 0 */
+                        size_t                      sockBufSizeSend,   /* = 0 */
+                        size_t                      recvPoolSize,      /* = 0 */
+                        const char*                 defaultRemoteIp,   /* = NULL */
+                        unsigned short              defaultRemotePort) /* = 0 */
+{
+    ProNetInit();
+
+    CProUdpTransport* const trans = CProUdpTransport::CreateInstance(true, recvPoolSize);
     if (trans == NULL)
     {
         return (NULL);
@@ -456,7 +498,38 @@ ProCreateMcastTransport(IProTransportObserver* observer,
 {
     ProNetInit();
 
-    CProMcastTransport* const trans = CProMcastTransport::CreateInstance(recvPoolSize);
+    CProMcastTransport* const trans = CProMcastTransport::CreateInstance(false, recvPoolSize);
+    if (trans == NULL)
+    {
+        return (NULL);
+    }
+
+    if (!trans->Init(observer, (CProTpReactorTask*)reactor, mcastIp, mcastPort,
+        localBindIp, sockBufSizeRecv, sockBufSizeSend))
+    {
+        trans->Release();
+
+        return (NULL);
+    }
+
+    return (trans);
+}
+
+PRO_NET_API
+IProTransport*
+PRO_CALLTYPE
+ProCreateMcastTransportEx(IProTransportBatchObserver* observer,
+                          IProReactor*                reactor,
+                          const char*                 mcastIp,
+                          unsigned short              mcastPort,       /* = 0 */
+                          const char*                 localBindIp,     /* = NULL */
+                          size_t                      sockBufSizeRecv, /* = 0 */
+                          size_t                      sockBufSizeSend, /* = 0 */
+                          size_t                      recvPoolSize)    /* = 0 */
+{
+    ProNetInit();
+
+    CProMcastTransport* const trans = CProMcastTransport::CreateInstance(true, recvPoolSize);
     if (trans == NULL)
     {
         return (NULL);
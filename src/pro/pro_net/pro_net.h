@@ -197,6 +197,7 @@ class  IProServiceHost;   /* 
 class  IProServiceHub;    /* hub */
 class  IProSslHandshaker; /* ssl */
 class  IProTcpHandshaker; /* tcp */
+class  IProTransport;     /*  */
 struct pbsd_sockaddr_in;  /* ׽ֵַ */
 
 /*
@@ -212,6 +213,50 @@ static const PRO_TRANS_TYPE PRO_TRANS_SSL   = 11;
  * ]]]]
  */
 
+/*
+ * ڵcpu. please refer to PRO_REACTOR_OPTIONS::flowCpu
+ */
+typedef long (PRO_CALLTYPE* PRO_FLOW_CPU_FUNC)(PRO_INT64 sockId);
+
+/*
+ * Ӧѡ. ȫ0ʾȱʡֵ
+ *
+ * please refer to "pro_net/pro_tp_reactor_task.h"
+ */
+struct PRO_REACTOR_OPTIONS
+{
+    bool              timingWheel;   /* ʱʹ÷ֲʱ(O(1)Ĵ/ɾ),ȱʡΪfalse */
+    bool              reactorTimers; /* ڲշĶʱշ߳лص(timerfd),ȱʡΪfalse */
+    bool              edgeTriggered; /* շԱشʽ(EPOLLET)ע,ÿλѶȡEAGAINﵽ,ȱʡΪfalse.epollЧ */
+    bool              shardedAccept; /* ÿշ߳иһSO_REUSEPORT׽,ȱʡΪfalse.֧SO_REUSEPORTϵͳЧ */
+    bool              directWrite;   /* tcp/sslSendData(...)ڷͳΪʱֱӷ,ֻΪʣעд¼,ȱʡΪfalse */
+    bool              udpOffload;    /* udp/mcastUDP_SEGMENT()UDP_GRO(),ȱʡΪfalse.ֵ֧LinuxںЧ */
+    bool              ioUring;       /* Ӧʹio_uring(poll)epoll,ں˲֧ʱԶ˻epoll,ȱʡΪfalse.LinuxЧ */
+    bool              cpuAffinity;   /* շ̰߳numaڵ˳һ(߳),ȱʡΪfalse.Linux/WindowsЧ */
+    bool              loadBalance;   /* շ̵߳cpuʱµ,߳ϵǨƵ߳,ȱʡΪfalse */
+    bool              incomingCpu;   /* ܵӰSO_INCOMING_CPU䵽󶨸cpuշ߳,ҪioCpuscpuAffinity,ȱʡΪfalse.LinuxЧ */
+    bool              sockBusyPoll;  /* շ׽SO_BUSY_POLL(ֵΪbusyPollUs),ҪCAP_NET_ADMIN,ȱʡΪfalse.LinuxЧ */
+    unsigned long     sendQueueSize; /* tcp/sslͶеֽˮλ.0ʾÿֻһδɵķ,ȱʡΪ0 */
+    unsigned long     udpBatchSize;  /* udp/mcastÿrecvmmsg()ȡݱ.0ʾȡ,ȱʡΪ0.LinuxЧ,1472ֽڵݱ(UDP_GRO) */
+    unsigned long     busyPollUs;    /* շ߳¼ѯ΢,֮Ž˯.0ʾѯ,ȱʡΪ0.epoll/io_uringЧ */
+    unsigned long     sslCryptoThreads; /* sslֵ֤֤Կڸøļ߳н,շֻ߳շ.0ʾշ߳н,ȱʡΪ0 */
+    unsigned long     sslMaxHandshakes; /* ڼ߳Ŷӻִеָ,շ߳н.0ʾ1024,ȱʡΪ0 */
+    const long*       ioCpus;        /* ÿշ̰߳󶨵cpu,ioThreadCount.cpuAffinity,С0̲߳,ȱʡΪNULL */
+    PRO_FLOW_CPU_FUNC flowCpu;       /* ׽ֵڵcpu(簴RSSĹϣ),-1ʾδ֪.incomingCpu,ȱʡΪNULL */
+};
+
+/*
+ * ͵ݱ
+ *
+ * please refer to IProTransport::SendDataBatch(...)
+ */
+struct PRO_DATAGRAM
+{
+    const void*             buf;
+    size_t                  size;
+    const pbsd_sockaddr_in* remoteAddr; /* NULLʾĬϵԶ˵ַ */
+};
+
 #include "pro_mbedtls.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -309,6 +354,36 @@ public:
      * ȡ״̬Ϣַ
      */
     virtual void PRO_CALLTYPE GetTraceInfo(char* buf, size_t size) const = 0;
+
+    /*
+     * Ͷһ,շ߳̾صһonTimer->OnTimer(taskId, userData)
+     *
+     * timeSpanΪ0ͨʱͬ,񲻾ʱ߳,ͨ
+     * ֱӽշ߳,һֻصִ֮.շ߳Ͷʱ,ɵǰ
+     * ִ߳,շ߳.ɾ,ϲڻصи
+     * taskIdԹڵ.id붨ʱidظ
+     *
+     * ֵΪid. 0Ч
+     */
+    virtual unsigned long PRO_CALLTYPE PostTask(
+        IProOnTimer* onTimer,
+        PRO_INT64    userData = 0
+        ) = 0;
+
+    /*
+     * Ͷһ,ɴڵշ̻߳صһonTimer->OnTimer(taskId, userData)
+     *
+     * PostTask(...)ͬ,ǲӦȫ,Ҳ,
+     * շصͬһִ߳.δעᵽշ߳ʱ,
+     * PostTask(...)ͬ
+     *
+     * ֵΪid. 0Ч
+     */
+    virtual unsigned long PRO_CALLTYPE PostTaskToTransport(
+        IProTransport* trans,
+        IProOnTimer*   onTimer,
+        PRO_INT64      userData = 0
+        ) = 0;
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -513,7 +588,10 @@ public:
  * ׽ݿɶ(ǹ),ճӦþڳõĿռ
  *
  * udp/mcast,ʹԽճ.
- * Ϊֹճؿռ䲻㵼EMSGSIZE,OnRecv(...)Ӧȫ
+ * Ϊֹճؿռ䲻㵼EMSGSIZE,OnRecv(...)Ӧȫ.
+ * PRO_REACTOR_OPTIONS::udpBatchSize,һλѻȡݱ
+ * (UDP_GROϲݱҲᱻ),ȻճزصOnRecv(...);
+ * صĴʹýճ,μIProTransportBatchObserver
  */
 class IProRecvPool
 {
@@ -535,6 +613,41 @@ public:
      * ڳռ,Աµ
      */
     virtual void PRO_CALLTYPE Flush(size_t size) = 0;
+
+    /*
+     * ѯճڵڴ,
+     *
+     * ͽճڵΪ:buf1ǿǰһ,buf2ǻƵճ
+     * ͷһ(ûлʱΪNULL,size2Ϊ0);Խճڵֻһ.
+     * ûʱ,buf1buf2ΪNULL.صָFlush(...)OnRecv(...)
+     * ֮ǰЧ,ֻܶȡ
+     *
+     * ʹ߿ֱڽճڽ,ֻƿԽεĲ
+     */
+    virtual void PRO_CALLTYPE PeekSegments(
+        const void**   buf1,
+        unsigned long* size1,
+        const void**   buf2,
+        unsigned long* size2
+        ) const = 0;
+};
+
+/*
+ * üķͻ
+ *
+ * IProTransport::SendBuffer(...).,ֱеݷ
+ * ,Ӷ⸴;ͬһͬʱ.ͷһ
+ * ֮ǰ,ڵݲܱ޸
+ *
+ * Release()ڷӦ߳ﱻ,ʱӦٲô
+ */
+class IProSendBuffer
+{
+public:
+
+    virtual unsigned long PRO_CALLTYPE AddRef() = 0;
+
+    virtual unsigned long PRO_CALLTYPE Release() = 0;
 };
 
 /*
@@ -598,6 +711,14 @@ public:
      * ظֵ
      *
      * false,ʾæ,ϲӦûԴOnSend(...)صȡ
+     *
+     * PRO_REACTOR_OPTIONS::sendQueueSize,tcp/sslͶ
+     * ,ֱδ͵ֽˮλ.ÿݷɺ,ص
+     * һOnSend(...)actionId
+     *
+     * PRO_REACTOR_OPTIONS::directWrite,tcp/sslڷͳΪʱֱ
+     * .ʹѾȫ, OnSend(...)ȻڷӦ߳
+     * ˳ص,SendData(...)ڲص
      */
     virtual bool PRO_CALLTYPE SendData(
         const void*             buf,
@@ -648,6 +769,40 @@ public:
     virtual unsigned long PRO_CALLTYPE AddRef() = 0;
 
     virtual unsigned long PRO_CALLTYPE Release() = 0;
+
+    /*
+     * üĻڵ
+     *
+     * [buf, buf + size)λsendBufеڴ.tcp/ssl,
+     * sendBufһ,ֱݷ;udp/mcastֱӷ,
+     * .ͷֵSendData(...)ͬ
+     *
+     * μIProSendBufferע
+     */
+    virtual bool PRO_CALLTYPE SendBuffer(
+        IProSendBuffer*         sendBuf,
+        const void*             buf,
+        size_t                  size,
+        PRO_UINT64              actionId   = 0,
+        const pbsd_sockaddr_in* remoteAddr = NULL /* for udp */
+        ) = 0;
+
+    /*
+     * ݱ(for CProUdpTransport and CProMcastTransport only)
+     *
+     * ֧sendmmsg()ϵͳ,һϵͳ÷Ͷݱ;
+     * PRO_REACTOR_OPTIONS::udpOffloadں֧UDP_SEGMENT,ͬһַ
+     * ȳݱϲΪһGSO.Զ˵ַЧݱʹĬϵ
+     * Զ˵ַ
+     *
+     * ݱֻӦһͶ, OnSend(...)صʱactionId.
+     * ֵSendData(...)ͬ.tcp/sslǷfalse
+     */
+    virtual bool PRO_CALLTYPE SendDataBatch(
+        const PRO_DATAGRAM* datagrams,
+        size_t              count,
+        PRO_UINT64          actionId = 0
+        ) = 0;
 };
 
 /*
@@ -697,6 +852,31 @@ public:
     virtual void PRO_CALLTYPE OnHeartbeat(IProTransport* trans) = 0;
 };
 
+/*
+ * յĴصĿ(for CProUdpTransport and CProMcastTransport only)
+ *
+ * ʹProCreateUdpTransportEx(...)ProCreateMcastTransportEx(...),
+ * PRO_REACTOR_OPTIONS::udpBatchSizeʱ,һrecvmmsg()ݱ
+ * ƵճزصOnRecv(...),һνOnRecvBatch(...).
+ * ϵͳ֧recvmmsg()ȡʱ,ȻصOnRecv(...)
+ */
+class IProTransportBatchObserver : public IProTransportObserver
+{
+public:
+
+    /*
+     * һݱִʱ,úص
+     *
+     * datagrams[i].bufָӦĽղλ,ֻڻصڼЧ,ֻܶȡ.
+     * UDP_GROϲݱѾ. datagrams[i].remoteAddrΪNULL
+     */
+    virtual void PRO_CALLTYPE OnRecvBatch(
+        IProTransport*      trans,
+        const PRO_DATAGRAM* datagrams,
+        size_t              count
+        ) = 0;
+};
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -752,6 +932,74 @@ PRO_CALLTYPE
 ProCreateReactor(unsigned long ioThreadCount,
                  long          ioThreadPriority = 0);
 
+/*
+ * : һѡķӦ
+ *
+ * :
+ * ioThreadCount    : շ¼߳
+ * ioThreadPriority : շ̵߳ȼ(0/1/2)
+ * options          : Ӧѡ.ΪNULL
+ *
+ * ֵ: ӦNULL
+ *
+ * ˵: optionsΪNULLʱ,ProCreateReactor(...)ͬ
+ *
+ *       ʱ޴ʱ(),options->timingWheel
+ *
+ *       ӷæʱ,options->edgeTriggeredԼepoll_wait()epoll_ctl()Ĵ
+ *
+ *       ½ܼʱ,options->shardedAccept.ʱں˽ӷɢ
+ *       շ߳,ڽշ߳ɺշ
+ *
+ *       СϢܼʱ,options->sendQueueSize.ʱtcp/sslŶӵ
+ *       ݺϲһwritev()з
+ *
+ *       /Ӧȶʱеĳ,options->directWrite.ʱtcp/ssl
+ *       ڵߵֱ߳ӷ,صȴӦд¼
+ *
+ *       udpܴʱ(ýת),options->udpBatchSizeoptions->udpOffload.
+ *       ʱudp/mcastʹrecvmmsg(), SendDataBatch(...)ʹsendmmsg()
+ *       GSO.ÿշ߳udpBatchSizeղλ,ɸ̵߳udp/mcast
+ *       ,ÿλmtu1472ֽ(UDP_GROʱΪ64Kֽ),
+ *       2Mֽ.ʱ,λݱ.ʹProCreateUdpTransportEx(...)
+ *       ProCreateMcastTransportEx(...)Ĵ,һݱֻصһ
+ *
+ *       options->ioUringʹio_uringӦ.epollӦͬ,
+ *       pollı͵ȴϲһio_uring_enter()ύ.ʵʹõķӦ
+ *       μGetTraceInfo(...)
+ *
+ *       ·,options->ioCpusoptions->cpuAffinityշ߳
+ *       󶨵cpu.ÿշӦcpuϴ,ڴӱnumaڵ;ճ
+ *       շ߳״д,Ҳλڱؽڵ.߳Ϊpro_accept, pro_io_N, pro_timer
+ *       pro_mm_timer,ps/top/perf
+ *
+ *       (Ƶ)ʹĳշ߳.ʱoptions->loadBalance,
+ *       Ӧÿշ̵߳cpuʱ,µӷ䵽͵߳,
+ *       λص֮佫߳ϵ(䶨ʱ)ǨƵϿе߳
+ *
+ *       RSSɢʱ,ڰcpuĻoptions->incomingCpu
+ *       options->flowCpu,ʹɽݰcpuϵշ̴߳.޷ȷcpu
+ *       cpuûշ߳ʱ,ԭеĲԷ.shardedAcceptʱ,ÿƬ
+ *       ׽ҲSO_INCOMING_CPU,ںѡͬһcpuϵķƬ.flowCpuڲ
+ *       ,ܵ÷Ӧķ
+ *
+ *       ʱӼcpuĳ,options->busyPollUs.շ߳ÿ
+ *       һ¼,ڸʱ䴰epoll_wait(0)ѯ˯,ʡȥѵĵʱ,
+ *       ǿʱռcpu.options->sockBusyPollʱ,ںڶ׽ʱҲ
+ *       ѯ(SO_BUSY_POLL).ѯĴμGetTraceInfo(...)
+ *
+ *       sslӽ϶ʱ,options->sslCryptoThreads.кʱ֤֤
+ *       ԿͶݵִ߳,ɺصշ̼߳,
+ *       ͬһ߳ӵշ.еĳ,ֵĳɹ/ʧʱӲμ
+ *       GetTraceInfo(...)
+ */
+PRO_NET_API
+IProReactor*
+PRO_CALLTYPE
+ProCreateReactorEx(unsigned long              ioThreadCount,
+                   long                       ioThreadPriority = 0,
+                   const PRO_REACTOR_OPTIONS* options          = NULL);
+
 /*
  * : ɾһӦ
  *
@@ -1076,6 +1324,28 @@ ProCreateUdpTransport(IProTransportObserver* observer,
                       const char*            defaultRemoteIp   = NULL,
                       unsigned short         defaultRemotePort = 0);
 
+/*
+ * : һصudp
+ *
+ * : ProCreateUdpTransport(...)ͬ
+ *
+ * ֵ: NULL
+ *
+ * ˵: μIProTransportBatchObserver
+ */
+PRO_NET_API
+IProTransport*
+PRO_CALLTYPE
+ProCreateUdpTransportEx(IProTransportBatchObserver* observer,
+                        IProReactor*                reactor,
+                        const char*                 localIp           = NULL,
+                        unsigned short              localPort         = 0,
+                        size_t                      sockBufSizeRecv   = 0,
+                        size_t                      sockBufSizeSend   = 0,
+                        size_t                      recvPoolSize      = 0,
+                        const char*                 defaultRemoteIp   = NULL,
+                        unsigned short              defaultRemotePort = 0);
+
 /*
  * : һಥ
  *
@@ -1109,6 +1379,27 @@ ProCreateMcastTransport(IProTransportObserver* observer,
                         size_t                 sockBufSizeSend = 0,
                         size_t                 recvPoolSize    = 0);
 
+/*
+ * : һصĶಥ
+ *
+ * : ProCreateMcastTransport(...)ͬ
+ *
+ * ֵ: NULL
+ *
+ * ˵: μIProTransportBatchObserver
+ */
+PRO_NET_API
+IProTransport*
+PRO_CALLTYPE
+ProCreateMcastTransportEx(IProTransportBatchObserver* observer,
+                          IProReactor*                reactor,
+                          const char*                 mcastIp,
+                          unsigned short              mcastPort       = 0,
+                          const char*                 localBindIp     = NULL,
+                          size_t                      sockBufSizeRecv = 0,
+                          size_t                      sockBufSizeSend = 0,
+                          size_t                      recvPoolSize    = 0);
+
 /*
  * : һssl
  *
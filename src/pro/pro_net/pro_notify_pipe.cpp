@@ -19,10 +19,18 @@
 #include "pro_notify_pipe.h"
 #include "../pro_util/pro_bsd_wrapper.h"
 #include "../pro_util/pro_memory_pool.h"
-#include "../pro_util/pro_time_util.h"
+#include "../pro_util/pro_thread_mutex.h"
 #include "../pro_util/pro_z.h"
 #include <cassert>
 
+#if defined(WIN32) || defined(_WIN32_WCE)
+#include <windows.h>
+#endif
+
+#if defined(PRO_HAS_EPOLL)
+#include <sys/eventfd.h>
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -34,10 +42,12 @@
 
 CProNotifyPipe::CProNotifyPipe()
 {
-    m_sockIds[0]   = -1;
-    m_sockIds[1]   = -1;
-    m_enableNotify = true;
-    m_notifyTick   = 0;
+    m_sockIds[0]     = -1;
+    m_sockIds[1]     = -1;
+    m_sleeping       = 0;
+    m_pending        = 0;
+    m_wakeupCount    = 0;
+    m_coalescedCount = 0;
 }
 
 CProNotifyPipe::~CProNotifyPipe()
@@ -96,6 +106,22 @@ CProNotifyPipe::Init()
     m_sockIds[0] = sockId;
     m_sockIds[1] = sockId;
 
+#elif defined(PRO_HAS_EPOLL)
+
+    /*
+     * one descriptor for both ends, and no socket buffers
+     */
+    const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    m_sockIds[0] = fd;
+    m_sockIds[1] = fd;
+
+    return;
+
 #else  /* WIN32, _WIN32_WCE */
 
     PRO_INT64 sockIds[2] = { -1, -1 };
@@ -126,15 +152,20 @@ CProNotifyPipe::Fini()
 {
 #if defined(WIN32) || defined(_WIN32_WCE)
     pbsd_closesocket(m_sockIds[0]);
+#elif defined(PRO_HAS_EPOLL)
+    if (m_sockIds[0] != -1)
+    {
+        close((int)m_sockIds[0]);
+    }
 #else
     pbsd_closesocket(m_sockIds[0]);
     pbsd_closesocket(m_sockIds[1]);
 #endif
 
-    m_sockIds[0]   = -1;
-    m_sockIds[1]   = -1;
-    m_enableNotify = true;
-    m_notifyTick   = 0;
+    m_sockIds[0] = -1;
+    m_sockIds[1] = -1;
+    m_sleeping   = 0;
+    m_pending    = 0;
 }
 
 PRO_INT64
@@ -149,11 +180,62 @@ CProNotifyPipe::GetWriterSockId() const
     return (m_sockIds[1]);
 }
 
+bool
+CProNotifyPipe::BeginWait()
+{
+    Exchange_i(&m_sleeping, 1);
+
+    /*
+     * a notifier saw us awake and skipped the write, so take the sleep
+     * back. if it's too late, the write is on the way
+     */
+    if (m_pending != 0 && CompareExchange_i(&m_sleeping, 0, 1) == 1)
+    {
+        return (false);
+    }
+
+    return (true);
+}
+
 void
-CProNotifyPipe::EnableNotify()
+CProNotifyPipe::EndWait()
 {
-    m_enableNotify = true;
-    m_notifyTick   = 0;
+    /*
+     * clear "m_pending" before the reactor looks at its state, so a later
+     * notification keeps it set for the next BeginWait()
+     */
+    Exchange_i(&m_sleeping, 0);
+    Exchange_i(&m_pending , 0);
+}
+
+bool
+CProNotifyPipe::Drain()
+{
+    const PRO_INT64 sockId = GetReaderSockId();
+    if (sockId == -1)
+    {
+        return (false);
+    }
+
+#if !defined(WIN32) && !defined(_WIN32_WCE) && defined(PRO_HAS_EPOLL)
+
+    PRO_UINT64 value = 0;
+    const int  retc  = (int)read((int)sockId, &value, sizeof(PRO_UINT64));
+
+    return (retc == (int)sizeof(PRO_UINT64) || (retc < 0 && errno == EAGAIN));
+
+#else
+
+    char      buf[64];
+    const int recvSize = pbsd_recv(sockId, buf, sizeof(buf), 0); /* connected */
+
+    return (
+        recvSize > 0 && recvSize <= (int)sizeof(buf)
+        ||
+        recvSize < 0 && pbsd_errno((void*)&pbsd_recv) == PBSD_EWOULDBLOCK
+        );
+
+#endif
 }
 
 void
@@ -165,20 +247,83 @@ CProNotifyPipe::Notify()
         return;
     }
 
-    PRO_INT64 tick = 0;
-    if (!m_enableNotify)
+    Exchange_i(&m_pending, 1);
+
+    /*
+     * only the first notifier of a sleep cycle writes
+     */
+    if (CompareExchange_i(&m_sleeping, 0, 1) != 1)
     {
-        tick = ProGetTickCount64();
-        if (tick <= m_notifyTick)
-        {
-            return;
-        }
+        Increment_i(&m_coalescedCount);
+
+        return;
     }
 
+#if !defined(WIN32) && !defined(_WIN32_WCE) && defined(PRO_HAS_EPOLL)
+    const PRO_UINT64 value = 1;
+    write((int)sockId, &value, sizeof(PRO_UINT64));
+#else
     const char buf[] = { 0 };
-    if (pbsd_send(sockId, buf, sizeof(buf), 0) > 0) /* connected */
+    pbsd_send(sockId, buf, sizeof(buf), 0); /* connected */
+#endif
+
+    Increment_i(&m_wakeupCount);
+}
+
+long
+CProNotifyPipe::Exchange_i(volatile long* dest,
+                           long           value)
+{
+#if defined(WIN32) || defined(_WIN32_WCE)
+    return (::InterlockedExchange((long*)dest, value));
+#elif defined(PRO_HAS_ATOMOP)
+    __sync_synchronize();
+    const long oldValue = __sync_lock_test_and_set(dest, value); /* acquire only */
+    __sync_synchronize();
+
+    return (oldValue);
+#else
+    CProThreadMutexGuard mon(m_lockAtom);
+
+    const long oldValue = *dest;
+    *dest = value;
+
+    return (oldValue);
+#endif
+}
+
+long
+CProNotifyPipe::CompareExchange_i(volatile long* dest,
+                                  long           value,
+                                  long           comparand)
+{
+#if defined(WIN32) || defined(_WIN32_WCE)
+    return (::InterlockedCompareExchange((long*)dest, value, comparand));
+#elif defined(PRO_HAS_ATOMOP)
+    return (__sync_val_compare_and_swap(dest, comparand, value));
+#else
+    CProThreadMutexGuard mon(m_lockAtom);
+
+    const long oldValue = *dest;
+    if (oldValue == comparand)
     {
-        m_enableNotify = false;
-        m_notifyTick   = tick > 0 ? tick : ProGetTickCount64();
+        *dest = value;
     }
+
+    return (oldValue);
+#endif
+}
+
+void
+CProNotifyPipe::Increment_i(volatile long* dest)
+{
+#if defined(WIN32) || defined(_WIN32_WCE)
+    ::InterlockedIncrement((long*)dest);
+#elif defined(PRO_HAS_ATOMOP)
+    __sync_add_and_fetch(dest, 1);
+#else
+    CProThreadMutexGuard mon(m_lockAtom);
+
+    ++*dest;
+#endif
 }
@@ -20,10 +20,19 @@
 #define PRO_NOTIFY_PIPE_H
 
 #include "../pro_util/pro_memory_pool.h"
+#include "../pro_util/pro_thread_mutex.h"
 
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+/*
+ * the wakeup of a reactor. it's an eventfd on Linux, and a connected socket
+ * pair on the others.
+ *
+ * the reactor thread brackets its blocking wait with BeginWait()/EndWait(),
+ * and Notify() writes only if the reactor is sleeping, so the concurrent
+ * notifications in one sleep cycle are coalesced into a single write
+ */
 class CProNotifyPipe
 {
 public:
@@ -40,15 +49,60 @@ public:
 
     PRO_INT64 GetWriterSockId() const;
 
-    void EnableNotify();
+    /*
+     * returns false if a notification is pending, and the reactor shouldn't
+     * block this time
+     */
+    bool BeginWait();
 
+    void EndWait();
+
+    /*
+     * reads the pending wakeups in the reactor thread.
+     * returns false if the pipe is broken
+     */
+    bool Drain();
+
+    /*
+     * from any thread, with or without the reactor locked
+     */
     void Notify();
 
+    PRO_UINT64 GetWakeupCount() const
+    {
+        return ((unsigned long)m_wakeupCount);
+    }
+
+    PRO_UINT64 GetCoalescedCount() const
+    {
+        return ((unsigned long)m_coalescedCount);
+    }
+
+private:
+
+    long Exchange_i(
+        volatile long* dest,
+        long           value
+        );
+
+    long CompareExchange_i(
+        volatile long* dest,
+        long           value,
+        long           comparand
+        );
+
+    void Increment_i(volatile long* dest);
+
 private:
 
-    PRO_INT64 m_sockIds[2];
-    bool      m_enableNotify;
-    PRO_INT64 m_notifyTick;
+    PRO_INT64       m_sockIds[2];
+    volatile long   m_sleeping;
+    volatile long   m_pending;
+    volatile long   m_wakeupCount;    /* atomic. Notify() may run unlocked */
+    volatile long   m_coalescedCount; /* atomic. Notify() may run unlocked */
+#if !defined(WIN32) && !defined(_WIN32_WCE) && !defined(PRO_HAS_ATOMOP)
+    CProThreadMutex m_lockAtom;
+#endif
 
     DECLARE_SGI_POOL(0);
 };
@@ -20,6 +20,7 @@
 #define PRO_RECV_POOL_H
 
 #include "pro_net.h"
+#include "../pro_util/pro_bsd_wrapper.h"
 #include "../pro_util/pro_buffer.h"
 #include "../pro_util/pro_memory_pool.h"
 #include "../pro_util/pro_z.h"
@@ -93,34 +94,59 @@ public:
         return ((unsigned long)m_idleSize);
     }
 
-    void Fill(size_t size)
+    unsigned long IdleSize() const
+    {
+        return ((unsigned long)m_idleSize);
+    }
+
+    /*
+     * the idle space as up to two segments, for a scatter receive.
+     * it returns the number of the segments
+     */
+    int IdleSegments(pbsd_iovec iov[2]) const
     {
-        if (size == 0 || size > ContinuousIdleSize())
+        if (m_idleSize == 0)
         {
-            return;
+            return (0);
         }
 
-        if (m_data == NULL)
+        const size_t continuousSize = ContinuousIdleSize();
+
+        iov[0].iov_base = m_idle;
+        iov[0].iov_len  = continuousSize;
+
+        if (continuousSize == m_idleSize)
         {
-            m_data = m_idle;
+            return (1);
         }
 
-        m_dataSize += size;
+        iov[1].iov_base = m_begin;
+        iov[1].iov_len  = m_idleSize - continuousSize;
 
-        if (m_idleSize - size == 0)
+        return (2);
+    }
+
+    /*
+     * the size can be up to IdleSize(), when the data was received into
+     * the segments of IdleSegments(...)
+     */
+    void Fill(size_t size)
+    {
+        if (size == 0 || size > m_idleSize)
         {
-            m_idle = NULL;
+            return;
+        }
+
+        const size_t continuousSize = ContinuousIdleSize();
+        if (size > continuousSize)
+        {
+            Fill_i(continuousSize);
+            Fill_i(size - continuousSize);
         }
         else
         {
-            m_idle += size;
-            if (m_idle == m_end)
-            {
-                m_idle = m_begin;
-            }
+            Fill_i(size);
         }
-
-        m_idleSize -= size;
     }
 
     virtual unsigned long PRO_CALLTYPE PeekDataSize() const
@@ -191,8 +217,60 @@ public:
         m_dataSize -= size;
     }
 
+    virtual void PRO_CALLTYPE PeekSegments(
+        const void**   buf1,
+        unsigned long* size1,
+        const void**   buf2,
+        unsigned long* size2
+        ) const
+    {
+        const size_t continuousSize = m_dataSize > 0 ? ContinuousDataSize() : 0;
+
+        if (buf1 != NULL)
+        {
+            *buf1 = continuousSize > 0 ? m_data : NULL;
+        }
+        if (size1 != NULL)
+        {
+            *size1 = (unsigned long)continuousSize;
+        }
+        if (buf2 != NULL)
+        {
+            *buf2 = m_dataSize > continuousSize ? m_begin : NULL;
+        }
+        if (size2 != NULL)
+        {
+            *size2 = (unsigned long)(m_dataSize - continuousSize);
+        }
+    }
+
 private:
 
+    void Fill_i(size_t size)
+    {
+        if (m_data == NULL)
+        {
+            m_data = m_idle;
+        }
+
+        m_dataSize += size;
+
+        if (m_idleSize - size == 0)
+        {
+            m_idle = NULL;
+        }
+        else
+        {
+            m_idle += size;
+            if (m_idle == m_end)
+            {
+                m_idle = m_begin;
+            }
+        }
+
+        m_idleSize -= size;
+    }
+
     size_t ContinuousDataSize() const
     {
         if (m_data + m_dataSize > m_end)
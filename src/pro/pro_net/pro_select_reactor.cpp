@@ -28,11 +28,6 @@
 /////////////////////////////////////////////////////////////////////////////
 ////
 
-static char g_s_buffer[1024];
-
-/////////////////////////////////////////////////////////////////////////////
-////
-
 static
 inline
 bool
@@ -348,6 +343,8 @@ CProSelectReactor::WorkerRun()
 
     while (1)
     {
+        RunCommands();
+
         PRO_INT64 maxSockId = -1;
 
         {
@@ -367,10 +364,21 @@ CProSelectReactor::WorkerRun()
         /*
          * select(...)
          */
-        int retc = pbsd_select(maxSockId + 1, &m_fdsRd[1], &m_fdsWr[1], &m_fdsEx[1], NULL);
+        struct timeval  zero    = { 0, 0 };
+        struct timeval* timeout = NULL;
+        if (!m_notifyPipe->BeginWait())
+        {
+            timeout = &zero;
+        }
+
+        int retc = pbsd_select(maxSockId + 1, &m_fdsRd[1], &m_fdsWr[1], &m_fdsEx[1], timeout);
+        m_notifyPipe->EndWait();
         if (retc == 0)
         {
-            ProSleep(1);
+            if (timeout == NULL)
+            {
+                ProSleep(1);
+            }
             continue;
         }
 
@@ -600,6 +608,8 @@ CProSelectReactor::WorkerRun()
             }
         }
     } /* end of while (...) */
+
+    RunCommands(); /* the rest */
 }
 
 void
@@ -612,14 +622,12 @@ CProSelectReactor::OnInput(PRO_INT64 sockId)
         return;
     }
 
-    const int recvSize = pbsd_recv(sockId, g_s_buffer, sizeof(g_s_buffer), 0); /* connected */
-    if (recvSize > 0 && recvSize <= (int)sizeof(g_s_buffer)
-        ||
-        recvSize < 0 && pbsd_errno((void*)&pbsd_recv) == PBSD_EWOULDBLOCK)
+    if (sockId != m_notifyPipe->GetReaderSockId())
     {
-        m_notifyPipe->EnableNotify();
+        return;
     }
-    else
+
+    if (!m_notifyPipe->Drain())
     {
         OnError(sockId, -1);
     }
@@ -676,12 +684,10 @@ CProSelectReactor::OnError(PRO_INT64 sockId,
          */
         pbsd_fd_clr_i(sockId, m_fdsRd[0]);
         m_handlerMgr.RemoveHandler(sockId, PRO_MASK_READ);
-        delete m_notifyPipe;
-        m_notifyPipe = NULL;
 
         /*
          * register new
          */
-        m_notifyPipe = newPipe;
+        ReplaceNotifyPipe(newPipe);
     }
 }
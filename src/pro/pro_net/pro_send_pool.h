@@ -19,6 +19,8 @@
 #if !defined(PRO_SEND_POOL_H)
 #define PRO_SEND_POOL_H
 
+#include "pro_net.h"
+#include "../pro_util/pro_bsd_wrapper.h"
 #include "../pro_util/pro_buffer.h"
 #include "../pro_util/pro_memory_pool.h"
 #include "../pro_util/pro_stl.h"
@@ -27,13 +29,26 @@
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+struct PRO_SEND_ITEM
+{
+    CProBuffer*     buf;     /* the copied data, or NULL */
+    IProSendBuffer* sendBuf; /* the referenced data, or NULL */
+    const char*     data;
+    size_t          size;
+    PRO_UINT64      actionId;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
 class CProSendPool
 {
 public:
 
     CProSendPool()
     {
-        m_pendingPos = NULL;
+        m_pendingPos   = NULL;
+        m_pendingBytes = 0;
     }
 
     ~CProSendPool()
@@ -43,14 +58,19 @@ public:
 
         for (; i < c; ++i)
         {
-            delete m_bufs[i];
+            ReleaseItem_i(m_bufs[i]);
         }
 
         m_bufs.clear();
-        m_pendingPos = NULL;
+        m_pendingPos   = NULL;
+        m_pendingBytes = 0;
     }
 
-    void Fill(const void* buf, size_t size)
+    void Fill(
+        const void* buf,
+        size_t      size,
+        PRO_UINT64  actionId = 0
+        )
     {
         if (buf == NULL || size == 0)
         {
@@ -66,12 +86,49 @@ public:
         }
 
         memcpy(p->Data(), buf, size);
-        m_bufs.push_back(p);
 
-        if (m_bufs.size() == 1)
+        PRO_SEND_ITEM item;
+        item.buf      = p;
+        item.sendBuf  = NULL;
+        item.data     = (char*)p->Data();
+        item.size     = size;
+        item.actionId = actionId;
+        PushItem_i(item);
+    }
+
+    /*
+     * the zero-copy version of Fill(). the pool holds a reference of sendBuf
+     * until the data is sent
+     */
+    void Fill(
+        IProSendBuffer* sendBuf,
+        const void*     buf,
+        size_t          size,
+        PRO_UINT64      actionId = 0
+        )
+    {
+        if (sendBuf == NULL || buf == NULL || size == 0)
         {
-            m_pendingPos = (char*)p->Data();
+            return;
         }
+
+        sendBuf->AddRef();
+
+        PRO_SEND_ITEM item;
+        item.buf      = NULL;
+        item.sendBuf  = sendBuf;
+        item.data     = (char*)buf;
+        item.size     = size;
+        item.actionId = actionId;
+        PushItem_i(item);
+    }
+
+    /*
+     * the unsent bytes of all the buffers
+     */
+    size_t GetPendingBytes() const
+    {
+        return (m_pendingBytes);
     }
 
     const void* PreSend(unsigned long& size) const
@@ -83,8 +140,8 @@ public:
             return (NULL);
         }
 
-        CProBuffer* const buf = m_bufs.front();
-        size = (unsigned long)((char*)buf->Data() + buf->Size() - m_pendingPos);
+        const PRO_SEND_ITEM& item = m_bufs.front();
+        size = (unsigned long)(item.data + item.size - m_pendingPos);
         if (size == 0)
         {
             return (NULL);
@@ -93,6 +150,36 @@ public:
         return (m_pendingPos);
     }
 
+    /*
+     * the gather version of PreSend(). it stops at maxSize except for the
+     * first buffer. returns the number of the iovecs
+     */
+    int PreSendv(
+        pbsd_iovec*    iov,
+        int            iovcnt,
+        size_t         maxSize,
+        unsigned long& size
+        ) const
+    {
+        size = 0;
+
+        int       i = 0;
+        const int c = (int)m_bufs.size() < iovcnt ? (int)m_bufs.size() : iovcnt;
+
+        for (; i < c && (i == 0 || size < maxSize); ++i)
+        {
+            const PRO_SEND_ITEM& item  = m_bufs[i];
+            const char* const    begin = i == 0 ? m_pendingPos : item.data;
+            const size_t         len   = item.data + item.size - begin;
+
+            iov[i].iov_base = (char*)begin;
+            iov[i].iov_len  = len;
+            size += (unsigned long)len;
+        }
+
+        return (i);
+    }
+
     void Flush(size_t size)
     {
         if (size == 0 || m_bufs.size() == 0)
@@ -100,59 +187,117 @@ public:
             return;
         }
 
-        CProBuffer* const buf = m_bufs.front();
-        if (m_pendingPos + size > (char*)buf->Data() + buf->Size())
+        const PRO_SEND_ITEM& item = m_bufs.front();
+        if (m_pendingPos + size > item.data + item.size)
         {
             return;
         }
 
-        m_pendingPos += size;
+        m_pendingPos   += size;
+        m_pendingBytes -= size;
+    }
+
+    /*
+     * the gather version of Flush() and PostSend(). the action ids of the
+     * completed buffers are appended to actionIds
+     */
+    void Flushv(
+        size_t                     size,
+        CProStlVector<PRO_UINT64>& actionIds
+        )
+    {
+        while (size > 0 && m_bufs.size() > 0)
+        {
+            const PRO_SEND_ITEM& item   = m_bufs.front();
+            const size_t         remain = item.data + item.size - m_pendingPos;
+
+            if (size < remain)
+            {
+                m_pendingPos   += size;
+                m_pendingBytes -= size;
+                break;
+            }
+
+            m_pendingPos   += remain;
+            m_pendingBytes -= remain;
+            size           -= remain;
+
+            actionIds.push_back(PostSend());
+        }
     }
 
-    const CProBuffer* OnSendBuf() const
+    const void* OnSendBuf() const
     {
         if (m_bufs.size() == 0)
         {
             return (NULL);
         }
 
-        CProBuffer* const buf = m_bufs.front();
-        if (m_pendingPos != (char*)buf->Data() + buf->Size())
+        const PRO_SEND_ITEM& item = m_bufs.front();
+        if (m_pendingPos != item.data + item.size)
         {
             return (NULL);
         }
 
-        return (buf);
+        return (item.data);
     }
 
-    void PostSend()
+    /*
+     * returns the action id of the completed buffer
+     */
+    PRO_UINT64 PostSend()
     {
         if (m_bufs.size() == 0)
         {
-            return;
+            return (0);
         }
 
-        CProBuffer* buf = m_bufs.front();
-        if (m_pendingPos != (char*)buf->Data() + buf->Size())
+        const PRO_SEND_ITEM item = m_bufs.front();
+        if (m_pendingPos != item.data + item.size)
         {
-            return;
+            return (0);
         }
 
         m_bufs.pop_front();
-        delete buf;
+        ReleaseItem_i(item);
         m_pendingPos = NULL;
 
         if (m_bufs.size() > 0)
         {
-            buf = m_bufs.front();
-            m_pendingPos = (char*)buf->Data();
+            m_pendingPos = m_bufs.front().data;
+        }
+
+        return (item.actionId);
+    }
+
+private:
+
+    void PushItem_i(const PRO_SEND_ITEM& item)
+    {
+        m_bufs.push_back(item);
+        m_pendingBytes += item.size;
+
+        if (m_bufs.size() == 1)
+        {
+            m_pendingPos = item.data;
+        }
+    }
+
+    static void ReleaseItem_i(const PRO_SEND_ITEM& item)
+    {
+        delete item.buf;
+
+        if (item.sendBuf != NULL)
+        {
+            item.sendBuf->Release();
         }
     }
 
 private:
 
-    CProStlDeque<CProBuffer*> m_bufs;
-    const char*               m_pendingPos;
+    CProStlDeque<PRO_SEND_ITEM> m_bufs;
+    const char*                 m_pendingPos;
+    size_t                      m_pendingBytes;
 
     DECLARE_SGI_POOL(0);
 };
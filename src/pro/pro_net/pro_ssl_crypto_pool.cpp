@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2018 Eric Tung <libpronet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"),
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of LibProNet (http://www.libpro.org)
+ */
+
+
+#include "pro_ssl_crypto_pool.h"
+#include "pro_ssl_handshaker.h"
+#include "../pro_util/pro_functor_command.h"
+#include "../pro_util/pro_functor_command_task.h"
+#include "../pro_util/pro_stl.h"
+#include "../pro_util/pro_thread_mutex.h"
+#include "../pro_util/pro_time_util.h"
+#include "../pro_util/pro_z.h"
+#include <cassert>
+#include <cstdio>
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+#define DEFAULT_MAX_HANDSHAKES 1024
+#define MAX_THREAD_COUNT       100
+
+typedef void (CProSslCryptoPool::* ACTION)(PRO_INT64*);
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+CProSslCryptoPool::CProSslCryptoPool()
+{
+    m_maxHandshakes    = 0;
+    m_pendingCount     = 0;
+    m_taskIndex        = 0;
+    m_jobCount         = 0;
+    m_overflowCount    = 0;
+    m_waitTime         = 0;
+    m_maxWaitTime      = 0;
+    m_okCount          = 0;
+    m_errorCount       = 0;
+    m_handshakeTime    = 0;
+    m_maxHandshakeTime = 0;
+}
+
+CProSslCryptoPool::~CProSslCryptoPool()
+{
+    Stop();
+}
+
+bool
+CProSslCryptoPool::Start(unsigned long threadCount,
+                         unsigned long maxHandshakes) /* = 0 */
+{{
+    CProThreadMutexGuard mon(m_lockAtom);
+
+    assert(threadCount > 0);
+    if (threadCount == 0)
+    {
+        return (false);
+    }
+
+    if (threadCount > MAX_THREAD_COUNT)
+    {
+        threadCount = MAX_THREAD_COUNT;
+    }
+
+    if (maxHandshakes == 0)
+    {
+        maxHandshakes = DEFAULT_MAX_HANDSHAKES;
+    }
+
+    CProStlVector<CProFunctorCommandTask*> tasks;
+
+    for (int i = 0; i < (int)threadCount; ++i)
+    {
+        CProFunctorCommandTask* const task = new CProFunctorCommandTask;
+        if (!task->Start())
+        {
+            delete task;
+            break;
+        }
+
+        tasks.push_back(task);
+    }
+
+    if (tasks.size() != threadCount)
+    {
+        int       i = 0;
+        const int c = (int)tasks.size();
+
+        for (; i < c; ++i)
+        {
+            tasks[i]->Stop();
+            delete tasks[i];
+        }
+
+        return (false);
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        assert(m_tasks.size() == 0);
+        if (m_tasks.size() != 0)
+        {
+            return (false);
+        }
+
+        m_tasks         = tasks;
+        m_maxHandshakes = maxHandshakes;
+    }
+
+    return (true);
+}}
+
+void
+CProSslCryptoPool::Stop()
+{{
+    CProThreadMutexGuard mon(m_lockAtom);
+
+    CProStlVector<CProFunctorCommandTask*> tasks;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        tasks = m_tasks;
+        m_tasks.clear(); /* no more jobs */
+    }
+
+    /*
+     * the queued jobs are run by Stop() of the tasks
+     */
+    int       i = 0;
+    const int c = (int)tasks.size();
+
+    for (; i < c; ++i)
+    {
+        tasks[i]->Stop();
+        delete tasks[i];
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        m_maxHandshakes    = 0;
+        m_pendingCount     = 0;
+        m_taskIndex        = 0;
+        m_jobCount         = 0;
+        m_overflowCount    = 0;
+        m_waitTime         = 0;
+        m_maxWaitTime      = 0;
+        m_okCount          = 0;
+        m_errorCount       = 0;
+        m_handshakeTime    = 0;
+        m_maxHandshakeTime = 0;
+    }
+}}
+
+bool
+CProSslCryptoPool::Put(CProSslHandshaker* handshaker)
+{
+    assert(handshaker != NULL);
+    if (handshaker == NULL)
+    {
+        return (false);
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_tasks.size() == 0)
+        {
+            return (false);
+        }
+
+        if (m_pendingCount >= m_maxHandshakes)
+        {
+            ++m_overflowCount;
+
+            return (false);
+        }
+
+        IProFunctorCommand* const command =
+            CProFunctorCommand_cpp<CProSslCryptoPool, ACTION>::CreateInstance(
+            *this,
+            &CProSslCryptoPool::Run_i,
+            (PRO_INT64)handshaker,
+            ProGetMicroTickCount64()
+            );
+
+        handshaker->AddRef();
+
+        CProFunctorCommandTask* const task = m_tasks[m_taskIndex % m_tasks.size()];
+        ++m_taskIndex;
+
+        if (!task->Put(command))
+        {
+            command->Destroy();
+            handshaker->Release();
+
+            return (false);
+        }
+
+        ++m_pendingCount;
+        ++m_jobCount;
+    }
+
+    return (true);
+}
+
+void
+CProSslCryptoPool::Run_i(PRO_INT64* args)
+{
+    CProSslHandshaker* const handshaker = (CProSslHandshaker*)args[0];
+    const PRO_INT64          putTick    = args[1];
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        const PRO_INT64 waitTime = ProGetMicroTickCount64() - putTick;
+
+        m_waitTime += waitTime;
+        if (waitTime > m_maxWaitTime)
+        {
+            m_maxWaitTime = waitTime;
+        }
+    }
+
+    handshaker->RunCrypto();
+    handshaker->Release();
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_pendingCount > 0)
+        {
+            --m_pendingCount;
+        }
+    }
+}
+
+void
+CProSslCryptoPool::AddHandshakeTime(PRO_INT64 microseconds,
+                                    bool      ok)
+{
+    CProThreadMutexGuard mon(m_lock);
+
+    if (m_tasks.size() == 0)
+    {
+        return;
+    }
+
+    if (ok)
+    {
+        ++m_okCount;
+    }
+    else
+    {
+        ++m_errorCount;
+    }
+
+    m_handshakeTime += microseconds;
+    if (microseconds > m_maxHandshakeTime)
+    {
+        m_maxHandshakeTime = microseconds;
+    }
+}
+
+void
+CProSslCryptoPool::GetTraceInfo(char*  buf,
+                                size_t size) const
+{
+    assert(buf != NULL);
+    assert(size > 0);
+    if (buf == NULL || size == 0)
+    {
+        return;
+    }
+
+    buf[0] = '\0';
+
+    CProThreadMutexGuard mon(m_lock);
+
+    if (m_tasks.size() == 0)
+    {
+        return;
+    }
+
+    const PRO_UINT64 handshakes = m_okCount + m_errorCount;
+    char             theBuf[512] = "";
+
+    sprintf(
+        theBuf,
+        " [ SSL Async ] : %u threads, %u/%u pending, %.0f jobs (overflow : %.0f), "
+        "%.0f us-wait (max : %.0f) \n"
+        " [ SSL Hshks ] : %.0f ok, %.0f failed, %.0f us (max : %.0f) \n"
+        ,
+        (unsigned int)m_tasks.size(),
+        (unsigned int)m_pendingCount,
+        (unsigned int)m_maxHandshakes,
+        (double)m_jobCount,
+        (double)m_overflowCount,
+        m_jobCount > 0 ? (double)m_waitTime / (double)m_jobCount : 0.0,
+        (double)m_maxWaitTime,
+        (double)m_okCount,
+        (double)m_errorCount,
+        handshakes > 0 ? (double)m_handshakeTime / (double)handshakes : 0.0,
+        (double)m_maxHandshakeTime
+        );
+
+    strncpy_pro(buf, size, theBuf);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2018 Eric Tung <libpronet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"),
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of LibProNet (http://www.libpro.org)
+ */
+
+
+#if !defined(PRO_SSL_CRYPTO_POOL_H)
+#define PRO_SSL_CRYPTO_POOL_H
+
+#include "../pro_util/pro_stl.h"
+#include "../pro_util/pro_thread_mutex.h"
+#include "../pro_util/pro_z.h"
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+class CProFunctorCommandTask;
+class CProSslHandshaker;
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+/*
+ * runs the certificate and key exchange steps of the ssl handshakes in its
+ * own threads, so that the public key operations of a reconnect storm don't
+ * stall the I/O reactors. please refer to PRO_REACTOR_OPTIONS::sslCryptoThreads
+ */
+class CProSslCryptoPool
+{
+public:
+
+    CProSslCryptoPool();
+
+    ~CProSslCryptoPool();
+
+    bool Start(
+        unsigned long threadCount,
+        unsigned long maxHandshakes /* = 0 */
+        );
+
+    void Stop();
+
+    /*
+     * returns false if the pool isn't running or the queue is full. the
+     * handshaker should run the step in its own thread then
+     */
+    bool Put(CProSslHandshaker* handshaker);
+
+    /*
+     * the time from the creation of a handshaker to its result
+     */
+    void AddHandshakeTime(
+        PRO_INT64 microseconds,
+        bool      ok
+        );
+
+    void GetTraceInfo(
+        char*  buf,
+        size_t size
+        ) const;
+
+private:
+
+    /*
+     * runs in the crypto threads
+     */
+    void Run_i(PRO_INT64* args);
+
+private:
+
+    CProStlVector<CProFunctorCommandTask*> m_tasks;
+    unsigned long                          m_maxHandshakes;
+    unsigned long                          m_pendingCount;     /* queued or running */
+    unsigned long                          m_taskIndex;        /* round-robin */
+    PRO_UINT64                             m_jobCount;
+    PRO_UINT64                             m_overflowCount;
+    PRO_UINT64                             m_waitTime;         /* us */
+    PRO_INT64                              m_maxWaitTime;      /* us */
+    PRO_UINT64                             m_okCount;
+    PRO_UINT64                             m_errorCount;
+    PRO_UINT64                             m_handshakeTime;    /* us */
+    PRO_INT64                              m_maxHandshakeTime; /* us */
+    mutable CProThreadMutex                m_lock;
+    CProThreadMutex                        m_lockAtom;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+#endif /* PRO_SSL_CRYPTO_POOL_H */
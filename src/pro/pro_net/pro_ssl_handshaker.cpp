@@ -21,10 +21,12 @@
 #include "pro_net.h"
 #include "pro_recv_pool.h"
 #include "pro_send_pool.h"
+#include "pro_ssl_crypto_pool.h"
 #include "pro_tp_reactor_task.h"
 #include "../pro_util/pro_bsd_wrapper.h"
 #include "../pro_util/pro_memory_pool.h"
 #include "../pro_util/pro_thread_mutex.h"
+#include "../pro_util/pro_time_util.h"
 #include "../pro_util/pro_z.h"
 
 #include "mbedtls/ssl.h"
@@ -58,6 +60,10 @@ CProSslHandshaker::CProSslHandshaker()
     m_onWr        = false;
     m_recvFirst   = false;
     m_timerId     = 0;
+    m_startTick   = 0;
+    m_cryptoBusy  = false;
+    m_cryptoDone  = false;
+    m_cryptoRet   = 0;
 }
 
 CProSslHandshaker::~CProSslHandshaker()
@@ -131,7 +137,8 @@ CProSslHandshaker::Init(IProSslHandshakerObserver* observer,
         m_unixSocket  = unixSocket;
         m_onWr        = true;
         m_recvFirst   = recvFirst;
-        m_timerId     = reactorTask->ScheduleTimer(this, (PRO_UINT64)timeoutInSeconds * 1000, false, 0);
+        m_timerId     = reactorTask->ScheduleHandlerTimer(this, (PRO_UINT64)timeoutInSeconds * 1000, false, 0);
+        m_startTick   = ProGetMicroTickCount64();
     }
 
     return (true);
@@ -155,7 +162,7 @@ CProSslHandshaker::Fini()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -215,11 +222,15 @@ CProSslHandshaker::DoRecv(PRO_INT64 sockId)
 
         if (!m_sslOk)
         {
-            const int ret = mbedtls_ssl_handshake((mbedtls_ssl_context*)m_ctx);
+            const int ret = Handshake_i();
             if (ret == 0)
             {
                 m_sslOk = true;
             }
+            else if (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS)
+            {
+                return;
+            }
             else if (ret == MBEDTLS_ERR_SSL_WANT_READ)
             {
                 return;
@@ -341,11 +352,13 @@ CProSslHandshaker::DoRecv(PRO_INT64 sockId)
 
 EXIT:
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
 
+        AddHandshakeTime_i(false);
+
         m_reactorTask = NULL;
         observer = m_observer;
         m_observer = NULL;
@@ -387,16 +400,20 @@ CProSslHandshaker::DoSend(PRO_INT64 sockId)
 
         unsigned long     theSize   = 0;
         const void* const theBuf    = m_sendPool.PreSend(theSize);
-        const CProBuffer* onSendBuf = NULL;
+        const void*       onSendBuf = NULL;
         size_t            idleSize  = 0;
 
         if (!m_sslOk)
         {
-            const int ret = mbedtls_ssl_handshake((mbedtls_ssl_context*)m_ctx);
+            const int ret = Handshake_i();
             if (ret == 0)
             {
                 m_sslOk = true;
             }
+            else if (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS)
+            {
+                return;
+            }
             else if (ret == MBEDTLS_ERR_SSL_WANT_READ)
             {
                 if (m_onWr)
@@ -515,7 +532,7 @@ CProSslHandshaker::DoSend(PRO_INT64 sockId)
 
 EXIT:
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -526,6 +543,8 @@ EXIT:
             m_sockId = -1;   /* cut */
         }
 
+        AddHandshakeTime_i(!error);
+
         m_reactorTask = NULL;
         observer = m_observer;
         m_observer = NULL;
@@ -572,11 +591,13 @@ CProSslHandshaker::OnError(PRO_INT64 sockId,
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
 
+        AddHandshakeTime_i(false);
+
         m_reactorTask = NULL;
         observer = m_observer;
         m_observer = NULL;
@@ -614,11 +635,13 @@ CProSslHandshaker::OnTimer(unsigned long timerId,
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
 
+        AddHandshakeTime_i(false);
+
         m_reactorTask = NULL;
         observer = m_observer;
         m_observer = NULL;
@@ -627,3 +650,112 @@ CProSslHandshaker::OnTimer(unsigned long timerId,
     observer->OnHandshakeError((IProSslHandshaker*)this, errorCode, sslCode);
     observer->Release();
 }
+
+void
+CProSslHandshaker::RunCrypto()
+{
+    PRO_SSL_CTX* ctx = NULL;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        assert(m_cryptoBusy);
+        if (m_observer == NULL || m_reactorTask == NULL || m_ctx == NULL)
+        {
+            m_cryptoBusy = false;
+
+            return;
+        }
+
+        ctx = m_ctx;
+    }
+
+    /*
+     * no lock here. the others don't touch m_ctx while m_cryptoBusy is set
+     */
+    const int ret = ProSslCtx_Handshake(ctx);
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        m_cryptoBusy = false;
+
+        if (m_observer == NULL || m_reactorTask == NULL || m_ctx == NULL)
+        {
+            return;
+        }
+
+        unsigned long mask = PRO_MASK_READ;
+
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ)
+        {
+            if (ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+            {
+                m_cryptoDone = true; /* taken by Handshake_i() in the reactor */
+                m_cryptoRet  = ret;
+            }
+
+            mask |= PRO_MASK_WRITE;
+        }
+
+        /*
+         * if it fails, the timer will report it
+         */
+        if (m_reactorTask->AddHandler(m_sockId, this, mask))
+        {
+            m_onWr = PRO_BIT_ENABLED(mask, PRO_MASK_WRITE);
+        }
+    }
+}
+
+int
+CProSslHandshaker::Handshake_i()
+{
+    if (m_cryptoBusy)
+    {
+        return (MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS);
+    }
+
+    if (m_cryptoDone)
+    {
+        m_cryptoDone = false;
+
+        return (m_cryptoRet);
+    }
+
+    /*
+     * from the ClientHello to the ClientKeyExchange. the first step of the
+     * client only writes its ClientHello, which is cheap
+     */
+    const int state = ((mbedtls_ssl_context*)m_ctx)->state;
+
+    if (state > MBEDTLS_SSL_HELLO_REQUEST && state <= MBEDTLS_SSL_CLIENT_KEY_EXCHANGE)
+    {
+        CProSslCryptoPool* const cryptoPool = m_reactorTask->GetSslCryptoPool();
+
+        /*
+         * RunCrypto() waits for m_lock, so it's safe to unregister after
+         * the put
+         */
+        if (cryptoPool != NULL && cryptoPool->Put(this))
+        {
+            m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
+            m_onWr       = false;
+            m_cryptoBusy = true;
+
+            return (MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS);
+        }
+    }
+
+    return (ProSslCtx_Handshake(m_ctx));
+}
+
+void
+CProSslHandshaker::AddHandshakeTime_i(bool ok)
+{
+    CProSslCryptoPool* const cryptoPool = m_reactorTask->GetSslCryptoPool();
+    if (cryptoPool != NULL)
+    {
+        cryptoPool->AddHandshakeTime(ProGetMicroTickCount64() - m_startTick, ok);
+    }
+}
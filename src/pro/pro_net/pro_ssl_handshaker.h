@@ -55,6 +55,11 @@ public:
 
     void Fini();
 
+    /*
+     * runs in a thread of CProSslCryptoPool
+     */
+    void RunCrypto();
+
 private:
 
     CProSslHandshaker();
@@ -79,6 +84,15 @@ private:
 
     void DoSend(PRO_INT64 sockId);
 
+    /*
+     * with a crypto pool, the certificate and key exchange steps are put to
+     * the pool, and MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS is returned. the socket
+     * is unregistered until they're done
+     */
+    int Handshake_i();
+
+    void AddHandshakeTime_i(bool ok);
+
 private:
 
     IProSslHandshakerObserver* m_observer;
@@ -92,6 +106,10 @@ private:
     CProRecvPool               m_recvPool;
     CProSendPool               m_sendPool;
     unsigned long              m_timerId;
+    PRO_INT64                  m_startTick; /* us */
+    bool                       m_cryptoBusy;
+    bool                       m_cryptoDone;
+    int                        m_cryptoRet;
     CProThreadMutex            m_lock;
 };
 
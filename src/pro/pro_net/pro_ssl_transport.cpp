@@ -173,17 +173,23 @@ CProSslTransport::Init(IProTransportObserver* observer,
             return (false);
         }
 
+        SetEdgeTriggered(reactorTask->IsEdgeTriggered());
+
         if (!reactorTask->AddHandler(sockId, this, PRO_MASK_WRITE | PRO_MASK_READ))
         {
             return (false);
         }
 
         observer->AddRef();
-        m_observer    = observer;
-        m_reactorTask = reactorTask;
-        m_ctx         = ctx;
-        m_sockId      = sockId;
-        m_onWr        = true;
+        m_observer      = observer;
+        m_reactorTask   = reactorTask;
+        m_ctx           = ctx;
+        m_sockId        = sockId;
+        m_onWr          = true;
+        m_directWrite   = reactorTask->IsDirectWrite();
+        m_sendQueueSize = reactorTask->GetSendQueueSize();
+
+        ProSslCtx_ReleaseBuffers(m_ctx); /* if dynamic and idle */
     }
 
     return (true);
@@ -197,7 +203,7 @@ CProSslTransport::Fini()
     {
         CProThreadMutexGuard mon(m_lock);
 
-        if (m_ctx != NULL && m_sockId != -1)
+        if (m_ctx != NULL && m_sockId != -1 && ProSslCtx_AcquireBuffers(m_ctx))
         {
             mbedtls_ssl_close_notify((mbedtls_ssl_context*)m_ctx);
         }
@@ -207,7 +213,7 @@ CProSslTransport::Fini()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -256,6 +262,8 @@ CProSslTransport::DoRecv(PRO_INT64 sockId)
     }
 
     size_t msgSize = 0;
+    int    rounds  = 0;
+    bool   more    = false;
 
     do
     {
@@ -274,7 +282,7 @@ CProSslTransport::DoRecv(PRO_INT64 sockId)
                 return;
             }
 
-            if (sockId != m_sockId)
+            if (sockId != m_sockId || m_recvSuspended)
             {
                 return;
             }
@@ -291,6 +299,15 @@ CProSslTransport::DoRecv(PRO_INT64 sockId)
                 goto EXIT;
             }
 
+            if (!ProSslCtx_AcquireBuffers(m_ctx))
+            {
+                error     = true;
+                errorCode = -1;
+                sslCode   = MBEDTLS_ERR_SSL_ALLOC_FAILED;
+
+                goto EXIT;
+            }
+
             recvSize = mbedtls_ssl_read((mbedtls_ssl_context*)m_ctx,
                 (unsigned char*)m_recvPool.ContinuousIdleBuf(), minSize);
             assert(recvSize <= (int)minSize);
@@ -305,6 +322,26 @@ CProSslTransport::DoRecv(PRO_INT64 sockId)
             {
                 m_recvPool.Fill(recvSize);
                 msgSize = mbedtls_ssl_get_bytes_avail((mbedtls_ssl_context*)m_ctx); /* remaining message */
+
+                /*
+                 * the record wraps around the ring. the rest of it is already
+                 * decrypted, and goes into the head of the pool in this round
+                 */
+                const size_t idleSize2 = m_recvPool.ContinuousIdleSize();
+                if (msgSize > 0 && idleSize2 > 0)
+                {
+                    const int recvSize2 = mbedtls_ssl_read((mbedtls_ssl_context*)m_ctx,
+                        (unsigned char*)m_recvPool.ContinuousIdleBuf(),
+                        msgSize < idleSize2 ? msgSize : idleSize2);
+                    if (recvSize2 > 0)
+                    {
+                        m_recvPool.Fill(recvSize2);
+                        recvSize += recvSize2;
+                        msgSize   = mbedtls_ssl_get_bytes_avail((mbedtls_ssl_context*)m_ctx);
+                    }
+                }
+
+                AddIoBytes(recvSize);
             }
             else if (recvSize == 0)
             {
@@ -313,6 +350,7 @@ CProSslTransport::DoRecv(PRO_INT64 sockId)
             else if (recvSize == MBEDTLS_ERR_SSL_WANT_READ)
             {
                 msgSize = 0;
+                ProSslCtx_ReleaseBuffers(m_ctx); /* if dynamic and idle */
             }
             else if (recvSize == MBEDTLS_ERR_SSL_WANT_WRITE)
             {
@@ -367,10 +405,61 @@ EXIT:
         if (!m_canUpcall)
         {
             Fini();
+
+            return;
+        }
+
+        more = IsEdgeTriggered() && recvSize > 0; /* not WANT_READ yet */
+    }
+    while (msgSize > 0 || (more && ++rounds < PRO_EDGE_BUDGET)); /* read a complete ssl record */
+
+    /*
+     * the budget is used up, and the rest is read in the next round
+     */
+    if (more && msgSize == 0)
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_observer != NULL && m_reactorTask != NULL && m_ctx != NULL && sockId == m_sockId)
+        {
+            m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_READ);
+        }
+    }
+}
+
+size_t
+CProSslTransport::SendDirect_i(const void* buf,
+                               size_t      size)
+{
+    if (m_ctx == NULL || !ProSslCtx_AcquireBuffers(m_ctx))
+    {
+        return (0);
+    }
+
+    /*
+     * a record or more. it stops at WANT_WRITE, and DoSend() retries the
+     * rest with the same data, as mbedtls expects
+     */
+    size_t sentSize = 0;
+
+    while (sentSize < size)
+    {
+        const int sentSize2 = mbedtls_ssl_write((mbedtls_ssl_context*)m_ctx,
+            (unsigned char*)buf + sentSize, size - sentSize);
+        if (sentSize2 <= 0 || sentSize2 > (int)(size - sentSize))
+        {
             break;
         }
+
+        sentSize += sentSize2;
     }
-    while (msgSize > 0); /* read a complete ssl record */
+
+    if (sentSize == size)
+    {
+        ProSslCtx_ReleaseBuffers(m_ctx); /* if dynamic and idle */
+    }
+
+    return (sentSize);
 }
 
 void
@@ -387,9 +476,9 @@ CProSslTransport::DoSend(PRO_INT64 sockId)
     int                    errorCode     = 0;
     int                    sslCode       = 0;
     bool                   error         = false;
-    const CProBuffer*      onSendBuf     = NULL;
     bool                   requestOnSend = false;
-    PRO_UINT64             actionId      = 0;
+
+    m_sentIds.clear();
 
     {
         CProThreadMutexGuard mon(m_lock);
@@ -404,74 +493,133 @@ CProSslTransport::DoSend(PRO_INT64 sockId)
             return;
         }
 
-        unsigned long     theSize = 0;
-        const void* const theBuf  = m_sendPool.PreSend(theSize);
+        m_sentIds.swap(m_directIds); /* they're before the queued ones */
+
+        unsigned long theSize = 0;
+        const void*   theBuf  = m_sendPool.PreSend(theSize);
 
         if (theBuf == NULL || theSize == 0)
         {
             m_pendingWr = false;
 
-            if (!m_requestOnSend)
+            if (!m_requestOnSend && m_sentIds.size() == 0)
             {
-                if (m_onWr)
+                if (m_onWr && !IsEdgeTriggered())
                 {
                     m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE);
                     m_onWr = false;
                 }
 
+                ProSslCtx_ReleaseBuffers(m_ctx); /* if dynamic and idle */
+
                 return;
             }
         }
+        else if (!ProSslCtx_AcquireBuffers(m_ctx))
+        {
+            error     = true;
+            errorCode = -1;
+            sslCode   = MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        }
         else
         {
-            sentSize = mbedtls_ssl_write(
-                (mbedtls_ssl_context*)m_ctx, (unsigned char*)theBuf, theSize);
-            assert(sentSize <= (int)theSize);
+            /*
+             * the send queue writes the buffers one after another, a record
+             * or more each, until the socket is full
+             */
+            int rounds = 0;
 
-            if (sentSize > (int)theSize)
-            {
-                error     = true;
-                errorCode = -1;
-                sslCode   = MBEDTLS_ERR_SSL_INTERNAL_ERROR;
-            }
-            else if (sentSize > 0)
+            while (1)
             {
-                m_sendPool.Flush(sentSize);
+                sentSize = mbedtls_ssl_write(
+                    (mbedtls_ssl_context*)m_ctx, (unsigned char*)theBuf, theSize);
+                assert(sentSize <= (int)theSize);
+
+                /*
+                 * a write no more than a record doesn't mean the socket is full,
+                 * so the edge-triggered mode writes the rest until WANT_WRITE
+                 */
+                while (IsEdgeTriggered() && sentSize > 0 && sentSize < (int)theSize)
+                {
+                    const int sentSize2 = mbedtls_ssl_write((mbedtls_ssl_context*)m_ctx,
+                        (unsigned char*)theBuf + sentSize, theSize - sentSize);
+                    if (sentSize2 <= 0)
+                    {
+                        break;
+                    }
 
-                onSendBuf = m_sendPool.OnSendBuf();
-                if (onSendBuf != NULL)
+                    sentSize += sentSize2;
+                }
+
+                if (sentSize > (int)theSize)
                 {
-                    m_sendPool.PostSend();
-                    m_pendingWr = false;
+                    error     = true;
+                    errorCode = -1;
+                    sslCode   = MBEDTLS_ERR_SSL_INTERNAL_ERROR;
                 }
-            }
-            else if (sentSize == 0 || sentSize == MBEDTLS_ERR_SSL_WANT_WRITE)
-            {
-            }
-            else if (sentSize == MBEDTLS_ERR_SSL_WANT_READ)
-            {
-                if (m_onWr)
+                else if (sentSize > 0)
                 {
-                    m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE);
-                    m_onWr = false;
+                    m_sendPool.Flush(sentSize);
+                    AddIoBytes(sentSize);
+
+                    if (m_sendPool.OnSendBuf() != NULL)
+                    {
+                        m_sentIds.push_back(m_sendPool.PostSend());
+                        m_pendingWr = m_sendPool.GetPendingBytes() > 0;
+                    }
+                }
+                else if (sentSize == 0 || sentSize == MBEDTLS_ERR_SSL_WANT_WRITE)
+                {
+                }
+                else if (sentSize == MBEDTLS_ERR_SSL_WANT_READ)
+                {
+                    if (m_onWr && !IsEdgeTriggered())
+                    {
+                        m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE);
+                        m_onWr = false;
+                    }
+                }
+                else
+                {
+                    error     = true;
+                    errorCode = -1;
+                    sslCode   = sentSize;
+                }
+
+                if (m_sendQueueSize == 0 || !m_pendingWr || sentSize != (int)theSize)
+                {
+                    break;
+                }
+
+                /*
+                 * no edge comes if the socket took all, but there are more
+                 * than PBSD_IOV_MAX buffers
+                 */
+                if (++rounds >= PBSD_IOV_MAX)
+                {
+                    if (IsEdgeTriggered())
+                    {
+                        m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_WRITE);
+                    }
+                    break;
+                }
+
+                theBuf = m_sendPool.PreSend(theSize);
+                if (theBuf == NULL || theSize == 0)
+                {
+                    break;
                 }
-            }
-            else
-            {
-                error     = true;
-                errorCode = -1;
-                sslCode   = sentSize;
             }
         }
 
-        requestOnSend = m_requestOnSend;
-        m_requestOnSend = false;
-        if (onSendBuf != NULL)
+        if (!error && !m_pendingWr)
         {
-            actionId = m_actionId;
-            m_actionId = 0;
+            ProSslCtx_ReleaseBuffers(m_ctx); /* if dynamic and idle */
         }
 
+        requestOnSend = m_requestOnSend;
+        m_requestOnSend = false;
+
         m_observer->AddRef();
         observer = m_observer;
     }
@@ -483,16 +631,17 @@ CProSslTransport::DoSend(PRO_INT64 sockId)
             m_canUpcall = false;
             observer->OnClose(this, errorCode, sslCode);
         }
-        else if (onSendBuf != NULL || requestOnSend)
+        else if (m_sentIds.size() > 0 || requestOnSend)
         {
-            observer->OnSend(this, actionId);
+            OnSendUpcall_i(observer);
 
             {
                 CProThreadMutexGuard mon(m_lock);
 
-                if (m_observer != NULL && m_reactorTask != NULL && m_ctx != NULL)
+                if (m_observer != NULL && m_reactorTask != NULL && m_ctx != NULL &&
+                    !IsEdgeTriggered())
                 {
-                    if (m_onWr && !m_pendingWr && !m_requestOnSend)
+                    if (m_onWr && !m_pendingWr && !m_requestOnSend && m_directIds.size() == 0)
                     {
                         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE);
                         m_onWr = false;
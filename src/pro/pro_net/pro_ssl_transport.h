@@ -63,6 +63,11 @@ private:
 
     void DoSend(PRO_INT64 sockId);
 
+    virtual size_t SendDirect_i(
+        const void* buf,
+        size_t      size
+        );
+
 private:
 
     PRO_SSL_CTX* m_ctx;
@@ -132,7 +132,7 @@ CProTcpHandshaker::Init(IProTcpHandshakerObserver* observer,
         m_reactorTask = reactorTask;
         m_sockId      = sockId;
         m_unixSocket  = unixSocket;
-        m_timerId     = reactorTask->ScheduleTimer(this, (PRO_UINT64)timeoutInSeconds * 1000, false, 0);
+        m_timerId     = reactorTask->ScheduleHandlerTimer(this, (PRO_UINT64)timeoutInSeconds * 1000, false, 0);
     }
 
     return (true);
@@ -151,7 +151,7 @@ CProTcpHandshaker::Fini()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -234,7 +234,7 @@ CProTcpHandshaker::OnInput(PRO_INT64 sockId)
             }
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -279,7 +279,7 @@ CProTcpHandshaker::OnOutput(PRO_INT64 sockId)
 
         unsigned long     theSize   = 0;
         const void* const theBuf    = m_sendPool.PreSend(theSize);
-        const CProBuffer* onSendBuf = NULL;
+        const void*       onSendBuf = NULL;
         size_t            idleSize  = 0;
 
         if (theBuf != NULL && theSize > 0)
@@ -353,7 +353,7 @@ CProTcpHandshaker::OnOutput(PRO_INT64 sockId)
 
 EXIT:
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -407,7 +407,7 @@ CProTcpHandshaker::OnError(PRO_INT64 sockId,
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -448,7 +448,7 @@ CProTcpHandshaker::OnTimer(unsigned long timerId,
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
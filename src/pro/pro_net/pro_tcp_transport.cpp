@@ -67,17 +67,20 @@ CProTcpTransport::CProTcpTransport(bool   recvFdMode,
 m_recvFdMode(recvFdMode),
 m_recvPoolSize(recvPoolSize > 0 ? recvPoolSize : DEFAULT_RECV_POOL_SIZE)
 {
-    m_observer      = NULL;
-    m_reactorTask   = NULL;
-    m_sockId        = -1;
-    m_onWr          = false;
-    m_pendingWr     = false;
-    m_requestOnSend = false;
-    m_actionId      = 0;
-    m_sendingFd     = -1;
-    m_timerId       = 0;
-
-    m_canUpcall     = true;
+    m_observer        = NULL;
+    m_reactorTask     = NULL;
+    m_sockId          = -1;
+    m_onWr            = false;
+    m_recvSuspended   = false;
+    m_pendingWr       = false;
+    m_requestOnSend   = false;
+    m_directWrite     = false;
+    m_sendQueueSize   = 0;
+    m_sockBufSizeSend = 0;
+    m_sendingFd       = -1;
+    m_timerId         = 0;
+
+    m_canUpcall       = true;
 
     memset(&m_localAddr , 0, sizeof(pbsd_sockaddr_in));
     memset(&m_remoteAddr, 0, sizeof(pbsd_sockaddr_in));
@@ -195,15 +198,26 @@ CProTcpTransport::Init(IProTransportObserver* observer,
             return (false);
         }
 
-        if (!reactorTask->AddHandler(sockId, this, PRO_MASK_READ))
+        /*
+         * the write interest of an edge-triggered transport is armed once
+         */
+        const bool edgeTriggered = !m_recvFdMode && reactorTask->IsEdgeTriggered();
+        SetEdgeTriggered(edgeTriggered);
+
+        if (!reactorTask->AddHandler(
+            sockId, this, edgeTriggered ? PRO_MASK_WRITE | PRO_MASK_READ : PRO_MASK_READ))
         {
             return (false);
         }
 
         observer->AddRef();
-        m_observer    = observer;
-        m_reactorTask = reactorTask;
-        m_sockId      = sockId;
+        m_observer        = observer;
+        m_reactorTask     = reactorTask;
+        m_sockId          = sockId;
+        m_onWr            = edgeTriggered;
+        m_directWrite     = !m_recvFdMode && reactorTask->IsDirectWrite();
+        m_sendQueueSize   = m_recvFdMode ? 0 : reactorTask->GetSendQueueSize();
+        m_sockBufSizeSend = sockBufSizeSend;
     }
 
     return (true);
@@ -222,7 +236,7 @@ CProTcpTransport::Fini()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -344,6 +358,32 @@ CProTcpTransport::SendData(const void*             buf,
                            size_t                  size,
                            PRO_UINT64              actionId,   /* = 0 */
                            const pbsd_sockaddr_in* remoteAddr) /* = NULL */
+{
+    return (SendData_i(NULL, buf, size, actionId));
+}
+
+bool
+PRO_CALLTYPE
+CProTcpTransport::SendBuffer(IProSendBuffer*         sendBuf,
+                             const void*             buf,
+                             size_t                  size,
+                             PRO_UINT64              actionId,   /* = 0 */
+                             const pbsd_sockaddr_in* remoteAddr) /* = NULL */
+{
+    assert(sendBuf != NULL);
+    if (sendBuf == NULL)
+    {
+        return (false);
+    }
+
+    return (SendData_i(sendBuf, buf, size, actionId));
+}
+
+bool
+CProTcpTransport::SendData_i(IProSendBuffer* sendBuf,
+                             const void*     buf,
+                             size_t          size,
+                             PRO_UINT64      actionId)
 {
     assert(buf != NULL);
     assert(size > 0);
@@ -360,7 +400,11 @@ CProTcpTransport::SendData(const void*             buf,
             return (false);
         }
 
-        if (m_pendingWr)
+        /*
+         * the send queue takes more data until it's above the watermark
+         */
+        if (m_pendingWr &&
+            (m_sendQueueSize == 0 || m_sendPool.GetPendingBytes() + size > m_sendQueueSize))
         {
             return (false);
         }
@@ -374,15 +418,58 @@ CProTcpTransport::SendData(const void*             buf,
 
             m_onWr = true;
         }
+        else if (IsEdgeTriggered() && !m_pendingWr && m_directIds.size() == 0)
+        {
+            if (!m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_WRITE))
+            {
+                return (false);
+            }
+        }
 
-        m_sendPool.Fill(buf, size);
-        m_pendingWr = true;
-        m_actionId  = actionId;
+        /*
+         * the direct write goes first if nothing is queued. the rest is
+         * queued, and OnSend() is still called back by the reactor
+         */
+        size_t sentSize = 0;
+        if (m_directWrite && m_sendPool.GetPendingBytes() == 0)
+        {
+            sentSize = SendDirect_i(buf, size);
+        }
+
+        if (sentSize >= size)
+        {
+            m_directIds.push_back(actionId);
+        }
+        else
+        {
+            if (sendBuf != NULL)
+            {
+                m_sendPool.Fill(sendBuf, (char*)buf + sentSize, size - sentSize, actionId);
+            }
+            else
+            {
+                m_sendPool.Fill((char*)buf + sentSize, size - sentSize, actionId);
+            }
+            m_pendingWr = true;
+        }
     }
 
     return (true);
 }
 
+size_t
+CProTcpTransport::SendDirect_i(const void* buf,
+                               size_t      size)
+{
+    const int sentSize = pbsd_send(m_sockId, buf, (int)size, 0);
+    if (sentSize <= 0 || sentSize > (int)size)
+    {
+        return (0); /* the error is left to OnOutput() */
+    }
+
+    return (sentSize);
+}
+
 bool
 CProTcpTransport::SendFd(const PRO_SERVICE_PACKET& s2cPacket)
 {
@@ -415,6 +502,13 @@ CProTcpTransport::SendFd(const PRO_SERVICE_PACKET& s2cPacket)
 
             m_onWr = true;
         }
+        else if (IsEdgeTriggered())
+        {
+            if (!m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_WRITE))
+            {
+                return (false);
+            }
+        }
 
         m_sendPool.Fill(&s2cPacket, sizeof(PRO_SERVICE_PACKET));
         m_sendingFd = s2cPacket.s2c.oldSock.sockId;
@@ -450,6 +544,13 @@ CProTcpTransport::RequestOnSend()
 
             m_onWr = true;
         }
+        else if (IsEdgeTriggered())
+        {
+            if (!m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_WRITE))
+            {
+                return;
+            }
+        }
 
         m_requestOnSend = true;
     }
@@ -468,6 +569,7 @@ CProTcpTransport::SuspendRecv()
         }
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_READ);
+        m_recvSuspended = true;
     }
 }
 
@@ -484,6 +586,7 @@ CProTcpTransport::ResumeRecv()
         }
 
         m_reactorTask->AddHandler(m_sockId, this, PRO_MASK_READ);
+        m_recvSuspended = false;
     }
 }
 
@@ -501,7 +604,7 @@ CProTcpTransport::StartHeartbeat()
 
         if (m_timerId == 0)
         {
-            m_timerId = m_reactorTask->ScheduleHeartbeatTimer(this, 0);
+            m_timerId = m_reactorTask->ScheduleHandlerHeartbeatTimer(this, 0);
         }
     }
 }
@@ -518,7 +621,7 @@ CProTcpTransport::StopHeartbeat()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
     }
 }
@@ -531,13 +634,38 @@ CProTcpTransport::OnInput(PRO_INT64 sockId)
     {
         OnInputFd(sockId);
     }
-    else
+    else if (!IsEdgeTriggered())
     {
         OnInputData(sockId);
     }
+    else
+    {
+        /*
+         * read until EAGAIN, but no more than PRO_EDGE_BUDGET times, and
+         * then the rest is read in the next round
+         */
+        int i = 0;
+
+        for (; i < PRO_EDGE_BUDGET; ++i)
+        {
+            if (!OnInputData(sockId))
+            {
+                return;
+            }
+        }
+
+        {
+            CProThreadMutexGuard mon(m_lock);
+
+            if (m_observer != NULL && m_reactorTask != NULL && sockId == m_sockId)
+            {
+                m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_READ);
+            }
+        }
+    }
 }
 
-void
+bool
 CProTcpTransport::OnInputData(PRO_INT64 sockId)
 {{
     CProThreadMutexGuard mon(m_lockUpcall);
@@ -545,28 +673,31 @@ CProTcpTransport::OnInputData(PRO_INT64 sockId)
     assert(sockId != -1);
     if (sockId == -1)
     {
-        return;
+        return (false);
     }
 
     IProTransportObserver* observer  = NULL;
+    size_t                 idleSize  = 0;
     int                    recvSize  = 0;
     int                    errorCode = 0;
     const int              sslCode   = 0;
+    bool                   more      = false;
+    pbsd_iovec             iov[2];
 
     {
         CProThreadMutexGuard mon(m_lock);
 
         if (m_observer == NULL || m_reactorTask == NULL)
         {
-            return;
+            return (false);
         }
 
-        if (sockId != m_sockId)
+        if (sockId != m_sockId || m_recvSuspended)
         {
-            return;
+            return (false);
         }
 
-        const size_t idleSize = m_recvPool.ContinuousIdleSize();
+        idleSize = m_recvPool.IdleSize();
 
         assert(idleSize > 0);
         if (idleSize == 0)
@@ -577,7 +708,18 @@ CProTcpTransport::OnInputData(PRO_INT64 sockId)
             goto EXIT;
         }
 
-        recvSize = pbsd_recv(m_sockId, m_recvPool.ContinuousIdleBuf(), (int)idleSize, 0);
+        /*
+         * when the idle space wraps around the ring, both segments are filled
+         * by one readv(), instead of a short read and another round
+         */
+        if (m_recvPool.IdleSegments(iov) > 1)
+        {
+            recvSize = pbsd_recvv(m_sockId, iov, 2, 0);
+        }
+        else
+        {
+            recvSize = pbsd_recv(m_sockId, m_recvPool.ContinuousIdleBuf(), (int)idleSize, 0);
+        }
         assert(recvSize <= (int)idleSize);
 
         if (recvSize > (int)idleSize)
@@ -588,6 +730,7 @@ CProTcpTransport::OnInputData(PRO_INT64 sockId)
         else if (recvSize > 0)
         {
             m_recvPool.Fill(recvSize);
+            AddIoBytes(recvSize);
         }
         else if (recvSize == 0)
         {
@@ -609,6 +752,8 @@ EXIT:
         {
             observer->OnRecv(this, &m_remoteAddr);
             assert(m_recvPool.ContinuousIdleSize() > 0);
+
+            more = recvSize == (int)idleSize; /* a short read drains the socket */
         }
         else if (
             recvSize < 0 && errorCode != PBSD_EWOULDBLOCK
@@ -629,7 +774,11 @@ EXIT:
     if (!m_canUpcall)
     {
         Fini();
+
+        return (false);
     }
+
+    return (more);
 }}
 
 void
@@ -746,9 +895,9 @@ CProTcpTransport::OnOutput(PRO_INT64 sockId)
     int                    sentSize      = 0;
     int                    errorCode     = 0;
     const int              sslCode       = 0;
-    const CProBuffer*      onSendBuf     = NULL;
     bool                   requestOnSend = false;
-    PRO_UINT64             actionId      = 0;
+
+    m_sentIds.clear();
 
     {
         CProThreadMutexGuard mon(m_lock);
@@ -763,6 +912,8 @@ CProTcpTransport::OnOutput(PRO_INT64 sockId)
             return;
         }
 
+        m_sentIds.swap(m_directIds); /* they're before the queued ones */
+
         unsigned long     theSize = 0;
         const void* const theBuf  = m_sendPool.PreSend(theSize);
 
@@ -770,9 +921,9 @@ CProTcpTransport::OnOutput(PRO_INT64 sockId)
         {
             m_pendingWr = false;
 
-            if (!m_requestOnSend)
+            if (!m_requestOnSend && m_sentIds.size() == 0)
             {
-                if (m_onWr)
+                if (m_onWr && !IsEdgeTriggered())
                 {
                     m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE);
                     m_onWr = false;
@@ -781,6 +932,51 @@ CProTcpTransport::OnOutput(PRO_INT64 sockId)
                 return;
             }
         }
+        else if (m_sendingFd == -1 && m_sendQueueSize > 0)
+        {
+            /*
+             * the queued buffers go out in one gather send, no more than the
+             * socket buffer. a larger one makes the loopback tcp stall on the
+             * receive window
+             */
+            pbsd_iovec    iov[PBSD_IOV_MAX];
+            unsigned long iovSize = 0;
+            const int     iovcnt  = m_sendPool.PreSendv(
+                iov, PBSD_IOV_MAX, m_sockBufSizeSend, iovSize);
+
+            sentSize = pbsd_sendv(m_sockId, iov, iovcnt, 0);
+            assert(sentSize <= (int)iovSize);
+
+            if (sentSize > (int)iovSize)
+            {
+                sentSize  = -1;
+                errorCode = -1;
+            }
+            else if (sentSize > 0)
+            {
+                m_sendPool.Flushv(sentSize, m_sentIds);
+                AddIoBytes(sentSize);
+                m_pendingWr = m_sendPool.GetPendingBytes() > 0;
+
+                /*
+                 * no edge comes if the socket took all, but there are
+                 * more than PBSD_IOV_MAX buffers
+                 */
+                if (m_pendingWr && sentSize == (int)iovSize && IsEdgeTriggered())
+                {
+                    m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_WRITE);
+                }
+            }
+            else if (sentSize == 0)
+            {
+                sentSize  = -1;
+                errorCode = PBSD_EWOULDBLOCK;
+            }
+            else
+            {
+                errorCode = pbsd_errno((void*)&pbsd_sendv);
+            }
+        }
         else if (m_sendingFd == -1)
         {
             sentSize = pbsd_send(m_sockId, theBuf, theSize, 0);
@@ -794,11 +990,11 @@ CProTcpTransport::OnOutput(PRO_INT64 sockId)
             else if (sentSize > 0)
             {
                 m_sendPool.Flush(sentSize);
+                AddIoBytes(sentSize);
 
-                onSendBuf = m_sendPool.OnSendBuf();
-                if (onSendBuf != NULL)
+                if (m_sendPool.OnSendBuf() != NULL)
                 {
-                    m_sendPool.PostSend();
+                    m_sentIds.push_back(m_sendPool.PostSend());
                     m_pendingWr = false;
                 }
             }
@@ -847,11 +1043,6 @@ CProTcpTransport::OnOutput(PRO_INT64 sockId)
 
         requestOnSend = m_requestOnSend;
         m_requestOnSend = false;
-        if (onSendBuf != NULL)
-        {
-            actionId = m_actionId;
-            m_actionId = 0;
-        }
 
         m_observer->AddRef();
         observer = m_observer;
@@ -864,16 +1055,16 @@ CProTcpTransport::OnOutput(PRO_INT64 sockId)
             m_canUpcall = false;
             observer->OnClose(this, errorCode, sslCode);
         }
-        else if (onSendBuf != NULL || requestOnSend)
+        else if (m_sentIds.size() > 0 || requestOnSend)
         {
-            observer->OnSend(this, actionId);
+            OnSendUpcall_i(observer);
 
             {
                 CProThreadMutexGuard mon(m_lock);
 
-                if (m_observer != NULL && m_reactorTask != NULL)
+                if (m_observer != NULL && m_reactorTask != NULL && !IsEdgeTriggered())
                 {
-                    if (m_onWr && !m_pendingWr && !m_requestOnSend)
+                    if (m_onWr && !m_pendingWr && !m_requestOnSend && m_directIds.size() == 0)
                     {
                         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE);
                         m_onWr = false;
@@ -894,6 +1085,35 @@ CProTcpTransport::OnOutput(PRO_INT64 sockId)
     }
 }}
 
+void
+CProTcpTransport::OnSendUpcall_i(IProTransportObserver* observer)
+{
+    if (m_sentIds.size() == 0)
+    {
+        observer->OnSend(this, 0); /* for RequestOnSend() */
+
+        return;
+    }
+
+    int       i = 0;
+    const int c = (int)m_sentIds.size();
+
+    for (; i < c; ++i)
+    {
+        if (i > 0)
+        {
+            CProThreadMutexGuard mon(m_lock);
+
+            if (m_observer == NULL || m_reactorTask == NULL)
+            {
+                break;
+            }
+        }
+
+        observer->OnSend(this, m_sentIds[i]);
+    }
+}
+
 void
 PRO_CALLTYPE
 CProTcpTransport::OnError(PRO_INT64 sockId,
@@ -977,3 +1197,26 @@ CProTcpTransport::OnTimer(unsigned long timerId,
 
     observer->Release();
 }}
+
+void
+PRO_CALLTYPE
+CProTcpTransport::OnReactorMoved()
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_observer == NULL || m_reactorTask == NULL)
+        {
+            return;
+        }
+
+        /*
+         * the heartbeat timer follows the reactor
+         */
+        if (m_timerId != 0 && GetTimerReactor() != NULL)
+        {
+            m_reactorTask->CancelHandlerTimer(this, m_timerId);
+            m_timerId = m_reactorTask->ScheduleHandlerHeartbeatTimer(this, 0);
+        }
+    }
+}
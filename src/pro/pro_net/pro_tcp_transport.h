@@ -92,6 +92,23 @@ public:
         const pbsd_sockaddr_in* remoteAddr /* = NULL */
         );
 
+    virtual bool PRO_CALLTYPE SendBuffer(
+        IProSendBuffer*         sendBuf,
+        const void*             buf,
+        size_t                  size,
+        PRO_UINT64              actionId,  /* = 0 */
+        const pbsd_sockaddr_in* remoteAddr /* = NULL */
+        );
+
+    virtual bool PRO_CALLTYPE SendDataBatch(
+        const PRO_DATAGRAM* datagrams,
+        size_t              count,
+        PRO_UINT64          actionId /* = 0 */
+        )
+    {
+        return (false);
+    }
+
     virtual void PRO_CALLTYPE RequestOnSend();
 
     virtual void PRO_CALLTYPE SuspendRecv();
@@ -136,31 +153,55 @@ protected:
         PRO_INT64     userData
         );
 
-    void OnInputData(PRO_INT64 sockId);
+    virtual void PRO_CALLTYPE OnReactorMoved();
+
+    bool OnInputData(PRO_INT64 sockId); /* returns true if there may be more data */
 
     void OnInputFd(PRO_INT64 sockId);
 
+    bool SendData_i(
+        IProSendBuffer* sendBuf, /* NULL for copying */
+        const void*     buf,
+        size_t          size,
+        PRO_UINT64      actionId
+        );
+
+    /*
+     * writes the data in the caller's thread. returns the bytes taken
+     */
+    virtual size_t SendDirect_i(
+        const void* buf,
+        size_t      size
+        );
+
+    void OnSendUpcall_i(IProTransportObserver* observer); /* OnSend() for each of m_sentIds */
+
 protected:
 
-    const bool              m_recvFdMode;
-    const size_t            m_recvPoolSize;
-    IProTransportObserver*  m_observer;
-    CProTpReactorTask*      m_reactorTask;
-    PRO_INT64               m_sockId;
-    pbsd_sockaddr_in        m_localAddr;
-    pbsd_sockaddr_in        m_remoteAddr;
-    bool                    m_onWr;
-    bool                    m_pendingWr;
-    bool                    m_requestOnSend;
-    PRO_UINT64              m_actionId;
-    CProRecvPool            m_recvPool;
-    CProSendPool            m_sendPool;
-    PRO_INT64               m_sendingFd;
-    unsigned long           m_timerId;
-    mutable CProThreadMutex m_lock;
-
-    bool                    m_canUpcall;
-    CProThreadMutex         m_lockUpcall;
+    const bool                m_recvFdMode;
+    const size_t              m_recvPoolSize;
+    IProTransportObserver*    m_observer;
+    CProTpReactorTask*        m_reactorTask;
+    PRO_INT64                 m_sockId;
+    pbsd_sockaddr_in          m_localAddr;
+    pbsd_sockaddr_in          m_remoteAddr;
+    bool                      m_onWr;
+    bool                      m_recvSuspended;
+    bool                      m_pendingWr;
+    bool                      m_requestOnSend;
+    bool                      m_directWrite;
+    size_t                    m_sendQueueSize;
+    size_t                    m_sockBufSizeSend;
+    CProRecvPool              m_recvPool;
+    CProSendPool              m_sendPool;
+    CProStlVector<PRO_UINT64> m_sentIds;   /* the completed action ids. for the upcall */
+    CProStlVector<PRO_UINT64> m_directIds; /* the action ids completed by SendDirect_i() */
+    PRO_INT64                 m_sendingFd;
+    unsigned long             m_timerId;
+    mutable CProThreadMutex   m_lock;
+
+    bool                      m_canUpcall;
+    CProThreadMutex           m_lockUpcall;
 };
 
 /////////////////////////////////////////////////////////////////////////////
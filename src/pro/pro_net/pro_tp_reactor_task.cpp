@@ -22,17 +22,25 @@
 #include "pro_event_handler.h"
 #include "pro_net.h"
 #include "pro_select_reactor.h"
+#include "pro_tcp_transport.h"
+#include "pro_udp_transport.h"
+#include "pro_uring_reactor.h"
+#include "../pro_util/pro_bsd_wrapper.h"
+#include "../pro_util/pro_functor_command.h"
 #include "../pro_util/pro_stl.h"
 #include "../pro_util/pro_thread.h"
 #include "../pro_util/pro_thread_mutex.h"
+#include "../pro_util/pro_time_util.h"
 #include "../pro_util/pro_timer_factory.h"
 #include "../pro_util/pro_z.h"
+#include "../pro_shared/pro_shared.h"
 
 #if defined(WIN32) || defined(_WIN32_WCE)
 #include <windows.h>
 #endif
 
 #include <cassert>
+#include <cstring>
 
 /////////////////////////////////////////////////////////////////////////////
 ////
@@ -43,6 +51,14 @@ typedef CProEpollReactor  CProReactorImpl;
 typedef CProSelectReactor CProReactorImpl;
 #endif
 
+#define LOAD_SAMPLE_INTERVAL 1000 /* ms */
+#define LOAD_MOVE_INTERVAL   3000 /* ms, for the moved handler to settle down */
+#define LOAD_BUSY_HOT        700  /* permillage */
+#define LOAD_BUSY_GAP        200  /* permillage */
+#define LOAD_BUSY_SLACK      50   /* permillage */
+
+typedef void (CProTpReactorTask::* ACTION)(PRO_INT64*);
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -52,8 +68,17 @@ CProTpReactorTask::CProTpReactorTask()
     m_acceptThreadCount = 0;
     m_ioThreadCount     = 0;
     m_ioThreadPriority  = 0;
+    m_loadTimerId       = 0;
+    m_loadTick          = 0;
+    m_moveTick          = 0;
+    m_moveCount         = 0;
+    m_steerCount        = 0;
+    m_steerMissCount    = 0;
+    m_taskIndex         = 0;
     m_curThreadCount    = 0;
     m_wantExit          = false;
+
+    memset(&m_options, 0, sizeof(PRO_REACTOR_OPTIONS));
 }
 
 CProTpReactorTask::~CProTpReactorTask()
@@ -62,8 +87,9 @@ CProTpReactorTask::~CProTpReactorTask()
 }
 
 bool
-CProTpReactorTask::Start(unsigned long ioThreadCount,
-                         long          ioThreadPriority) /* = 0 */
+CProTpReactorTask::Start(unsigned long              ioThreadCount,
+                         long                       ioThreadPriority, /* = 0 */
+                         const PRO_REACTOR_OPTIONS* options)          /* = NULL */
 {{
     CProThreadMutexGuard mon(m_lockAtom);
 
@@ -89,33 +115,124 @@ CProTpReactorTask::Start(unsigned long ioThreadCount,
         m_ioThreadCount     = ioThreadCount; /* for Stop(...) */
         m_ioThreadPriority  = ioThreadPriority;
 
+        if (options != NULL)
+        {
+            m_options = *options;
+        }
+
+#if !defined(PRO_HAS_EPOLL)
+        m_options.edgeTriggered = false;
+#endif
+#if !defined(PRO_HAS_EPOLL) || !defined(PRO_HAS_IO_URING)
+        m_options.ioUring       = false;
+#endif
+#if defined(WIN32) || defined(_WIN32_WCE) || !defined(SO_REUSEPORT)
+        m_options.shardedAccept = false;
+#endif
+#if !defined(PRO_HAS_EPOLL)
+        m_options.busyPollUs    = 0;
+#endif
+#if !defined(PRO_HAS_EPOLL) || !defined(SO_BUSY_POLL)
+        m_options.sockBusyPoll  = false;
+#endif
+
+        /*
+         * cpus
+         */
+        if (m_options.ioCpus != NULL)
+        {
+            for (int i = 0; i < (int)m_ioThreadCount; ++i)
+            {
+                m_ioCpus.push_back(m_options.ioCpus[i]);
+            }
+        }
+        else if (m_options.cpuAffinity)
+        {
+            CProStlVector<unsigned long> cpus;
+            cpus.resize(m_ioThreadCount);
+
+            const unsigned long cpuCount = ProGetCoreCpus(&cpus[0], m_ioThreadCount);
+
+            for (int i = 0; i < (int)m_ioThreadCount && cpuCount > 0; ++i)
+            {
+                m_ioCpus.push_back((long)cpus[i % cpuCount]);
+            }
+        }
+
+        m_options.ioCpus = NULL; /* not owned */
+
         /*
          * reactors
          */
         {
-            m_acceptReactor = new CProReactorImpl;
-            if (!m_acceptReactor->Init())
+            m_acceptReactor = CreateReactor_i();
+            if (m_acceptReactor == NULL)
             {
                 goto EXIT;
             }
 
+            /*
+             * each reactor is built on the cpus of its thread, so its memory
+             * is first touched on the local numa node
+             */
+            CProStlVector<unsigned long> callerCpus;
+            if (m_ioCpus.size() > 0)
+            {
+                callerCpus.resize(ProGetThreadAffinity());
+                if (callerCpus.size() > 0)
+                {
+                    const unsigned long cpuCount =
+                        ProGetThreadAffinity(&callerCpus[0], (unsigned long)callerCpus.size());
+                    if (cpuCount < callerCpus.size())
+                    {
+                        callerCpus.resize(cpuCount);
+                    }
+                }
+            }
+
             for (int i = 0; i < (int)m_ioThreadCount; ++i)
             {
-                CProBaseReactor* const reactor = new CProReactorImpl;
-                if (!reactor->Init())
+                if (callerCpus.size() > 0 && m_ioCpus[i] >= 0)
+                {
+                    const unsigned long cpu = m_ioCpus[i];
+                    ProSetThreadAffinity(&cpu, 1);
+                }
+
+                CProBaseReactor* const reactor = CreateReactor_i();
+                if (reactor == NULL)
                 {
-                    delete reactor;
                     break;
                 }
 
                 m_ioReactors.push_back(reactor);
             }
 
+            if (callerCpus.size() > 0)
+            {
+                ProSetThreadAffinity(&callerCpus[0], (unsigned long)callerCpus.size());
+            }
+
             assert(m_ioReactors.size() == m_ioThreadCount);
             if (m_ioReactors.size() != m_ioThreadCount)
             {
                 goto EXIT;
             }
+
+            /*
+             * the reactors without timer support fall back to m_timerFactory
+             */
+            if (m_options.reactorTimers)
+            {
+                for (int j = 0; j < (int)m_ioThreadCount; ++j)
+                {
+                    m_ioReactors[j]->InitTimers(m_options.timingWheel);
+                }
+            }
+
+            for (int k = 0; k < (int)m_ioThreadCount; ++k)
+            {
+                m_ioReactors[k]->SetBusyPoll(m_options.busyPollUs);
+            }
         }
 
         /*
@@ -142,7 +259,9 @@ CProTpReactorTask::Start(unsigned long ioThreadCount,
         /*
          * timer factories
          */
-        if (!m_timerFactory.Start(false) || !m_mmTimerFactory.Start(true))
+        if (!m_timerFactory.Start(false, m_options.timingWheel)
+            ||
+            !m_mmTimerFactory.Start(true, m_options.timingWheel))
         {
             goto EXIT;
         }
@@ -151,6 +270,27 @@ CProTpReactorTask::Start(unsigned long ioThreadCount,
         {
             m_initCond.Wait(&m_lock);
         }
+
+        /*
+         * crypto threads
+         */
+        if (m_options.sslCryptoThreads > 0 &&
+            !m_cryptoPool.Start(m_options.sslCryptoThreads, m_options.sslMaxHandshakes))
+        {
+            goto EXIT;
+        }
+
+        /*
+         * loads
+         */
+        if (m_options.loadBalance)
+        {
+            m_ioLoads.resize(m_ioThreadCount);
+
+            m_loadTick    = ProGetTickCount64();
+            m_moveTick    = m_loadTick;
+            m_loadTimerId = m_timerFactory.ScheduleTimer(this, LOAD_SAMPLE_INTERVAL, true, 0);
+        }
     }
 
     return (true);
@@ -170,9 +310,43 @@ CProTpReactorTask::Stop()
     StopMe();
 }}
 
+CProBaseReactor*
+CProTpReactorTask::CreateReactor_i()
+{
+#if defined(PRO_HAS_EPOLL) && defined(PRO_HAS_IO_URING)
+    if (m_options.ioUring)
+    {
+        CProBaseReactor* const reactor = new CProUringReactor;
+        if (reactor->Init())
+        {
+            return (reactor);
+        }
+
+        delete reactor;
+        m_options.ioUring = false;
+    }
+#endif
+
+    CProBaseReactor* const reactor = new CProReactorImpl;
+    if (!reactor->Init())
+    {
+        delete reactor;
+
+        return (NULL);
+    }
+
+    return (reactor);
+}
+
 void
 CProTpReactorTask::StopMe()
 {{
+    /*
+     * the queued crypto jobs register their handlers again, so it goes
+     * first and without the lock
+     */
+    m_cryptoPool.Stop();
+
     {
         CProThreadMutexGuard mon(m_lock);
 
@@ -217,16 +391,294 @@ CProTpReactorTask::StopMe()
         }
 
         m_ioReactors.clear();
+        m_ioCpus.clear();
+        m_ioLoads.clear();
 
         m_acceptReactor     = NULL;
         m_acceptThreadCount = 0;
         m_ioThreadCount     = 0;
         m_ioThreadPriority  = 0;
+        m_loadTimerId       = 0;
+        m_loadTick          = 0;
+        m_moveTick          = 0;
+        m_moveCount         = 0;
+        m_steerCount        = 0;
+        m_steerMissCount    = 0;
+        m_taskIndex         = 0;
         m_curThreadCount    = 0;
         m_wantExit          = false;
+
+        memset(&m_options, 0, sizeof(PRO_REACTOR_OPTIONS));
     }
 }}
 
+long
+CProTpReactorTask::GetFlowCpu_i(PRO_INT64 sockId) const
+{
+    if (m_options.flowCpu != NULL)
+    {
+        return (m_options.flowCpu(sockId));
+    }
+
+#if defined(SO_INCOMING_CPU)
+    if (m_options.incomingCpu)
+    {
+        int cpu    = -1;
+        int optLen = sizeof(int);
+
+        /*
+         * it's the cpu that handled the last packet of the socket
+         */
+        if (pbsd_getsockopt(sockId, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &optLen) == 0)
+        {
+            return (cpu);
+        }
+    }
+#endif
+
+    return (-1);
+}
+
+CProBaseReactor*
+CProTpReactorTask::SelectReactor_i(PRO_INT64 sockId)
+{
+    if ((m_options.incomingCpu || m_options.flowCpu != NULL) && m_ioCpus.size() > 0)
+    {
+        const long cpu = GetFlowCpu_i(sockId);
+        if (cpu >= 0)
+        {
+            int       i = 0;
+            const int c = (int)m_ioCpus.size();
+
+            for (; i < c; ++i)
+            {
+                if (m_ioCpus[i] == cpu)
+                {
+                    ++m_steerCount;
+
+                    return (m_ioReactors[i]);
+                }
+            }
+        }
+
+        ++m_steerMissCount;
+    }
+
+    int           index = 0;
+    unsigned long count = m_ioReactors[0]->GetHandlerCount();
+
+    if (!m_options.loadBalance)
+    {
+        int       i = 1;
+        const int c = (int)m_ioReactors.size();
+
+        for (; i < c; ++i)
+        {
+            const unsigned long count2 = m_ioReactors[i]->GetHandlerCount();
+            if (count2 < count)
+            {
+                index = i;
+                count = count2;
+            }
+        }
+
+        return (m_ioReactors[index]);
+    }
+
+    /*
+     * the loads within LOAD_BUSY_SLACK are considered equal, and then the
+     * handler count decides
+     */
+    unsigned long load       = m_ioLoads[0].busy + m_ioLoads[0].charge;
+    unsigned long totalBusy  = m_ioLoads[0].busy;
+    unsigned long totalCount = count - 1; /* exclude the signal socket */
+
+    int       i = 1;
+    const int c = (int)m_ioReactors.size();
+
+    for (; i < c; ++i)
+    {
+        const unsigned long count2 = m_ioReactors[i]->GetHandlerCount();
+        const unsigned long load2  = m_ioLoads[i].busy + m_ioLoads[i].charge;
+
+        totalBusy  += m_ioLoads[i].busy;
+        totalCount += count2 - 1;
+
+        if (load2 + LOAD_BUSY_SLACK < load
+            ||
+            (load2 < load + LOAD_BUSY_SLACK && count2 < count))
+        {
+            index = i;
+            count = count2;
+            load  = load2;
+        }
+    }
+
+    /*
+     * the reactor is charged with the average busy of a handler until the
+     * next sample, so a burst of the new handlers isn't put on one reactor
+     */
+    if (totalCount > 0)
+    {
+        m_ioLoads[index].charge += totalBusy / totalCount;
+    }
+
+    return (m_ioReactors[index]);
+}
+
+void
+CProTpReactorTask::MoveHandler_i(PRO_INT64* args)
+{
+    CProEventHandler* const handler = (CProEventHandler*)args[0];
+    const PRO_INT64         sockId  = args[1];
+    CProBaseReactor* const  from    = (CProBaseReactor*)args[2];
+    CProBaseReactor* const  to      = (CProBaseReactor*)args[3];
+
+    bool          moved      = false;
+    unsigned long raisedMask = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (!m_wantExit && handler->GetReactor() == from)
+        {
+            const unsigned long mask = handler->GetMask() & ~PRO_MASK_ACCEPT;
+
+            /*
+             * a descriptor can be in two epoll sets for a moment, but the
+             * upcalls of the old reactor are over
+             */
+            if (mask != 0 && to->AddHandler(sockId, handler, mask))
+            {
+                from->RemoveHandler(sockId, mask);
+                raisedMask = from->DropRaisedEvents(sockId);
+                handler->SetReactor(to);
+
+                ++m_moveCount;
+                moved = true;
+            }
+        }
+    }
+
+    if (moved)
+    {
+        if (raisedMask != 0)
+        {
+            to->RaiseEvent(sockId, handler, raisedMask);
+        }
+
+        handler->OnReactorMoved();
+    }
+
+    handler->Release();
+}
+
+void
+PRO_CALLTYPE
+CProTpReactorTask::OnTimer(unsigned long timerId,
+                           PRO_INT64     userData)
+{
+    CProThreadMutexGuard mon(m_lock);
+
+    if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+        m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
+    {
+        return;
+    }
+
+    if (timerId != m_loadTimerId)
+    {
+        return;
+    }
+
+    const PRO_INT64 tick = ProGetTickCount64();
+    const PRO_INT64 span = tick - m_loadTick;
+    if (span <= 0)
+    {
+        return;
+    }
+
+    m_loadTick = tick;
+
+    int hot  = 0;
+    int cool = 0;
+
+    int       i = 0;
+    const int c = (int)m_ioReactors.size();
+
+    for (; i < c; ++i)
+    {
+        PRO_REACTOR_LOAD& load    = m_ioLoads[i];
+        const PRO_INT64   cpuTime = m_ioReactors[i]->GetCpuTime();
+
+        load.busy = 0;
+        if (cpuTime >= 0 && load.cpuTime >= 0 && cpuTime > load.cpuTime)
+        {
+            load.busy = (unsigned long)((cpuTime - load.cpuTime) / span); /* us/ms */
+            if (load.busy > 1000)
+            {
+                load.busy = 1000;
+            }
+        }
+
+        load.cpuTime = cpuTime;
+        load.ioBytes = m_ioReactors[i]->SampleIoBytes();
+        load.charge  = 0;
+
+        if (load.busy > m_ioLoads[hot].busy)
+        {
+            hot = i;
+        }
+        if (load.busy < m_ioLoads[cool].busy)
+        {
+            cool = i;
+        }
+    }
+
+    const PRO_REACTOR_LOAD& hotLoad  = m_ioLoads[hot];
+    const PRO_REACTOR_LOAD& coolLoad = m_ioLoads[cool];
+
+    if (tick - m_moveTick < LOAD_MOVE_INTERVAL || hotLoad.ioBytes == 0 ||
+        hotLoad.busy < LOAD_BUSY_HOT || hotLoad.busy < coolLoad.busy + LOAD_BUSY_GAP)
+    {
+        return;
+    }
+
+    /*
+     * the busy of a handler is estimated by its share of the bytes. the
+     * best one to move takes a half of the gap, and one taking the whole
+     * gap or more only moves the problem
+     */
+    const PRO_UINT64 gap        = hotLoad.busy - coolLoad.busy;
+    const PRO_UINT64 ioBytes    = hotLoad.ioBytes * gap / hotLoad.busy / 2;
+    const PRO_UINT64 maxIoBytes = hotLoad.ioBytes * gap / hotLoad.busy;
+
+    PRO_INT64               sockId  = -1;
+    CProEventHandler* const handler =
+        m_ioReactors[hot]->FindHandlerByIoBytes(ioBytes, maxIoBytes, sockId);
+    if (handler == NULL)
+    {
+        return;
+    }
+
+    m_moveTick = tick;
+
+    IProFunctorCommand* const command =
+        CProFunctorCommand_cpp<CProTpReactorTask, ACTION>::CreateInstance(
+        *this,
+        &CProTpReactorTask::MoveHandler_i,
+        (PRO_INT64)handler,
+        sockId,
+        (PRO_INT64)m_ioReactors[hot],
+        (PRO_INT64)m_ioReactors[cool]
+        );
+    if (!m_ioReactors[hot]->PostCommand(command))
+    {
+        command->Destroy();
+        handler->Release();
+    }
+}
+
 bool
 CProTpReactorTask::AddHandler(PRO_INT64         sockId,
                               CProEventHandler* handler,
@@ -261,22 +713,37 @@ CProTpReactorTask::AddHandler(PRO_INT64         sockId,
         }
 
         CProBaseReactor* reactor = handler->GetReactor();
-        if (reactor == NULL)
+        if (reactor == NULL && m_options.shardedAccept)
         {
-            reactor = m_ioReactors[0];
-
-            int       i = 1;
-            const int c = (int)m_ioReactors.size();
-
-            for (; i < c; ++i)
+            /*
+             * the connections accepted by a sharded acceptor stay in the
+             * I/O thread that accepted them
+             */
+            CProStlMap<PRO_UINT64, CProBaseReactor*>::const_iterator const itr =
+                m_threadId2IoReactor.find(ProGetThreadId());
+            if (itr != m_threadId2IoReactor.end())
             {
-                if (m_ioReactors[i]->GetHandlerCount() < reactor->GetHandlerCount())
-                {
-                    reactor = m_ioReactors[i];
-                }
+                reactor = itr->second;
             }
         }
 
+        if (reactor == NULL && !PRO_BIT_ENABLED(mask, PRO_MASK_ACCEPT))
+        {
+            reactor = SelectReactor_i(sockId);
+        }
+
+#if defined(SO_BUSY_POLL)
+        if (m_options.sockBusyPoll && m_options.busyPollUs > 0 &&
+            handler->GetReactor() == NULL && !PRO_BIT_ENABLED(mask, PRO_MASK_ACCEPT))
+        {
+            /*
+             * it fails without CAP_NET_ADMIN, which is harmless
+             */
+            const int option = (int)m_options.busyPollUs;
+            pbsd_setsockopt(sockId, SOL_SOCKET, SO_BUSY_POLL, &option, sizeof(int));
+        }
+#endif
+
         if (PRO_BIT_ENABLED(mask, PRO_MASK_ACCEPT))
         {
             ret = m_acceptReactor->AddHandler(sockId, handler, PRO_MASK_ACCEPT);
@@ -350,14 +817,19 @@ CProTpReactorTask::RemoveHandler(PRO_INT64         sockId,
     }
 }
 
-unsigned long
-PRO_CALLTYPE
-CProTpReactorTask::ScheduleTimer(IProOnTimer* onTimer,
-                                 PRO_UINT64   timeSpan,
-                                 bool         recurring,
-                                 PRO_INT64    userData) /* = 0 */
+bool
+CProTpReactorTask::RaiseHandlerEvent(PRO_INT64         sockId,
+                                     CProEventHandler* handler,
+                                     unsigned long     mask)
 {
-    unsigned long timerId = 0;
+    assert(sockId != -1);
+    assert(handler != NULL);
+    if (sockId == -1 || handler == NULL)
+    {
+        return (false);
+    }
+
+    bool ret = false;
 
     {
         CProThreadMutexGuard mon(m_lock);
@@ -365,42 +837,386 @@ CProTpReactorTask::ScheduleTimer(IProOnTimer* onTimer,
         if (m_acceptThreadCount + m_ioThreadCount == 0 ||
             m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
         {
-            return (0);
+            return (false);
         }
 
-        timerId = m_timerFactory.ScheduleTimer(onTimer, timeSpan, recurring, userData);
+        if (PRO_BIT_ENABLED(mask, PRO_MASK_ACCEPT))
+        {
+            ret = m_acceptReactor->RaiseEvent(sockId, handler, PRO_MASK_READ);
+
+            /*
+             * a shard of a sharded acceptor. only the reactor holding the
+             * socket accepts that
+             */
+            int       i = 0;
+            const int c = m_options.shardedAccept ? (int)m_ioReactors.size() : 0;
+
+            for (; i < c && !ret; ++i)
+            {
+                ret = m_ioReactors[i]->RaiseEvent(sockId, handler, PRO_MASK_READ);
+            }
+        }
+        else
+        {
+            CProBaseReactor* const reactor = handler->GetReactor();
+            if (reactor != NULL)
+            {
+                ret = reactor->RaiseEvent(sockId, handler, mask);
+            }
+        }
     }
 
-    return (timerId);
+    return (ret);
 }
 
 unsigned long
-PRO_CALLTYPE
-CProTpReactorTask::ScheduleHeartbeatTimer(IProOnTimer* onTimer,
-                                          PRO_INT64    userData) /* = 0 */
+CProTpReactorTask::GetAcceptShardCount() const
 {
-    unsigned long timerId = 0;
+    unsigned long shardCount = 0;
 
     {
         CProThreadMutexGuard mon(m_lock);
 
-        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
-            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
+        if (m_options.shardedAccept)
         {
-            return (0);
+            shardCount = (unsigned long)m_ioReactors.size();
         }
-
-        timerId = m_timerFactory.ScheduleHeartbeatTimer(onTimer, userData);
     }
 
-    return (timerId);
+    return (shardCount);
 }
 
 bool
-PRO_CALLTYPE
-CProTpReactorTask::UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds)
+CProTpReactorTask::AddAcceptShard(PRO_INT64         sockId,
+                                  CProEventHandler* handler,
+                                  unsigned long     shardIndex)
 {
-    bool ret = false;
+    assert(sockId != -1);
+    assert(handler != NULL);
+    if (sockId == -1 || handler == NULL)
+    {
+        return (false);
+    }
+
+    bool ret = false;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
+        {
+            return (false);
+        }
+
+        if (!m_options.shardedAccept || shardIndex >= m_ioReactors.size())
+        {
+            return (false);
+        }
+
+#if defined(SO_INCOMING_CPU)
+        /*
+         * the kernel prefers the SO_REUSEPORT socket of the receiving cpu
+         */
+        if (m_options.incomingCpu && shardIndex < m_ioCpus.size() &&
+            m_ioCpus[shardIndex] >= 0)
+        {
+            int cpu = (int)m_ioCpus[shardIndex];
+            pbsd_setsockopt(sockId, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(int));
+        }
+#endif
+
+        ret = m_ioReactors[shardIndex]->AddHandler(sockId, handler, PRO_MASK_ACCEPT);
+        if (ret)
+        {
+            handler->AddMask(PRO_MASK_ACCEPT);
+        }
+    }
+
+    return (ret);
+}
+
+void
+CProTpReactorTask::RemoveAcceptShard(PRO_INT64         sockId,
+                                     CProEventHandler* handler,
+                                     unsigned long     shardIndex)
+{
+    if (sockId == -1 || handler == NULL)
+    {
+        return;
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount)
+        {
+            return;
+        }
+
+        if (shardIndex >= m_ioReactors.size())
+        {
+            return;
+        }
+
+        m_ioReactors[shardIndex]->RemoveHandler(sockId, PRO_MASK_ACCEPT);
+    }
+}
+
+bool
+CProTpReactorTask::IsEdgeTriggered() const
+{
+    bool edgeTriggered = false;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        edgeTriggered = m_options.edgeTriggered;
+    }
+
+    return (edgeTriggered);
+}
+
+bool
+CProTpReactorTask::IsDirectWrite() const
+{
+    bool directWrite = false;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        directWrite = m_options.directWrite;
+    }
+
+    return (directWrite);
+}
+
+unsigned long
+CProTpReactorTask::GetSendQueueSize() const
+{
+    unsigned long sendQueueSize = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        sendQueueSize = m_options.sendQueueSize;
+    }
+
+    return (sendQueueSize);
+}
+
+bool
+CProTpReactorTask::IsUdpOffload() const
+{
+    bool udpOffload = false;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        udpOffload = m_options.udpOffload;
+    }
+
+    return (udpOffload);
+}
+
+unsigned long
+CProTpReactorTask::GetUdpBatchSize() const
+{
+    unsigned long udpBatchSize = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        udpBatchSize = m_options.udpBatchSize;
+    }
+
+    return (udpBatchSize);
+}
+
+CProSslCryptoPool*
+CProTpReactorTask::GetSslCryptoPool()
+{
+    CProSslCryptoPool* cryptoPool = NULL;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_options.sslCryptoThreads > 0)
+        {
+            cryptoPool = &m_cryptoPool;
+        }
+    }
+
+    return (cryptoPool);
+}
+
+unsigned long
+CProTpReactorTask::ScheduleHandlerTimer(CProEventHandler* handler,
+                                        PRO_UINT64        timeSpan,
+                                        bool              recurring,
+                                        PRO_INT64         userData) /* = 0 */
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
+        {
+            return (0);
+        }
+
+        CProBaseReactor* const reactor = handler->GetReactor();
+        if (reactor != NULL && m_options.reactorTimers)
+        {
+            timerId = reactor->ScheduleTimer(handler, timeSpan, recurring, userData);
+            if (timerId != 0)
+            {
+                handler->SetTimerReactor(reactor);
+
+                return (timerId);
+            }
+        }
+
+        timerId = m_timerFactory.ScheduleTimer(handler, timeSpan, recurring, userData);
+    }
+
+    return (timerId);
+}
+
+unsigned long
+CProTpReactorTask::ScheduleHandlerHeartbeatTimer(CProEventHandler* handler,
+                                                 PRO_INT64         userData) /* = 0 */
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
+        {
+            return (0);
+        }
+
+        /*
+         * the handlers share the group timers of the heartbeat slots
+         */
+        PRO_HEARTBEAT_ENTRY* const entry   = handler->GetHeartbeatEntry();
+        CProBaseReactor* const     reactor = handler->GetReactor();
+        if (reactor != NULL && m_options.reactorTimers)
+        {
+            timerId = reactor->JoinHeartbeatGroup(entry, handler, userData);
+            if (timerId != 0)
+            {
+                handler->SetTimerReactor(reactor);
+
+                return (timerId);
+            }
+        }
+
+        timerId = m_timerFactory.JoinHeartbeatGroup(entry, handler, userData);
+    }
+
+    return (timerId);
+}
+
+void
+CProTpReactorTask::CancelHandlerTimer(CProEventHandler* handler,
+                                      unsigned long     timerId)
+{
+    if (timerId == 0)
+    {
+        return;
+    }
+
+    CProBaseReactor* reactor = NULL;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount)
+        {
+            return;
+        }
+
+        reactor = handler->GetTimerReactor();
+    }
+
+    /*
+     * the reactors live until Stop(), and the cancellation may release
+     * the last reference of the handler. so no lock here
+     */
+    PRO_HEARTBEAT_ENTRY* const entry = handler->GetHeartbeatEntry();
+
+    if (reactor != NULL)
+    {
+        if (reactor->LeaveHeartbeatGroup(entry, timerId) || reactor->CancelTimer(timerId))
+        {
+            return;
+        }
+    }
+
+    if (!m_timerFactory.LeaveHeartbeatGroup(entry, timerId))
+    {
+        m_timerFactory.CancelTimer(timerId);
+    }
+}
+
+unsigned long
+PRO_CALLTYPE
+CProTpReactorTask::ScheduleTimer(IProOnTimer* onTimer,
+                                 PRO_UINT64   timeSpan,
+                                 bool         recurring,
+                                 PRO_INT64    userData) /* = 0 */
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
+        {
+            return (0);
+        }
+
+        timerId = m_timerFactory.ScheduleTimer(onTimer, timeSpan, recurring, userData);
+    }
+
+    return (timerId);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProTpReactorTask::ScheduleHeartbeatTimer(IProOnTimer* onTimer,
+                                          PRO_INT64    userData) /* = 0 */
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
+        {
+            return (0);
+        }
+
+        timerId = m_timerFactory.ScheduleHeartbeatTimer(onTimer, userData);
+    }
+
+    return (timerId);
+}
+
+bool
+PRO_CALLTYPE
+CProTpReactorTask::UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds)
+{
+    bool ret = false;
 
     {
         CProThreadMutexGuard mon(m_lock);
@@ -412,6 +1228,11 @@ CProTpReactorTask::UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds)
         }
 
         ret = m_timerFactory.UpdateHeartbeatTimers(htbtIntervalInSeconds);
+
+        for (int i = 0; i < (int)m_ioThreadCount; ++i)
+        {
+            m_ioReactors[i]->UpdateHeartbeatTimers(htbtIntervalInSeconds);
+        }
     }
 
     return (ret);
@@ -475,6 +1296,103 @@ CProTpReactorTask::CancelMmTimer(unsigned long timerId)
     }
 }
 
+unsigned long
+PRO_CALLTYPE
+CProTpReactorTask::PostTask(IProOnTimer* onTimer,
+                            PRO_INT64    userData) /* = 0 */
+{
+    assert(onTimer != NULL);
+    if (onTimer == NULL)
+    {
+        return (0);
+    }
+
+    unsigned long taskId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_acceptThreadCount + m_ioThreadCount == 0 ||
+            m_curThreadCount != m_acceptThreadCount + m_ioThreadCount || m_wantExit)
+        {
+            return (0);
+        }
+
+        /*
+         * a task posted by an I/O thread stays in that thread
+         */
+        CProBaseReactor* reactor = NULL;
+
+        CProStlMap<PRO_UINT64, CProBaseReactor*>::const_iterator const itr =
+            m_threadId2IoReactor.find(ProGetThreadId());
+        if (itr != m_threadId2IoReactor.end())
+        {
+            reactor = itr->second;
+        }
+        else
+        {
+            reactor = m_ioReactors[m_taskIndex % m_ioReactors.size()];
+            ++m_taskIndex;
+        }
+
+        taskId = ProMakeTimerId(); /* shared with the timers */
+        if (!reactor->PostTask(onTimer, taskId, userData))
+        {
+            taskId = 0;
+        }
+    }
+
+    return (taskId);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProTpReactorTask::PostTaskToTransport(IProTransport* trans,
+                                       IProOnTimer*   onTimer,
+                                       PRO_INT64      userData) /* = 0 */
+{
+    assert(trans != NULL);
+    assert(onTimer != NULL);
+    if (trans == NULL || onTimer == NULL)
+    {
+        return (0);
+    }
+
+    CProEventHandler*    handler = NULL;
+    const PRO_TRANS_TYPE type    = trans->GetType();
+
+    if (type == PRO_TRANS_TCP || type == PRO_TRANS_SSL)
+    {
+        handler = (CProTcpTransport*)trans;
+    }
+    else if (type == PRO_TRANS_UDP || type == PRO_TRANS_MCAST)
+    {
+        handler = (CProUdpTransport*)trans;
+    }
+    else
+    {
+    }
+
+    /*
+     * no "m_lock" here. the reactor of the handler is read once, and lives
+     * until Stop(). a handler being moved may get the task in its old
+     * reactor, which is still an I/O thread of ours
+     */
+    CProBaseReactor* const reactor = handler != NULL ? handler->GetReactor() : NULL;
+    if (reactor == NULL)
+    {
+        return (PostTask(onTimer, userData));
+    }
+
+    const unsigned long taskId = ProMakeTimerId(); /* shared with the timers */
+    if (!reactor->PostTask(onTimer, taskId, userData))
+    {
+        return (0);
+    }
+
+    return (taskId);
+}
+
 void
 PRO_CALLTYPE
 CProTpReactorTask::GetTraceInfo(char*  buf,
@@ -506,12 +1424,20 @@ CProTpReactorTask::GetTraceInfo(char*  buf,
             --value; /* exclude the signal socket */
         }
 
+#if defined(PRO_HAS_EPOLL)
+        const char* const model = m_options.ioUring ? "io_uring" : "epoll";
+#else
+        const char* const model = "select";
+#endif
+
         sprintf(
             theBuf,
+            " [ I/O Model ] : %s \n"
             " [I/O Threads] : %d \n"
             " [I/O Sockets] : %d \n"
             " %d "
             ,
+            model,
             (int)m_ioThreadCount,
             value,
             (int)m_ioReactors[0]->GetHandlerCount() - 1
@@ -527,6 +1453,12 @@ CProTpReactorTask::GetTraceInfo(char*  buf,
         theInfo += "\n";
 
         value = (int)m_timerFactory.GetTimerCount();
+
+        for (int l = 0; l < (int)m_ioThreadCount; ++l)
+        {
+            value += (int)m_ioReactors[l]->GetTimerCount();
+        }
+
         sprintf(theBuf, " [ ST Timers ] : %d \n", value);
         theInfo += theBuf;
 
@@ -538,6 +1470,127 @@ CProTpReactorTask::GetTraceInfo(char*  buf,
         sprintf(theBuf, " [ HTBT Time ] : %d \n", value);
         theInfo += theBuf;
 
+        PRO_UINT64 wakeups   = 0;
+        PRO_UINT64 coalesced = 0;
+
+        for (int m = 0; m < (int)m_ioThreadCount; ++m)
+        {
+            PRO_UINT64 wakeups2   = 0;
+            PRO_UINT64 coalesced2 = 0;
+            m_ioReactors[m]->GetWakeupCounts(wakeups2, coalesced2);
+
+            wakeups   += wakeups2;
+            coalesced += coalesced2;
+        }
+
+        sprintf(
+            theBuf,
+            " [ I/O Wakes ] : %.0f (coalesced : %.0f) \n"
+            ,
+            (double)wakeups,
+            (double)coalesced
+            );
+        theInfo += theBuf;
+
+        if (m_options.loadBalance)
+        {
+            theInfo += " [ I/O Loads ] :";
+
+            for (int n = 0; n < (int)m_ioThreadCount; ++n)
+            {
+                sprintf(
+                    theBuf,
+                    "%s %d%% %dKB/s "
+                    ,
+                    n > 0 ? "+" : "",
+                    (int)(m_ioLoads[n].busy / 10),
+                    (int)(m_ioLoads[n].ioBytes * 1000 / LOAD_SAMPLE_INTERVAL / 1024)
+                    );
+                theInfo += theBuf;
+            }
+
+            sprintf(theBuf, "(moved : %.0f) \n", (double)m_moveCount);
+            theInfo += theBuf;
+        }
+
+        if (m_options.busyPollUs > 0)
+        {
+            PRO_UINT64 spins = 0;
+            PRO_UINT64 hits  = 0;
+
+            for (int n = 0; n < (int)m_ioThreadCount; ++n)
+            {
+                PRO_UINT64 spins2 = 0;
+                PRO_UINT64 hits2  = 0;
+                m_ioReactors[n]->GetBusyPollCounts(spins2, hits2);
+
+                spins += spins2;
+                hits  += hits2;
+            }
+
+            sprintf(
+                theBuf,
+                " [ Busy Poll ] : %.0f (hits : %.0f) \n"
+                ,
+                (double)spins,
+                (double)hits
+                );
+            theInfo += theBuf;
+        }
+
+        if (m_options.incomingCpu || m_options.flowCpu != NULL)
+        {
+            sprintf(
+                theBuf,
+                " [ I/O Steer ] : %.0f (fallback : %.0f) \n"
+                ,
+                (double)m_steerCount,
+                (double)m_steerMissCount
+                );
+            theInfo += theBuf;
+        }
+
+        if (m_options.sslCryptoThreads > 0)
+        {
+            m_cryptoPool.GetTraceInfo(theBuf, sizeof(theBuf));
+            theInfo += theBuf;
+        }
+
+        for (int k = 0; k < 10; ++k)
+        {
+            PRO_SGI_CLASS_STAT stat[60];
+            if (!ProGetSgiPoolStat(stat, k))
+            {
+                break;
+            }
+
+            unsigned long allocs    = 0;
+            unsigned long liveObjs  = 0;
+            size_t        liveBytes = 0;
+
+            for (int l = 0; l < 60; ++l)
+            {
+                allocs    += stat[l].allocs;
+                liveObjs  += stat[l].liveObjs;
+                liveBytes += stat[l].liveBytes;
+            }
+
+            if (allocs == 0)
+            {
+                continue;
+            }
+
+            sprintf(
+                theBuf,
+                " [ SGI Pool%d ] : %u objs, %u KB \n"
+                ,
+                k,
+                (unsigned int)liveObjs,
+                (unsigned int)(liveBytes / 1024)
+                );
+            theInfo += theBuf;
+        }
+
         strncpy_pro(buf, size, theInfo.c_str());
     }
 }
@@ -554,11 +1607,17 @@ CProTpReactorTask::Svc()
 
         threadCount = ++m_curThreadCount;
         m_threadIds.insert(threadId);
+        if (threadCount > m_acceptThreadCount)
+        {
+            m_threadId2IoReactor[threadId] = m_ioReactors[threadCount - 2];
+        }
         m_initCond.Signal();
     }
 
     if (threadCount <= m_acceptThreadCount)
     {
+        ProSetThreadName("pro_accept");
+
         m_acceptReactor->WorkerRun();
     }
     else
@@ -567,12 +1626,25 @@ CProTpReactorTask::Svc()
         ::SetThreadPriority(::GetCurrentThread(), m_ioThreadPriority);
 #endif
 
-        m_ioReactors[threadCount - 2]->WorkerRun();
+        const int index = (int)threadCount - 2;
+
+        char threadName[32] = "";
+        sprintf(threadName, "pro_io_%d", index);
+        ProSetThreadName(threadName);
+
+        if (index < (int)m_ioCpus.size() && m_ioCpus[index] >= 0)
+        {
+            const unsigned long cpu = m_ioCpus[index];
+            ProSetThreadAffinity(&cpu, 1);
+        }
+
+        m_ioReactors[index]->WorkerRun();
     }
 
     {
         CProThreadMutexGuard mon(m_lock);
 
         m_threadIds.erase(threadId);
+        m_threadId2IoReactor.erase(threadId);
     }
 }
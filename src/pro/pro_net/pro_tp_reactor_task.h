@@ -24,6 +24,7 @@
 #define PRO_TP_REACTOR_TASK_H
 
 #include "pro_net.h"
+#include "pro_ssl_crypto_pool.h"
 #include "../pro_util/pro_stl.h"
 #include "../pro_util/pro_thread.h"
 #include "../pro_util/pro_thread_mutex.h"
@@ -35,10 +36,26 @@
 class CProBaseReactor;
 class CProEventHandler;
 
+struct PRO_REACTOR_LOAD
+{
+    PRO_REACTOR_LOAD()
+    {
+        cpuTime = -1;
+        busy    = 0;
+        ioBytes = 0;
+        charge  = 0;
+    }
+
+    PRO_INT64     cpuTime; /* the cpu time of the last sample, in microseconds */
+    unsigned long busy;    /* the permillage of the cpu time in the last interval */
+    PRO_UINT64    ioBytes; /* the bytes in the last interval */
+    unsigned long charge;  /* the estimated busy of the handlers added since then */
+};
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
-class CProTpReactorTask : public IProReactor, public CProThreadBase
+class CProTpReactorTask : public IProReactor, public IProOnTimer, public CProThreadBase
 {
 public:
 
@@ -47,8 +64,9 @@ public:
     virtual ~CProTpReactorTask();
 
     bool Start(
-        unsigned long ioThreadCount,
-        long          ioThreadPriority /* = 0 */
+        unsigned long              ioThreadCount,
+        long                       ioThreadPriority, /* = 0 */
+        const PRO_REACTOR_OPTIONS* options           /* = NULL */
         );
 
     void Stop();
@@ -65,6 +83,70 @@ public:
         unsigned long     mask
         );
 
+    /*
+     * for the edge-triggered handlers. please refer to
+     * CProBaseReactor::RaiseEvent()
+     */
+    bool RaiseHandlerEvent(
+        PRO_INT64         sockId,
+        CProEventHandler* handler,
+        unsigned long     mask
+        );
+
+    /*
+     * with PRO_REACTOR_OPTIONS::shardedAccept, an acceptor listens on one
+     * SO_REUSEPORT socket per I/O reactor. returns 0 if it's disabled
+     */
+    unsigned long GetAcceptShardCount() const;
+
+    bool AddAcceptShard(
+        PRO_INT64         sockId,
+        CProEventHandler* handler,
+        unsigned long     shardIndex
+        );
+
+    void RemoveAcceptShard(
+        PRO_INT64         sockId,
+        CProEventHandler* handler,
+        unsigned long     shardIndex
+        );
+
+    bool IsEdgeTriggered() const;
+
+    bool IsDirectWrite() const;
+
+    unsigned long GetSendQueueSize() const;
+
+    bool IsUdpOffload() const;
+
+    unsigned long GetUdpBatchSize() const;
+
+    /*
+     * NULL if PRO_REACTOR_OPTIONS::sslCryptoThreads is 0
+     */
+    CProSslCryptoPool* GetSslCryptoPool();
+
+    /*
+     * the timers of a handler run in the thread of its reactor if
+     * PRO_REACTOR_OPTIONS::reactorTimers is enabled
+     */
+    unsigned long ScheduleHandlerTimer(
+        CProEventHandler* handler,
+        PRO_UINT64        timeSpan,
+        bool              recurring,
+        PRO_INT64         userData /* = 0 */
+        );
+
+    unsigned long ScheduleHandlerHeartbeatTimer(
+        CProEventHandler* handler,
+        PRO_INT64         userData /* = 0 */
+        );
+
+    void CancelHandlerTimer(
+        CProEventHandler* handler,
+        unsigned long     timerId
+        );
+
     virtual unsigned long PRO_CALLTYPE ScheduleTimer(
         IProOnTimer* onTimer,
         PRO_UINT64   timeSpan,
@@ -92,27 +174,93 @@ public:
 
     virtual void PRO_CALLTYPE GetTraceInfo(char* buf, size_t size) const;
 
+    virtual unsigned long PRO_CALLTYPE PostTask(
+        IProOnTimer* onTimer,
+        PRO_INT64    userData /* = 0 */
+        );
+
+    virtual unsigned long PRO_CALLTYPE PostTaskToTransport(
+        IProTransport* trans,
+        IProOnTimer*   onTimer,
+        PRO_INT64      userData /* = 0 */
+        );
+
 private:
 
     void StopMe();
 
+    /*
+     * the io_uring reactor falls back to the default one if the kernel
+     * doesn't support it
+     */
+    CProBaseReactor* CreateReactor_i();
+
+    /*
+     * the I/O reactor for a new handler. it's the one bound to the cpu of the
+     * flow if known. with PRO_REACTOR_OPTIONS::loadBalance, it's the one with
+     * the lowest load, otherwise the one with the fewest handlers
+     */
+    CProBaseReactor* SelectReactor_i(PRO_INT64 sockId);
+
+    /*
+     * the cpu receiving the flow of the socket, or -1. please refer to
+     * PRO_REACTOR_OPTIONS::flowCpu and PRO_REACTOR_OPTIONS::incomingCpu
+     */
+    long GetFlowCpu_i(PRO_INT64 sockId) const;
+
+    /*
+     * runs in the thread of the old reactor
+     */
+    void MoveHandler_i(PRO_INT64* args);
+
+    virtual unsigned long PRO_CALLTYPE AddRef()
+    {
+        return (1);
+    }
+
+    virtual unsigned long PRO_CALLTYPE Release()
+    {
+        return (1);
+    }
+
+    /*
+     * samples the loads of the I/O reactors, and moves a handler from the
+     * busiest one to the idlest one if they're unbalanced
+     */
+    virtual void PRO_CALLTYPE OnTimer(
+        unsigned long timerId,
+        PRO_INT64     userData
+        );
+
     virtual void Svc();
 
 private:
 
-    CProBaseReactor*                m_acceptReactor;
-    CProStlVector<CProBaseReactor*> m_ioReactors;
-    CProTimerFactory                m_timerFactory;
-    CProTimerFactory                m_mmTimerFactory;
-    unsigned long                   m_acceptThreadCount;
-    unsigned long                   m_ioThreadCount;
-    long                            m_ioThreadPriority;
-    unsigned long                   m_curThreadCount;
-    bool                            m_wantExit;
-    CProStlSet<PRO_UINT64>          m_threadIds;
-    CProThreadMutexCondition        m_initCond;
-    mutable CProThreadMutex         m_lock;
-    CProThreadMutex                 m_lockAtom;
+    CProBaseReactor*                         m_acceptReactor;
+    CProStlVector<CProBaseReactor*>          m_ioReactors;
+    CProTimerFactory                         m_timerFactory;
+    CProTimerFactory                         m_mmTimerFactory;
+    CProSslCryptoPool                        m_cryptoPool;
+    unsigned long                            m_acceptThreadCount;
+    unsigned long                            m_ioThreadCount;
+    long                                     m_ioThreadPriority;
+    PRO_REACTOR_OPTIONS                      m_options;
+    CProStlVector<long>                      m_ioCpus; /* empty if unbound. < 0 for an unbound thread */
+    CProStlVector<PRO_REACTOR_LOAD>          m_ioLoads;
+    unsigned long                            m_loadTimerId;
+    PRO_INT64                                m_loadTick;
+    PRO_INT64                                m_moveTick;
+    PRO_UINT64                               m_moveCount;
+    PRO_UINT64                               m_steerCount;
+    PRO_UINT64                               m_steerMissCount;
+    unsigned long                            m_taskIndex; /* round-robin */
+    unsigned long                            m_curThreadCount;
+    bool                                     m_wantExit;
+    CProStlSet<PRO_UINT64>                   m_threadIds;
+    CProStlMap<PRO_UINT64, CProBaseReactor*> m_threadId2IoReactor;
+    CProThreadMutexCondition                 m_initCond;
+    mutable CProThreadMutex                  m_lock;
+    CProThreadMutex                          m_lockAtom;
 };
 
 /////////////////////////////////////////////////////////////////////////////
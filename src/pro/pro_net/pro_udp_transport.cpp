@@ -17,6 +17,7 @@
  */
 
 #include "pro_udp_transport.h"
+#include "pro_base_reactor.h"
 #include "pro_event_handler.h"
 #include "pro_net.h"
 #include "pro_recv_pool.h"
@@ -26,35 +27,68 @@
 #include "../pro_util/pro_z.h"
 #include <cassert>
 
+#if defined(PRO_HAS_MMSG)
+#include <netinet/udp.h>
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
 #define DEFAULT_RECV_BUF_SIZE  (1024 * 56)
 #define DEFAULT_SEND_BUF_SIZE  (1024 * 56)
 #define DEFAULT_RECV_POOL_SIZE (1024 * 65) /* EMSGSIZE */
+#define MAX_BATCH_SIZE         1024
+#define MAX_SEND_BATCH         64
+#define MAX_GSO_SEGMENTS       64
+#define MAX_GSO_SIZE           65507       /* 65535 - 20 - 8 */
+#define MTU_SLOT_SIZE          1472        /* 1500 - 20 - 8 */
+#define GRO_SLOT_SIZE          65535
+#define MAX_BATCH_BYTES        (1024 * 1024 * 2)
+
+#if defined(PRO_HAS_MMSG)
+#if !defined(SOL_UDP)
+#define SOL_UDP                17
+#endif
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT            103
+#endif
+#if !defined(UDP_GRO)
+#define UDP_GRO                104
+#endif
+#endif
 
 /////////////////////////////////////////////////////////////////////////////
 ////
 
 CProUdpTransport*
-CProUdpTransport::CreateInstance(size_t recvPoolSize)   /* = 0 */
+CProUdpTransport::CreateInstance(bool   batchUpcall,
+                                 size_t recvPoolSize) /* = 0 */
 {
-    CProUdpTransport* const trans = new CProUdpTransport(recvPoolSize);
+    CProUdpTransport* const trans = new CProUdpTransport(batchUpcall, recvPoolSize);
 
     return (trans);
 }
 
-CProUdpTransport::CProUdpTransport(size_t recvPoolSize) /* = 0 */
-: m_recvPoolSize(recvPoolSize > 0 ? recvPoolSize : DEFAULT_RECV_POOL_SIZE)
+CProUdpTransport::CProUdpTransport(bool   batchUpcall,
+                                   size_t recvPoolSize) /* = 0 */
+                                   :
+m_batchUpcall(batchUpcall),
+m_recvPoolSize(recvPoolSize > 0 ? recvPoolSize : DEFAULT_RECV_POOL_SIZE)
 {
     m_observer      = NULL;
     m_reactorTask   = NULL;
     m_sockId        = -1;
     m_timerId       = 0;
     m_onWr          = false;
+    m_recvSuspended = false;
     m_pendingWr     = false;
     m_requestOnSend = false;
     m_actionId      = 0;
+    m_batchSize     = 0;
+    m_batchSlotSize = 0;
+    m_gso           = false;
+    m_gro           = false;
+    m_gsoLimit      = MAX_GSO_SIZE;
 
     m_canUpcall     = true;
 
@@ -165,6 +199,15 @@ CProUdpTransport::Init(IProTransportObserver* observer,
             return (false);
         }
 
+        if (!InitBatch_i(sockId, reactorTask))
+        {
+            ProCloseSockId(sockId);
+
+            return (false);
+        }
+
+        SetEdgeTriggered(reactorTask->IsEdgeTriggered());
+
         if (!reactorTask->AddHandler(sockId, this, PRO_MASK_READ))
         {
             ProCloseSockId(sockId);
@@ -183,6 +226,69 @@ CProUdpTransport::Init(IProTransportObserver* observer,
     return (true);
 }
 
+bool
+CProUdpTransport::InitBatch_i(PRO_INT64          sockId,
+                              CProTpReactorTask* reactorTask)
+{
+    assert(sockId != -1);
+    assert(reactorTask != NULL);
+
+#if defined(PRO_HAS_MMSG)
+
+    unsigned long batchSize  = reactorTask->GetUdpBatchSize();
+    const bool    udpOffload = reactorTask->IsUdpOffload();
+
+    if (batchSize > MAX_BATCH_SIZE)
+    {
+        batchSize = MAX_BATCH_SIZE;
+    }
+
+    if (udpOffload)
+    {
+        int option    = 0;
+        int optionLen = sizeof(int);
+        m_gso = pbsd_getsockopt(sockId, SOL_UDP, UDP_SEGMENT, &option, &optionLen) == 0;
+
+        option = 1;
+        m_gro  = pbsd_setsockopt(sockId, SOL_UDP, UDP_GRO, &option, sizeof(int)) == 0;
+    }
+
+    if (m_gro && batchSize == 0)
+    {
+        batchSize = 1;
+    }
+
+    if (batchSize == 0)
+    {
+        return (true);
+    }
+
+    /*
+     * a slot holds one datagram of the path mtu, or a coalesced one of up
+     * to 64KB with UDP_GRO. the larger datagrams are truncated and dropped
+     */
+    size_t slotSize = m_gro ? GRO_SLOT_SIZE : MTU_SLOT_SIZE;
+    if (!m_gro && slotSize > m_recvPoolSize)
+    {
+        slotSize = m_recvPoolSize;
+    }
+
+    if (batchSize > MAX_BATCH_BYTES / slotSize)
+    {
+        batchSize = MAX_BATCH_BYTES / slotSize;
+    }
+
+    /*
+     * the slots themselves are taken from the reactor in OnInputBatch()
+     */
+    m_batchSize     = batchSize;
+    m_batchSlotSize = slotSize;
+
+#endif /* PRO_HAS_MMSG */
+
+    return (true);
+}
+
 void
 CProUdpTransport::Fini()
 {
@@ -196,7 +302,7 @@ CProUdpTransport::Fini()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_WRITE | PRO_MASK_READ);
@@ -355,6 +461,16 @@ CProUdpTransport::SendData(const void*             buf,
 
             m_onWr = true;
         }
+        else if (IsEdgeTriggered())
+        {
+            /*
+             * the write interest of an edge-triggered transport is armed once
+             */
+            if (!m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_WRITE))
+            {
+                return (false);
+            }
+        }
 
         pbsd_sendto(m_sockId, buf, (int)size, 0, realAddr);
         m_pendingWr = true;
@@ -364,6 +480,272 @@ CProUdpTransport::SendData(const void*             buf,
     return (true);
 }
 
+bool
+PRO_CALLTYPE
+CProUdpTransport::SendBuffer(IProSendBuffer*         sendBuf,
+                             const void*             buf,
+                             size_t                  size,
+                             PRO_UINT64              actionId,   /* = 0 */
+                             const pbsd_sockaddr_in* remoteAddr) /* = NULL */
+{
+    assert(sendBuf != NULL);
+    if (sendBuf == NULL)
+    {
+        return (false);
+    }
+
+    /*
+     * the datagram is sent at once, so no reference is held
+     */
+    return (SendData(buf, size, actionId, remoteAddr));
+}
+
+bool
+PRO_CALLTYPE
+CProUdpTransport::SendDataBatch(const PRO_DATAGRAM* datagrams,
+                                size_t              count,
+                                PRO_UINT64          actionId) /* = 0 */
+{
+    assert(datagrams != NULL);
+    assert(count > 0);
+    if (datagrams == NULL || count == 0)
+    {
+        return (false);
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_observer == NULL || m_reactorTask == NULL)
+        {
+            return (false);
+        }
+
+        if (m_pendingWr)
+        {
+            return (false);
+        }
+
+        if (!m_onWr)
+        {
+            if (!m_reactorTask->AddHandler(m_sockId, this, PRO_MASK_WRITE))
+            {
+                return (false);
+            }
+
+            m_onWr = true;
+        }
+        else if (IsEdgeTriggered())
+        {
+            if (!m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_WRITE))
+            {
+                return (false);
+            }
+        }
+
+        SendBatch_i(datagrams, count);
+        m_pendingWr = true;
+        m_actionId  = actionId;
+    }
+
+    return (true);
+}
+
+void
+CProUdpTransport::SendBatch_i(const PRO_DATAGRAM* datagrams,
+                              size_t              count)
+{
+#if defined(PRO_HAS_MMSG)
+
+    pbsd_mmsghdr msgs[MAX_SEND_BATCH];
+    pbsd_iovec   iovs[MAX_SEND_BATCH];
+    size_t       msgCount = 0;
+    size_t       i        = 0;
+
+    while (i < count)
+    {
+        const PRO_DATAGRAM&           datagram = datagrams[i];
+        const pbsd_sockaddr_in* const realAddr =
+            datagram.remoteAddr != NULL ? datagram.remoteAddr : &m_defaultRemoteAddr;
+        if (datagram.buf == NULL || datagram.size == 0 ||
+            realAddr->sin_addr.s_addr == 0 || realAddr->sin_port == 0)
+        {
+            ++i;
+            continue;
+        }
+
+        /*
+         * a run of equal-sized datagrams to the same address, of which only
+         * the last one may be shorter, goes out as one UDP_SEGMENT send
+         */
+        if (m_gso && datagram.size <= m_gsoLimit)
+        {
+            size_t runCount = 1;
+            size_t runSize  = datagram.size;
+
+            for (; i + runCount < count && runCount < MAX_GSO_SEGMENTS; ++runCount)
+            {
+                const PRO_DATAGRAM& next = datagrams[i + runCount];
+                const pbsd_sockaddr_in* const nextAddr =
+                    next.remoteAddr != NULL ? next.remoteAddr : &m_defaultRemoteAddr;
+                if (next.buf == NULL || next.size == 0 || next.size > datagram.size ||
+                    runSize + next.size > MAX_GSO_SIZE                                ||
+                    nextAddr->sin_addr.s_addr != realAddr->sin_addr.s_addr            ||
+                    nextAddr->sin_port != realAddr->sin_port)
+                {
+                    break;
+                }
+
+                runSize += next.size;
+                if (next.size < datagram.size)
+                {
+                    ++runCount;
+                    break;
+                }
+            }
+
+            if (runCount > 1)
+            {
+                SendMmsg_i(msgs, msgCount);
+                msgCount = 0;
+
+                if (SendGso_i(datagrams + i, runCount, realAddr))
+                {
+                    i += runCount;
+                    continue;
+                }
+            }
+        }
+
+        iovs[msgCount].iov_base = (void*)datagram.buf;
+        iovs[msgCount].iov_len  = datagram.size;
+
+        memset(&msgs[msgCount], 0, sizeof(pbsd_mmsghdr));
+        msgs[msgCount].msg_hdr.msg_name    = (void*)realAddr;
+        msgs[msgCount].msg_hdr.msg_namelen = sizeof(pbsd_sockaddr_in);
+        msgs[msgCount].msg_hdr.msg_iov     = &iovs[msgCount];
+        msgs[msgCount].msg_hdr.msg_iovlen  = 1;
+
+        ++msgCount;
+        ++i;
+
+        if (msgCount == MAX_SEND_BATCH)
+        {
+            SendMmsg_i(msgs, msgCount);
+            msgCount = 0;
+        }
+    }
+
+    SendMmsg_i(msgs, msgCount);
+
+#else  /* PRO_HAS_MMSG */
+
+    size_t i = 0;
+
+    for (; i < count; ++i)
+    {
+        const PRO_DATAGRAM&           datagram = datagrams[i];
+        const pbsd_sockaddr_in* const realAddr =
+            datagram.remoteAddr != NULL ? datagram.remoteAddr : &m_defaultRemoteAddr;
+        if (datagram.buf == NULL || datagram.size == 0 ||
+            realAddr->sin_addr.s_addr == 0 || realAddr->sin_port == 0)
+        {
+            continue;
+        }
+
+        pbsd_sendto(m_sockId, datagram.buf, (int)datagram.size, 0, realAddr);
+    }
+
+#endif /* PRO_HAS_MMSG */
+}
+
+#if defined(PRO_HAS_MMSG)
+
+bool
+CProUdpTransport::SendGso_i(const PRO_DATAGRAM*     datagrams,
+                            size_t                  count,
+                            const pbsd_sockaddr_in* realAddr)
+{
+    assert(count > 1 && count <= MAX_GSO_SEGMENTS);
+
+    pbsd_iovec iovs[MAX_GSO_SEGMENTS];
+    char       ctrl[CMSG_SPACE(sizeof(PRO_UINT16))];
+
+    size_t i = 0;
+
+    for (; i < count; ++i)
+    {
+        iovs[i].iov_base = (void*)datagrams[i].buf;
+        iovs[i].iov_len  = datagrams[i].size;
+    }
+
+    pbsd_msghdr msg;
+    memset(&msg, 0, sizeof(pbsd_msghdr));
+    memset(ctrl, 0, sizeof(ctrl));
+    msg.msg_name       = (void*)realAddr;
+    msg.msg_namelen    = sizeof(pbsd_sockaddr_in);
+    msg.msg_iov        = iovs;
+    msg.msg_iovlen     = count;
+    msg.msg_control    = ctrl;
+    msg.msg_controllen = sizeof(ctrl);
+
+    const PRO_UINT16 segSize = (PRO_UINT16)datagrams[0].size;
+
+    struct cmsghdr* const cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type  = UDP_SEGMENT;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(PRO_UINT16));
+    memcpy(CMSG_DATA(cmsg), &segSize, sizeof(PRO_UINT16));
+
+    if (pbsd_sendmsg(m_sockId, &msg, 0) >= 0)
+    {
+        return (true);
+    }
+
+    const int errorCode = pbsd_errno((void*)&pbsd_sendmsg);
+    if (errorCode == PBSD_EIO)
+    {
+        m_gso = false;      /* no checksum offload on the egress device */
+    }
+    else if (errorCode == PBSD_EINVAL)
+    {
+        m_gsoLimit = segSize - 1; /* the segment exceeds the path mtu */
+    }
+    else
+    {
+        return (true);      /* dropped as a plain datagram would be */
+    }
+
+    return (false);
+}
+
+void
+CProUdpTransport::SendMmsg_i(pbsd_mmsghdr* msgs,
+                             size_t        count)
+{
+    size_t sent = 0;
+
+    while (sent < count)
+    {
+        const int retc = pbsd_sendmmsg(m_sockId, msgs + sent, (unsigned int)(count - sent), 0);
+        if (retc > 0)
+        {
+            sent += retc;
+            continue;
+        }
+
+        const int errorCode = pbsd_errno((void*)&pbsd_sendmmsg);
+        if (errorCode == PBSD_EWOULDBLOCK || errorCode == PBSD_ENOBUFS)
+        {
+            break;          /* the rest are dropped */
+        }
+
+        ++sent;             /* skip the failed one */
+    }
+}
+
+#endif /* PRO_HAS_MMSG */
+
 void
 PRO_CALLTYPE
 CProUdpTransport::RequestOnSend()
@@ -390,6 +772,13 @@ CProUdpTransport::RequestOnSend()
 
             m_onWr = true;
         }
+        else if (IsEdgeTriggered())
+        {
+            if (!m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_WRITE))
+            {
+                return;
+            }
+        }
 
         m_requestOnSend = true;
     }
@@ -408,6 +797,7 @@ CProUdpTransport::SuspendRecv()
         }
 
         m_reactorTask->RemoveHandler(m_sockId, this, PRO_MASK_READ);
+        m_recvSuspended = true;
     }
 }
 
@@ -424,6 +814,7 @@ CProUdpTransport::ResumeRecv()
         }
 
         m_reactorTask->AddHandler(m_sockId, this, PRO_MASK_READ);
+        m_recvSuspended = false;
     }
 }
 
@@ -441,7 +832,7 @@ CProUdpTransport::StartHeartbeat()
 
         if (m_timerId == 0)
         {
-            m_timerId = m_reactorTask->ScheduleHeartbeatTimer(this, 0);
+            m_timerId = m_reactorTask->ScheduleHandlerHeartbeatTimer(this, 0);
         }
     }
 }
@@ -458,7 +849,7 @@ CProUdpTransport::StopHeartbeat()
             return;
         }
 
-        m_reactorTask->CancelTimer(m_timerId);
+        m_reactorTask->CancelHandlerTimer(this, m_timerId);
         m_timerId = 0;
     }
 }
@@ -466,19 +857,62 @@ CProUdpTransport::StopHeartbeat()
 void
 PRO_CALLTYPE
 CProUdpTransport::OnInput(PRO_INT64 sockId)
+{
+    if (!IsEdgeTriggered())
+    {
+        if (m_batchSize > 0)
+        {
+            OnInputBatch(sockId);
+        }
+        else
+        {
+            OnInputData(sockId);
+        }
+
+        return;
+    }
+
+    /*
+     * read until EAGAIN, but no more than PRO_EDGE_BUDGET times, and
+     * then the rest is read in the next round
+     */
+    int i = 0;
+
+    for (; i < PRO_EDGE_BUDGET; ++i)
+    {
+        const bool more = m_batchSize > 0 ? OnInputBatch(sockId) : OnInputData(sockId);
+        if (!more)
+        {
+            return;
+        }
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_observer != NULL && m_reactorTask != NULL && sockId == m_sockId)
+        {
+            m_reactorTask->RaiseHandlerEvent(m_sockId, this, PRO_MASK_READ);
+        }
+    }
+}
+
+bool
+CProUdpTransport::OnInputData(PRO_INT64 sockId)
 {{
     CProThreadMutexGuard mon(m_lockUpcall);
 
     assert(sockId != -1);
     if (sockId == -1)
     {
-        return;
+        return (false);
     }
 
     IProTransportObserver* observer  = NULL;
     int                    recvSize  = 0;
     int                    errorCode = 0;
     const int              sslCode   = 0;
+    bool                   more      = false;
     pbsd_sockaddr_in       remoteAddr;
 
     {
@@ -486,12 +920,12 @@ CProUdpTransport::OnInput(PRO_INT64 sockId)
 
         if (m_observer == NULL || m_reactorTask == NULL)
         {
-            return;
+            return (false);
         }
 
-        if (sockId != m_sockId)
+        if (sockId != m_sockId || m_recvSuspended)
         {
-            return;
+            return (false);
         }
 
         const size_t idleSize = m_recvPool.ContinuousIdleSize();
@@ -517,6 +951,7 @@ CProUdpTransport::OnInput(PRO_INT64 sockId)
         else if (recvSize > 0)
         {
             m_recvPool.Fill(recvSize);
+            AddIoBytes(recvSize);
         }
         else if (recvSize == 0)
         {
@@ -538,6 +973,8 @@ EXIT:
         {
             observer->OnRecv(this, &remoteAddr);
             assert(m_recvPool.ContinuousIdleSize() > 0);
+
+            more = true;
         }
         else if (
             recvSize < 0 && errorCode != PBSD_EWOULDBLOCK &&
@@ -547,6 +984,10 @@ EXIT:
             m_canUpcall = false;
             observer->OnClose(this, errorCode, sslCode);
         }
+        else if (recvSize == 0 || errorCode != PBSD_EWOULDBLOCK)
+        {
+            more = true; /* an empty datagram, or an error to be skipped */
+        }
         else
         {
         }
@@ -557,7 +998,220 @@ EXIT:
     if (!m_canUpcall)
     {
         Fini();
+
+        return (false);
     }
+
+    return (more);
+}}
+
+bool
+CProUdpTransport::OnInputBatch(PRO_INT64 sockId)
+{{
+    CProThreadMutexGuard mon(m_lockUpcall);
+
+    assert(sockId != -1);
+    if (sockId == -1)
+    {
+        return (false);
+    }
+
+#if defined(PRO_HAS_MMSG)
+
+    /*
+     * the slots are shared by the transports of the reactor, and we are in
+     * the reactor thread
+     */
+    CProBaseReactor* const reactor  = GetReactor();
+    const size_t           ctrlSize = m_gro ? CMSG_SPACE(sizeof(int)) : 0;
+    PRO_UDP_BATCH* const   batch    =
+        reactor != NULL ? reactor->GetUdpBatch(m_batchSlotSize, ctrlSize, m_batchSize) : NULL;
+    if (batch == NULL)
+    {
+        return (false);
+    }
+
+    IProTransportObserver* observer  = NULL;
+    int                    recvCount = 0;
+    int                    errorCode = 0;
+    const int              sslCode   = 0;
+    bool                   more      = false;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_observer == NULL || m_reactorTask == NULL)
+        {
+            return (false);
+        }
+
+        if (sockId != m_sockId || m_recvSuspended)
+        {
+            return (false);
+        }
+
+        int       i = 0;
+        const int c = (int)m_batchSize;
+
+        for (; i < c; ++i)
+        {
+            batch->msgs[i].msg_hdr.msg_namelen    = sizeof(pbsd_sockaddr_in);
+            batch->msgs[i].msg_hdr.msg_controllen = ctrlSize;
+            batch->msgs[i].msg_hdr.msg_flags      = 0;
+        }
+
+        recvCount = pbsd_recvmmsg(m_sockId, &batch->msgs[0], m_batchSize, 0);
+        if (recvCount < 0)
+        {
+            errorCode = pbsd_errno((void*)&pbsd_recvmmsg);
+        }
+
+        m_observer->AddRef();
+        observer = m_observer;
+    }
+
+    if (m_canUpcall)
+    {
+        if (recvCount > 0)
+        {
+            /*
+             * each datagram, or each segment of a coalesced one, is reported
+             * in turn through the recv pool, or all at once in place with
+             * the batch upcall
+             */
+            batch->datagrams.clear();
+
+            int i = 0;
+
+            for (; i < recvCount && m_canUpcall; ++i)
+            {
+                const char* const buf     = (char*)batch->iovs[i].iov_base;
+                const size_t      size    = batch->msgs[i].msg_len;
+                size_t            segSize = size;
+
+                AddIoBytes(size);
+
+                if (batch->msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+                {
+                    continue; /* dropped like an EMSGSIZE */
+                }
+
+                if (m_gro)
+                {
+                    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&batch->msgs[i].msg_hdr);
+                    for (; cmsg != NULL; cmsg = CMSG_NXTHDR(&batch->msgs[i].msg_hdr, cmsg))
+                    {
+                        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+                        {
+                            int gsoSize = 0;
+                            memcpy(&gsoSize, CMSG_DATA(cmsg), sizeof(int));
+                            if (gsoSize > 0)
+                            {
+                                segSize = gsoSize;
+                            }
+                            break;
+                        }
+                    }
+                }
+
+                size_t offset = 0;
+
+                for (; offset < size && m_canUpcall; offset += segSize)
+                {
+                    const size_t dataSize =
+                        size - offset < segSize ? size - offset : segSize;
+
+                    if (m_batchUpcall)
+                    {
+                        PRO_DATAGRAM datagram;
+                        datagram.buf        = buf + offset;
+                        datagram.size       = dataSize;
+                        datagram.remoteAddr = &batch->addrs[i];
+                        batch->datagrams.push_back(datagram);
+                        continue;
+                    }
+
+                    {
+                        CProThreadMutexGuard mon(m_lock);
+
+                        if (m_observer == NULL || m_reactorTask == NULL ||
+                            sockId != m_sockId)
+                        {
+                            recvCount = 0;
+                            break;
+                        }
+
+                        if (dataSize > m_recvPool.ContinuousIdleSize())
+                        {
+                            continue; /* dropped like an EMSGSIZE */
+                        }
+
+                        memcpy(m_recvPool.ContinuousIdleBuf(), buf + offset, dataSize);
+                        m_recvPool.Fill(dataSize);
+                    }
+
+                    observer->OnRecv(this, &batch->addrs[i]);
+                    assert(m_recvPool.ContinuousIdleSize() > 0);
+                }
+            }
+
+            if (m_batchUpcall && batch->datagrams.size() > 0 && m_canUpcall)
+            {
+                bool alive = false;
+
+                {
+                    CProThreadMutexGuard mon(m_lock);
+
+                    alive = m_observer != NULL && m_reactorTask != NULL &&
+                        sockId == m_sockId;
+                }
+
+                if (alive)
+                {
+                    ((IProTransportBatchObserver*)observer)->OnRecvBatch(
+                        this, &batch->datagrams[0], batch->datagrams.size());
+                }
+                else
+                {
+                    recvCount = 0;
+                }
+            }
+
+            more = recvCount == (int)m_batchSize;
+        }
+        else if (
+            recvCount < 0 && errorCode != PBSD_EWOULDBLOCK &&
+            errorCode != PBSD_ECONNRESET && errorCode != PBSD_EMSGSIZE
+            )
+        {
+            m_canUpcall = false;
+            observer->OnClose(this, errorCode, sslCode);
+        }
+        else if (errorCode != PBSD_EWOULDBLOCK)
+        {
+            more = true; /* an error to be skipped */
+        }
+        else
+        {
+        }
+    }
+
+    observer->Release();
+
+    if (!m_canUpcall)
+    {
+        Fini();
+
+        return (false);
+    }
+
+    return (more);
+
+#else  /* PRO_HAS_MMSG */
+
+    return (false);
+
+#endif /* PRO_HAS_MMSG */
 }}
 
 void
@@ -610,7 +1264,7 @@ CProUdpTransport::OnOutput(PRO_INT64 sockId)
             {
                 CProThreadMutexGuard mon(m_lock);
 
-                if (m_observer != NULL && m_reactorTask != NULL)
+                if (m_observer != NULL && m_reactorTask != NULL && !IsEdgeTriggered())
                 {
                     if (m_onWr && !m_pendingWr && !m_requestOnSend)
                     {
@@ -708,3 +1362,26 @@ CProUdpTransport::OnTimer(unsigned long timerId,
 
     observer->Release();
 }}
+
+void
+PRO_CALLTYPE
+CProUdpTransport::OnReactorMoved()
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_observer == NULL || m_reactorTask == NULL)
+        {
+            return;
+        }
+
+        /*
+         * the heartbeat timer follows the reactor
+         */
+        if (m_timerId != 0 && GetTimerReactor() != NULL)
+        {
+            m_reactorTask->CancelHandlerTimer(this, m_timerId);
+            m_timerId = m_reactorTask->ScheduleHandlerHeartbeatTimer(this, 0);
+        }
+    }
+}
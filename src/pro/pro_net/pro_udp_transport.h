@@ -37,7 +37,10 @@ class CProUdpTransport : public IProTransport, public CProEventHandler
 {
 public:
 
-    static CProUdpTransport* CreateInstance(size_t recvPoolSize); /* = 0 */
+    static CProUdpTransport* CreateInstance(
+        bool   batchUpcall,
+        size_t recvPoolSize /* = 0 */
+        );
 
     bool Init(
         IProTransportObserver* observer,
@@ -77,6 +80,20 @@ public:
         const pbsd_sockaddr_in* remoteAddr /* = NULL */
         );
 
+    virtual bool PRO_CALLTYPE SendBuffer(
+        IProSendBuffer*         sendBuf,
+        const void*             buf,
+        size_t                  size,
+        PRO_UINT64              actionId,  /* = 0 */
+        const pbsd_sockaddr_in* remoteAddr /* = NULL */
+        );
+
+    virtual bool PRO_CALLTYPE SendDataBatch(
+        const PRO_DATAGRAM* datagrams,
+        size_t              count,
+        PRO_UINT64          actionId /* = 0 */
+        );
+
     virtual void PRO_CALLTYPE RequestOnSend();
 
     virtual void PRO_CALLTYPE SuspendRecv();
@@ -98,12 +115,25 @@ public:
 
 protected:
 
-    CProUdpTransport(size_t recvPoolSize); /* = 0 */
+    CProUdpTransport(
+        bool   batchUpcall,
+        size_t recvPoolSize /* = 0 */
+        );
 
     virtual ~CProUdpTransport();
 
+    /*
+     * sizes the recvmmsg() slots and sets up the UDP_SEGMENT/UDP_GRO offloads.
+     * it must be called with m_lock held, before the handler is added
+     */
+    bool InitBatch_i(
+        PRO_INT64          sockId,
+        CProTpReactorTask* reactorTask
+        );
+
 protected:
 
+    const bool              m_batchUpcall; /* the observer is an IProTransportBatchObserver */
     const size_t            m_recvPoolSize;
     IProTransportObserver*  m_observer;
     CProTpReactorTask*      m_reactorTask;
@@ -118,6 +148,30 @@ private:
 
     virtual void PRO_CALLTYPE OnInput(PRO_INT64 sockId);
 
+    bool OnInputData(PRO_INT64 sockId); /* returns true if there may be more data */
+
+    bool OnInputBatch(PRO_INT64 sockId); /* returns true if there may be more data */
+
+    void SendBatch_i(
+        const PRO_DATAGRAM* datagrams,
+        size_t              count
+        );
+
+#if defined(PRO_HAS_MMSG)
+
+    bool SendGso_i(
+        const PRO_DATAGRAM*     datagrams,
+        size_t                  count,
+        const pbsd_sockaddr_in* realAddr
+        );
+
+    void SendMmsg_i(
+        pbsd_mmsghdr* msgs,
+        size_t        count
+        );
+
+#endif /* PRO_HAS_MMSG */
+
     virtual void PRO_CALLTYPE OnOutput(PRO_INT64 sockId);
 
     virtual void PRO_CALLTYPE OnError(
@@ -130,13 +184,22 @@ private:
         PRO_INT64     userData
         );
 
+    virtual void PRO_CALLTYPE OnReactorMoved();
+
 private:
 
     bool                    m_onWr;
+    bool                    m_recvSuspended;
     bool                    m_pendingWr;
     bool                    m_requestOnSend;
     PRO_UINT64              m_actionId;
 
+    unsigned long           m_batchSize;
+    size_t                  m_batchSlotSize; /* the mtu, or 64KB with UDP_GRO. the slots are the reactor's */
+    bool                    m_gso;
+    bool                    m_gro;
+    size_t                  m_gsoLimit;      /* lowered when the kernel rejects a segment size */
+
     bool                    m_canUpcall;
     CProThreadMutex         m_lockUpcall;
 };
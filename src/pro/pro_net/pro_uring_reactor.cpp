@@ -0,0 +1,1282 @@
+/*
+ * Copyright (C) 2018 Eric Tung <libpronet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"),
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of LibProNet (http://www.libpro.org)
+ */
+
+#include "pro_uring_reactor.h"
+#include "pro_base_reactor.h"
+#include "pro_epoll_reactor.h"
+#include "pro_notify_pipe.h"
+#include "../pro_util/pro_bsd_wrapper.h"
+#include "../pro_util/pro_stl.h"
+#include "../pro_util/pro_thread.h"
+#include "../pro_util/pro_time_util.h"
+#include "../pro_util/pro_timer_factory.h"
+#include "../pro_util/pro_z.h"
+#include <cassert>
+
+#if defined(PRO_HAS_EPOLL) && defined(PRO_HAS_IO_URING)
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if !defined(PRO_LACKS_TIMERFD)
+#include <sys/timerfd.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+#if !defined(PRO_URING_ENTRIES)
+#define PRO_URING_ENTRIES     PRO_EPOLLFD_GETSIZE
+#endif
+
+#define PRO_URING_SOCKID_MAX  (1024 * 1024)
+
+/*
+ * multishot poll comes with the kernel 5.13, as IORING_FEAT_RSRC_TAGS does
+ */
+#define PRO_URING_FEATURES    (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | \
+                               IORING_FEAT_RSRC_TAGS)
+
+#define PRO_URING_REMOVE_TAG  ((PRO_UINT64)0)
+#define PRO_URING_TIMER_TAG   ((PRO_UINT64)0xFFFFFFFF << 32)
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+static inline
+unsigned long
+MaskToEvents_i(unsigned long mask)
+{
+    unsigned long events = 0;
+    if (PRO_BIT_ENABLED(mask, PRO_MASK_WRITE))
+    {
+        events |= POLLOUT;
+    }
+    if (PRO_BIT_ENABLED(mask, PRO_MASK_READ))
+    {
+        events |= POLLIN;
+    }
+    if (PRO_BIT_ENABLED(mask, PRO_MASK_EXCEPTION))
+    {
+        events |= POLLPRI;
+    }
+
+    return (events);
+}
+
+static inline
+PRO_UINT32
+LoadAcquire_i(const unsigned int* p)
+{
+    return (__atomic_load_n(p, __ATOMIC_ACQUIRE));
+}
+
+static inline
+void
+StoreRelease_i(unsigned int* p,
+               unsigned int  value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+CProUringReactor::CProUringReactor()
+{
+    m_ringfd       = -1;
+    m_ring         = MAP_FAILED;
+    m_ringSize     = 0;
+    m_sqes         = (io_uring_sqe*)MAP_FAILED;
+    m_sqesSize     = 0;
+    m_sqHead       = NULL;
+    m_sqTail       = NULL;
+    m_sqArray      = NULL;
+    m_sqMask       = 0;
+    m_sqEntries    = 0;
+    m_cqHead       = NULL;
+    m_cqTail       = NULL;
+    m_cqes         = NULL;
+    m_cqMask       = 0;
+    m_sqLocalTail  = 0;
+    m_toSubmit     = 0;
+    m_armSeq       = 0;
+
+    m_timerfd      = -1;
+    m_timerArmed   = false;
+    m_armedTick    = -1;
+    m_raisedBySelf = false;
+    m_cqBacklog    = false;
+
+    m_raised.reserve(PRO_EPOLLFD_GETSIZE);
+    m_raised2.reserve(PRO_EPOLLFD_GETSIZE);
+}
+
+CProUringReactor::~CProUringReactor()
+{
+    Fini();
+
+    m_timerFactory.Stop();
+
+    /*
+     * closing the ring cancels all the polls
+     */
+    CleanupRing_i();
+
+    if (m_timerfd != -1)
+    {
+        close(m_timerfd);
+        m_timerfd = -1;
+    }
+
+    int       i = 0;
+    const int c = (int)m_raised.size();
+
+    for (; i < c; ++i)
+    {
+        m_raised[i].handler->Release();
+    }
+
+    m_raised.clear();
+
+    delete m_notifyPipe;
+    m_notifyPipe = NULL;
+}
+
+bool
+CProUringReactor::SetupRing_i()
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(io_uring_params));
+    params.flags      = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN;
+    params.cq_entries = PRO_URING_ENTRIES * 4;
+
+    int ringfd = (int)syscall(__NR_io_uring_setup, PRO_URING_ENTRIES, &params);
+    if (ringfd < 0)
+    {
+        /*
+         * IORING_SETUP_COOP_TASKRUN comes with the kernel 5.19
+         */
+        memset(&params, 0, sizeof(io_uring_params));
+        params.flags      = IORING_SETUP_CQSIZE;
+        params.cq_entries = PRO_URING_ENTRIES * 4;
+
+        ringfd = (int)syscall(__NR_io_uring_setup, PRO_URING_ENTRIES, &params);
+        if (ringfd < 0)
+        {
+            return (false);
+        }
+    }
+
+    if ((params.features & PRO_URING_FEATURES) != PRO_URING_FEATURES)
+    {
+        close(ringfd);
+
+        return (false);
+    }
+
+    const size_t sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    const size_t cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    m_ringfd   = ringfd;
+    m_ringSize = sqRingSize > cqRingSize ? sqRingSize : cqRingSize;
+    m_ring     = mmap(NULL, m_ringSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, m_ringfd, IORING_OFF_SQ_RING);
+    if (m_ring == MAP_FAILED)
+    {
+        CleanupRing_i();
+
+        return (false);
+    }
+
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    m_sqes     = (io_uring_sqe*)mmap(NULL, m_sqesSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, m_ringfd, IORING_OFF_SQES);
+    if (m_sqes == MAP_FAILED)
+    {
+        CleanupRing_i();
+
+        return (false);
+    }
+
+    char* const ring = (char*)m_ring;
+
+    m_sqHead      = (unsigned int*)(ring + params.sq_off.head);
+    m_sqTail      = (unsigned int*)(ring + params.sq_off.tail);
+    m_sqArray     = (unsigned int*)(ring + params.sq_off.array);
+    m_sqMask      = *(unsigned int*)(ring + params.sq_off.ring_mask);
+    m_sqEntries   = *(unsigned int*)(ring + params.sq_off.ring_entries);
+    m_cqHead      = (unsigned int*)(ring + params.cq_off.head);
+    m_cqTail      = (unsigned int*)(ring + params.cq_off.tail);
+    m_cqes        = (io_uring_cqe*)(ring + params.cq_off.cqes);
+    m_cqMask      = *(unsigned int*)(ring + params.cq_off.ring_mask);
+    m_sqLocalTail = *m_sqTail;
+
+    return (true);
+}
+
+void
+CProUringReactor::CleanupRing_i()
+{
+    if (m_sqes != MAP_FAILED)
+    {
+        munmap(m_sqes, m_sqesSize);
+        m_sqes = (io_uring_sqe*)MAP_FAILED;
+    }
+
+    if (m_ring != MAP_FAILED)
+    {
+        munmap(m_ring, m_ringSize);
+        m_ring = MAP_FAILED;
+    }
+
+    if (m_ringfd != -1)
+    {
+        close(m_ringfd);
+        m_ringfd = -1;
+    }
+}
+
+bool
+PRO_CALLTYPE
+CProUringReactor::Init()
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        assert(m_ringfd == -1);
+        if (m_ringfd != -1)
+        {
+            return (false);
+        }
+
+        if (!SetupRing_i())
+        {
+            return (false);
+        }
+
+        m_notifyPipe->Init();
+
+        const PRO_INT64 sockId = m_notifyPipe->GetReaderSockId();
+        if (sockId == -1 || sockId >= PRO_URING_SOCKID_MAX)
+        {
+            CleanupRing_i();
+
+            return (false);
+        }
+
+        if (!m_handlerMgr.AddHandler(sockId, this, PRO_MASK_READ))
+        {
+            CleanupRing_i();
+
+            return (false);
+        }
+
+        MarkDirty_i(sockId);
+    }
+
+    return (true);
+}
+
+void
+PRO_CALLTYPE
+CProUringReactor::Fini()
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1)
+        {
+            return;
+        }
+
+        m_wantExit = true;
+        m_notifyPipe->Notify();
+    }
+}
+
+bool
+PRO_CALLTYPE
+CProUringReactor::AddHandler(PRO_INT64         sockId,
+                             CProEventHandler* handler,
+                             unsigned long     mask)
+{
+    mask &= (PRO_MASK_ACCEPT | PRO_MASK_CONNECT |
+        PRO_MASK_WRITE | PRO_MASK_READ | PRO_MASK_EXCEPTION);
+
+    assert(sockId != -1);
+    assert(handler != NULL);
+    assert(mask != 0);
+    if (sockId == -1 || handler == NULL || mask == 0)
+    {
+        return (false);
+    }
+
+    if (PRO_BIT_ENABLED(mask, PRO_MASK_ACCEPT))
+    {
+        PRO_CLR_BITS(mask, PRO_MASK_ACCEPT);
+        PRO_SET_BITS(mask, PRO_MASK_READ);
+    }
+    if (PRO_BIT_ENABLED(mask, PRO_MASK_CONNECT))
+    {
+        PRO_CLR_BITS(mask, PRO_MASK_CONNECT);
+        PRO_SET_BITS(mask, PRO_MASK_WRITE | PRO_MASK_READ | PRO_MASK_EXCEPTION);
+    }
+
+    if (sockId < 0 || sockId >= PRO_URING_SOCKID_MAX)
+    {
+        return (false);
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_wantExit)
+        {
+            return (false);
+        }
+
+        const PRO_HANDLER_INFO oldInfo = m_handlerMgr.FindHandler(sockId);
+        if (oldInfo.handler != NULL && handler != oldInfo.handler)
+        {
+            return (false);
+        }
+
+        mask &= ~oldInfo.mask;
+        if (mask == 0)
+        {
+            return (true);
+        }
+
+        if (!m_handlerMgr.AddHandler(sockId, handler, mask))
+        {
+            return (false);
+        }
+
+        /*
+         * the poll is armed by the reactor thread. a bad descriptor is
+         * reported to the handler by OnError(...)
+         */
+        MarkDirty_i(sockId);
+
+        if (ProGetThreadId() != m_threadId)
+        {
+            m_notifyPipe->Notify();
+        }
+    }
+
+    return (true);
+}
+
+void
+PRO_CALLTYPE
+CProUringReactor::RemoveHandler(PRO_INT64     sockId,
+                                unsigned long mask)
+{
+    mask &= (PRO_MASK_ACCEPT | PRO_MASK_CONNECT |
+        PRO_MASK_WRITE | PRO_MASK_READ | PRO_MASK_EXCEPTION);
+
+    if (sockId == -1 || mask == 0)
+    {
+        return;
+    }
+
+    if (PRO_BIT_ENABLED(mask, PRO_MASK_ACCEPT))
+    {
+        PRO_CLR_BITS(mask, PRO_MASK_ACCEPT);
+        PRO_SET_BITS(mask, PRO_MASK_READ);
+    }
+    if (PRO_BIT_ENABLED(mask, PRO_MASK_CONNECT))
+    {
+        PRO_CLR_BITS(mask, PRO_MASK_CONNECT);
+        PRO_SET_BITS(mask, PRO_MASK_WRITE | PRO_MASK_READ | PRO_MASK_EXCEPTION);
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1)
+        {
+            return;
+        }
+
+        const PRO_HANDLER_INFO oldInfo = m_handlerMgr.FindHandler(sockId);
+        if (oldInfo.handler == NULL)
+        {
+            return;
+        }
+
+        mask &= oldInfo.mask;
+        if (mask == 0)
+        {
+            return;
+        }
+
+        m_handlerMgr.RemoveHandler(sockId, mask);
+
+        /*
+         * an armed poll holds a reference of the file, so it's removed
+         * soon by the reactor thread
+         */
+        MarkDirty_i(sockId);
+
+        if (ProGetThreadId() != m_threadId)
+        {
+            m_notifyPipe->Notify();
+        }
+    }
+}
+
+bool
+PRO_CALLTYPE
+CProUringReactor::RaiseEvent(PRO_INT64         sockId,
+                             CProEventHandler* handler,
+                             unsigned long     mask)
+{
+    mask &= (PRO_MASK_WRITE | PRO_MASK_READ);
+
+    assert(sockId != -1);
+    assert(handler != NULL);
+    assert(mask != 0);
+    if (sockId == -1 || handler == NULL || mask == 0)
+    {
+        return (false);
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_wantExit)
+        {
+            return (false);
+        }
+
+        const PRO_HANDLER_INFO* const info = m_handlerMgr.FindHandlerFast(sockId);
+        if (info == NULL || info->handler != handler)
+        {
+            return (false);
+        }
+
+        mask &= info->mask;
+        if (mask == 0)
+        {
+            return (true);
+        }
+
+        PRO_EPOLL_READY_INFO raised;
+        raised.handler = handler;
+        raised.sockId  = sockId;
+        raised.mask    = mask;
+
+        raised.handler->AddRef();
+        m_raised.push_back(raised);
+
+        if (ProGetThreadId() == m_threadId)
+        {
+            m_raisedBySelf = true;
+        }
+        else
+        {
+            m_notifyPipe->Notify();
+        }
+    }
+
+    return (true);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProUringReactor::DropRaisedEvents(PRO_INT64 sockId)
+{
+    unsigned long mask = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        CProStlVector<PRO_EPOLL_READY_INFO>::iterator itr = m_raised.begin();
+
+        while (itr != m_raised.end())
+        {
+            if (itr->sockId != sockId)
+            {
+                ++itr;
+                continue;
+            }
+
+            PRO_SET_BITS(mask, itr->mask);
+            itr->handler->Release();
+            itr = m_raised.erase(itr);
+        }
+    }
+
+    return (mask);
+}
+
+bool
+PRO_CALLTYPE
+CProUringReactor::InitTimers(bool timingWheel)
+{
+#if defined(PRO_LACKS_TIMERFD)
+    return (false);
+#else
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_timerfd != -1 || m_wantExit)
+        {
+            return (false);
+        }
+
+        m_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (m_timerfd == -1)
+        {
+            return (false);
+        }
+
+        if (!m_timerFactory.Start(false, timingWheel, false)) /* no worker thread */
+        {
+            close(m_timerfd);
+            m_timerfd = -1;
+
+            return (false);
+        }
+
+        /*
+         * the timerfd poll is armed by the reactor thread
+         */
+        m_timerArmed = false;
+
+        if (ProGetThreadId() != m_threadId)
+        {
+            m_notifyPipe->Notify();
+        }
+    }
+
+    return (true);
+#endif
+}
+
+unsigned long
+PRO_CALLTYPE
+CProUringReactor::ScheduleTimer(IProOnTimer* onTimer,
+                                PRO_UINT64   timeSpan,
+                                bool         recurring,
+                                PRO_INT64    userData)
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_timerfd == -1 || m_wantExit)
+        {
+            return (0);
+        }
+
+        timerId = m_timerFactory.ScheduleTimer(onTimer, timeSpan, recurring, userData);
+        if (timerId != 0)
+        {
+            SetTimer_i();
+        }
+    }
+
+    return (timerId);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProUringReactor::ScheduleHeartbeatTimer(IProOnTimer* onTimer,
+                                         PRO_INT64    userData)
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_timerfd == -1 || m_wantExit)
+        {
+            return (0);
+        }
+
+        timerId = m_timerFactory.ScheduleHeartbeatTimer(onTimer, userData);
+        if (timerId != 0)
+        {
+            SetTimer_i();
+        }
+    }
+
+    return (timerId);
+}
+
+unsigned long
+PRO_CALLTYPE
+CProUringReactor::JoinHeartbeatGroup(PRO_HEARTBEAT_ENTRY* entry,
+                                     IProOnTimer*         onTimer,
+                                     PRO_INT64            userData)
+{
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_timerfd == -1 || m_wantExit)
+        {
+            return (0);
+        }
+
+        timerId = m_timerFactory.JoinHeartbeatGroup(entry, onTimer, userData);
+        if (timerId != 0)
+        {
+            SetTimer_i();
+        }
+    }
+
+    return (timerId);
+}
+
+bool
+PRO_CALLTYPE
+CProUringReactor::LeaveHeartbeatGroup(PRO_HEARTBEAT_ENTRY* entry,
+                                      unsigned long        timerId)
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_timerfd == -1)
+        {
+            return (false);
+        }
+    }
+
+    return (m_timerFactory.LeaveHeartbeatGroup(entry, timerId));
+}
+
+bool
+PRO_CALLTYPE
+CProUringReactor::UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds)
+{
+    bool ret = false;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_timerfd == -1 || m_wantExit)
+        {
+            return (false);
+        }
+
+        ret = m_timerFactory.UpdateHeartbeatTimers(htbtIntervalInSeconds);
+        if (ret)
+        {
+            SetTimer_i();
+        }
+    }
+
+    return (ret);
+}
+
+bool
+PRO_CALLTYPE
+CProUringReactor::CancelTimer(unsigned long timerId)
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_timerfd == -1)
+        {
+            return (false);
+        }
+    }
+
+    return (m_timerFactory.CancelTimer(timerId));
+}
+
+unsigned long
+PRO_CALLTYPE
+CProUringReactor::GetTimerCount() const
+{
+    return (m_timerFactory.GetTimerCount());
+}
+
+void
+PRO_CALLTYPE
+CProUringReactor::WorkerRun()
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        m_threadId = ProGetThreadId();
+    }
+
+    /*
+     * the ring is only touched by this thread. the poll changes of a round
+     * go to the kernel together with the wait of the next round
+     */
+    while (1)
+    {
+        RunCommands();
+
+        {
+            CProThreadMutexGuard mon(m_lock);
+
+            if (m_ringfd == -1 || m_wantExit)
+            {
+                break;
+            }
+
+            FlushPolls_i();
+        }
+
+        bool wait = !m_raisedBySelf && !m_cqBacklog;
+        m_raisedBySelf = false;
+
+        bool spinning = false;
+        if (wait && WantBusyPoll())
+        {
+            wait     = false;
+            spinning = true;
+        }
+
+        if (wait && !m_notifyPipe->BeginWait())
+        {
+            wait = false;
+        }
+
+        const int retc      = Enter_i(m_toSubmit, wait ? 1 : 0);
+        const int errorCode = retc < 0 ? errno : 0;
+        m_notifyPipe->EndWait();
+
+        int  readyCount = 0;
+        bool timerReady = false;
+
+        {
+            CProThreadMutexGuard mon(m_lock);
+
+            if (m_ringfd == -1 || m_wantExit)
+            {
+                break;
+            }
+
+            m_raised2.swap(m_raised);
+
+            readyCount = ReapCqes_i(timerReady);
+
+            spinning = CountBusyPoll(spinning, readyCount > 0 || timerReady || m_raised2.size() > 0);
+        }
+
+        if (retc < 0 && errorCode != EINTR && errorCode != EBUSY && errorCode != EAGAIN)
+        {
+            ProSleep(1);
+        }
+        else if (spinning)
+        {
+            sched_yield();
+        }
+
+        for (int j = 0; j < readyCount; ++j)
+        {
+            const PRO_EPOLL_READY_INFO& ready = m_ready[j];
+
+            if (PRO_BIT_ENABLED(ready.mask, PRO_MASK_ERROR))
+            {
+                ready.handler->OnError(ready.sockId, -1);
+                ready.handler->Release();
+                continue;
+            }
+
+            if (PRO_BIT_ENABLED(ready.mask, PRO_MASK_WRITE))
+            {
+                ready.handler->OnOutput(ready.sockId);
+            }
+
+            if (PRO_BIT_ENABLED(ready.mask, PRO_MASK_READ))
+            {
+                ready.handler->OnInput(ready.sockId);
+            }
+
+            if (PRO_BIT_ENABLED(ready.mask, PRO_MASK_EXCEPTION))
+            {
+                ready.handler->OnException(ready.sockId);
+            }
+
+            ready.handler->Release();
+        }
+
+        int       k = 0;
+        const int c = (int)m_raised2.size();
+
+        for (; k < c; ++k)
+        {
+            const PRO_EPOLL_READY_INFO& raised = m_raised2[k];
+
+            if (PRO_BIT_ENABLED(raised.mask, PRO_MASK_WRITE))
+            {
+                raised.handler->OnOutput(raised.sockId);
+            }
+
+            if (PRO_BIT_ENABLED(raised.mask, PRO_MASK_READ))
+            {
+                raised.handler->OnInput(raised.sockId);
+            }
+
+            raised.handler->Release();
+        }
+
+        m_raised2.clear();
+
+        if (timerReady)
+        {
+            PollTimers();
+        }
+    } /* end of while (...) */
+
+    RunCommands(); /* the rest */
+}
+
+void
+CProUringReactor::MarkDirty_i(PRO_INT64 sockId)
+{
+    if (sockId < 0 || sockId >= PRO_URING_SOCKID_MAX)
+    {
+        return;
+    }
+
+    if (sockId >= (PRO_INT64)m_polls.size())
+    {
+        size_t size = m_polls.size() * 2;
+        if (size < 64)
+        {
+            size = 64;
+        }
+        if (size < (size_t)sockId + 1)
+        {
+            size = (size_t)sockId + 1;
+        }
+        if (size > PRO_URING_SOCKID_MAX)
+        {
+            size = PRO_URING_SOCKID_MAX;
+        }
+
+        m_polls.resize(size);
+    }
+
+    PRO_URING_POLL_INFO& poll = m_polls[(size_t)sockId];
+    if (!poll.dirty)
+    {
+        poll.dirty = true;
+        m_dirty.push_back(sockId);
+    }
+}
+
+void
+CProUringReactor::FlushPolls_i()
+{
+    int       i = 0;
+    const int c = (int)m_dirty.size();
+
+    for (; i < c; ++i)
+    {
+        const PRO_INT64      sockId = m_dirty[i];
+        PRO_URING_POLL_INFO& poll   = m_polls[(size_t)sockId];
+
+        const PRO_HANDLER_INFO* const info      = m_handlerMgr.FindHandlerFast(sockId);
+        const unsigned long           events    = info != NULL ? MaskToEvents_i(info->mask) : 0;
+        const bool                    multishot =
+            info != NULL && info->handler->IsEdgeTriggered();
+
+        if (events == poll.events && multishot == poll.multishot)
+        {
+            poll.dirty = false;
+            continue;
+        }
+
+        /*
+         * at most 2 sqes per descriptor
+         */
+        if (m_sqLocalTail - LoadAcquire_i(m_sqHead) + 2 > m_sqEntries)
+        {
+            if (Enter_i(m_toSubmit, 0) < 0 ||
+                m_sqLocalTail - LoadAcquire_i(m_sqHead) + 2 > m_sqEntries)
+            {
+                break; /* the rest are flushed next round */
+            }
+        }
+
+        poll.dirty = false;
+
+        if (poll.events != 0)
+        {
+            io_uring_sqe* const sqe = GetSqe_i();
+            sqe->opcode    = IORING_OP_POLL_REMOVE;
+            sqe->fd        = -1;
+            sqe->addr      = poll.tag;
+            sqe->user_data = PRO_URING_REMOVE_TAG;
+
+            poll.events = 0;
+            poll.tag    = 0;
+        }
+
+        if (events != 0)
+        {
+            ++m_armSeq;
+            if (m_armSeq == 0 || m_armSeq == 0xFFFFFFFF)
+            {
+                m_armSeq = 1;
+            }
+
+            io_uring_sqe* const sqe = GetSqe_i();
+            sqe->opcode        = IORING_OP_POLL_ADD;
+            sqe->fd            = (int)sockId;
+            sqe->poll32_events = (PRO_UINT32)events;
+            sqe->len           = multishot ? IORING_POLL_ADD_MULTI : 0;
+            sqe->user_data     = ((PRO_UINT64)m_armSeq << 32) | (PRO_UINT32)sockId;
+
+            poll.events    = events;
+            poll.tag       = sqe->user_data;
+            poll.multishot = multishot;
+        }
+    }
+
+    if (i < c)
+    {
+        m_dirty.erase(m_dirty.begin(), m_dirty.begin() + i);
+    }
+    else
+    {
+        m_dirty.clear();
+    }
+
+    if (m_timerfd != -1 && !m_timerArmed &&
+        m_sqLocalTail - LoadAcquire_i(m_sqHead) < m_sqEntries)
+    {
+        io_uring_sqe* const sqe = GetSqe_i();
+        sqe->opcode        = IORING_OP_POLL_ADD;
+        sqe->fd            = m_timerfd;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data     = PRO_URING_TIMER_TAG;
+
+        m_timerArmed = true;
+    }
+}
+
+io_uring_sqe*
+CProUringReactor::GetSqe_i()
+{
+    const unsigned int  index = m_sqLocalTail & m_sqMask;
+    io_uring_sqe* const sqe   = &m_sqes[index];
+
+    memset(sqe, 0, sizeof(io_uring_sqe));
+    m_sqArray[index] = index;
+    ++m_sqLocalTail;
+    ++m_toSubmit;
+
+    return (sqe);
+}
+
+int
+CProUringReactor::Enter_i(unsigned int toSubmit,
+                          unsigned int minComplete)
+{
+    StoreRelease_i(m_sqTail, m_sqLocalTail);
+
+    const unsigned int flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    const int retc = (int)syscall(
+        __NR_io_uring_enter, m_ringfd, toSubmit, minComplete, flags, NULL, 0);
+    if (retc > 0)
+    {
+        m_toSubmit -= (unsigned int)retc <= m_toSubmit ? (unsigned int)retc : m_toSubmit;
+    }
+
+    return (retc);
+}
+
+int
+CProUringReactor::ReapCqes_i(bool& timerReady)
+{
+    int          readyCount = 0;
+    unsigned int head       = *m_cqHead;
+    unsigned int tail       = LoadAcquire_i(m_cqTail);
+
+    m_cqBacklog = false;
+
+    for (; head != tail; ++head)
+    {
+        if (readyCount == PRO_EPOLLFD_GETSIZE)
+        {
+            m_cqBacklog = true;
+            break;
+        }
+
+        const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+
+        if (cqe.user_data == PRO_URING_REMOVE_TAG)
+        {
+            continue;
+        }
+
+        if (cqe.user_data == PRO_URING_TIMER_TAG)
+        {
+            m_timerArmed = false;
+            timerReady   = cqe.res > 0;
+            continue;
+        }
+
+        const PRO_INT64 sockId = (int)(PRO_UINT32)cqe.user_data;
+        if (sockId < 0 || sockId >= (PRO_INT64)m_polls.size())
+        {
+            continue;
+        }
+
+        PRO_URING_POLL_INFO& poll = m_polls[(size_t)sockId];
+        if (cqe.user_data != poll.tag)
+        {
+            continue; /* stale */
+        }
+
+        if ((cqe.flags & IORING_CQE_F_MORE) == 0)
+        {
+            /*
+             * a oneshot poll fired, or a multishot one terminated
+             */
+            poll.events = 0;
+            poll.tag    = 0;
+
+            if (cqe.res >= 0)
+            {
+                MarkDirty_i(sockId);
+            }
+        }
+
+        const PRO_HANDLER_INFO* const info = m_handlerMgr.FindHandlerFast(sockId);
+        if (info == NULL)
+        {
+            continue;
+        }
+
+        unsigned long mask = 0;
+
+        if (cqe.res < 0)
+        {
+            if (cqe.res == -ECANCELED)
+            {
+                MarkDirty_i(sockId);
+                continue;
+            }
+
+            PRO_SET_BITS(mask, PRO_MASK_ERROR);
+        }
+        else if ((cqe.res & POLLERR) != 0)
+        {
+            PRO_SET_BITS(mask, PRO_MASK_ERROR);
+        }
+        else
+        {
+            if ((cqe.res & POLLOUT) != 0)
+            {
+                PRO_SET_BITS(mask, PRO_MASK_WRITE);
+            }
+            if ((cqe.res & (POLLIN | POLLHUP)) != 0)
+            {
+                PRO_SET_BITS(mask, PRO_MASK_READ);
+            }
+            if ((cqe.res & POLLPRI) != 0)
+            {
+                PRO_SET_BITS(mask, PRO_MASK_EXCEPTION);
+            }
+
+            mask &= info->mask; /* changed after the poll was armed */
+        }
+
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        PRO_EPOLL_READY_INFO& ready = m_ready[readyCount];
+        ++readyCount;
+
+        ready.handler = info->handler;
+        ready.sockId  = sockId;
+        ready.mask    = mask;
+        ready.handler->AddRef();
+    } /* end of for (...) */
+
+    StoreRelease_i(m_cqHead, head);
+
+    return (readyCount);
+}
+
+void
+CProUringReactor::SetTimer_i()
+{
+#if !defined(PRO_LACKS_TIMERFD)
+    const PRO_INT64 nextTick = m_timerFactory.GetNextExpireTick();
+    if (nextTick < 0 || (m_armedTick >= 0 && nextTick >= m_armedTick))
+    {
+        return;
+    }
+
+    const PRO_INT64 delta = nextTick - ProGetTickCount64();
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(struct itimerspec));
+    if (delta > 0)
+    {
+        its.it_value.tv_sec  = (time_t)(delta / 1000);
+        its.it_value.tv_nsec = (long)(delta % 1000) * 1000000;
+    }
+    else
+    {
+        its.it_value.tv_nsec = 1; /* as soon as possible */
+    }
+
+    if (timerfd_settime(m_timerfd, 0, &its, NULL) == 0)
+    {
+        m_armedTick = nextTick;
+    }
+#endif
+}
+
+void
+CProUringReactor::PollTimers()
+{
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_timerfd == -1)
+        {
+            return;
+        }
+
+        PRO_UINT64 expirations = 0;
+        int        retc        = -1;
+
+        do
+        {
+            retc = (int)read(m_timerfd, &expirations, sizeof(PRO_UINT64));
+        }
+        while (retc < 0 && errno == EINTR);
+
+        /*
+         * the timer was re-armed after it became readable, and nothing has
+         * expired. an unexpected error or short read falls through, so the
+         * timers won't stall
+         */
+        if (retc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+
+        m_armedTick = -1;
+    }
+
+    m_timerFactory.Poll();
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_timerfd == -1 || m_wantExit)
+        {
+            return;
+        }
+
+        SetTimer_i();
+    }
+}
+
+void
+PRO_CALLTYPE
+CProUringReactor::OnInput(PRO_INT64 sockId)
+{
+    assert(sockId != -1);
+    if (sockId == -1)
+    {
+        return;
+    }
+
+    if (sockId != m_notifyPipe->GetReaderSockId())
+    {
+        return;
+    }
+
+    if (!m_notifyPipe->Drain())
+    {
+        OnError(sockId, -1);
+    }
+}
+
+void
+PRO_CALLTYPE
+CProUringReactor::OnError(PRO_INT64 sockId,
+                          long      errorCode)
+{
+    assert(sockId != -1);
+    if (sockId == -1)
+    {
+        return;
+    }
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_ringfd == -1 || m_wantExit || sockId != m_notifyPipe->GetReaderSockId())
+        {
+            return;
+        }
+
+        CProNotifyPipe* const newPipe = new CProNotifyPipe;
+        newPipe->Init();
+
+        const PRO_INT64 newSockId = newPipe->GetReaderSockId();
+        if (newSockId == -1 || newSockId >= PRO_URING_SOCKID_MAX)
+        {
+            delete newPipe;
+
+            return;
+        }
+
+        if (!m_handlerMgr.AddHandler(newSockId, this, PRO_MASK_READ))
+        {
+            delete newPipe;
+
+            return;
+        }
+
+        MarkDirty_i(newSockId);
+
+        /*
+         * unregister old
+         */
+        m_handlerMgr.RemoveHandler(sockId, PRO_MASK_READ);
+        MarkDirty_i(sockId);
+
+        /*
+         * register new
+         */
+        ReplaceNotifyPipe(newPipe);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+#endif /* PRO_HAS_EPOLL, PRO_HAS_IO_URING */
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2018 Eric Tung <libpronet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"),
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of LibProNet (http://www.libpro.org)
+ */
+
+#if !defined(PRO_URING_REACTOR_H)
+#define PRO_URING_REACTOR_H
+
+#include "pro_base_reactor.h"
+#include "pro_epoll_reactor.h"
+#include "../pro_util/pro_stl.h"
+#include "../pro_util/pro_timer_factory.h"
+
+#if defined(PRO_HAS_EPOLL) && defined(PRO_HAS_IO_URING)
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+struct PRO_URING_POLL_INFO
+{
+    PRO_URING_POLL_INFO()
+    {
+        events    = 0;
+        tag       = 0;
+        multishot = false;
+        dirty     = false;
+    }
+
+    unsigned long events;    /* the events of the armed poll. 0 means none */
+    PRO_UINT64    tag;       /* the user_data of the armed poll */
+    bool          multishot; /* for the edge-triggered handlers */
+    bool          dirty;     /* queued in m_dirty */
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+/*
+ * an io_uring backend with the same readiness contract as CProEpollReactor.
+ *
+ * the edge-triggered handlers get a multishot poll, and the others get a
+ * oneshot poll that is rearmed after each upcall. the poll changes are
+ * collected by any thread, and the reactor thread submits them together
+ * with its wait in one io_uring_enter()
+ */
+class CProUringReactor : public CProBaseReactor
+{
+public:
+
+    CProUringReactor();
+
+    virtual ~CProUringReactor();
+
+    virtual bool PRO_CALLTYPE Init();
+
+    virtual void PRO_CALLTYPE Fini();
+
+    virtual bool PRO_CALLTYPE AddHandler(
+        PRO_INT64         sockId,
+        CProEventHandler* handler,
+        unsigned long     mask
+        );
+
+    virtual void PRO_CALLTYPE RemoveHandler(
+        PRO_INT64     sockId,
+        unsigned long mask
+        );
+
+    virtual bool PRO_CALLTYPE RaiseEvent(
+        PRO_INT64         sockId,
+        CProEventHandler* handler,
+        unsigned long     mask
+        );
+
+    virtual unsigned long PRO_CALLTYPE DropRaisedEvents(PRO_INT64 sockId);
+
+    virtual bool PRO_CALLTYPE InitTimers(bool timingWheel);
+
+    virtual unsigned long PRO_CALLTYPE ScheduleTimer(
+        IProOnTimer* onTimer,
+        PRO_UINT64   timeSpan,
+        bool         recurring,
+        PRO_INT64    userData
+        );
+
+    virtual unsigned long PRO_CALLTYPE ScheduleHeartbeatTimer(
+        IProOnTimer* onTimer,
+        PRO_INT64    userData
+        );
+
+    virtual unsigned long PRO_CALLTYPE JoinHeartbeatGroup(
+        PRO_HEARTBEAT_ENTRY* entry,
+        IProOnTimer*         onTimer,
+        PRO_INT64            userData
+        );
+
+    virtual bool PRO_CALLTYPE LeaveHeartbeatGroup(
+        PRO_HEARTBEAT_ENTRY* entry,
+        unsigned long        timerId
+        );
+
+    virtual bool PRO_CALLTYPE UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds);
+
+    virtual bool PRO_CALLTYPE CancelTimer(unsigned long timerId);
+
+    virtual unsigned long PRO_CALLTYPE GetTimerCount() const;
+
+    virtual void PRO_CALLTYPE WorkerRun();
+
+private:
+
+    bool SetupRing_i();
+
+    void CleanupRing_i();
+
+    void MarkDirty_i(PRO_INT64 sockId);
+
+    void FlushPolls_i();
+
+    io_uring_sqe* GetSqe_i();
+
+    int Enter_i(
+        unsigned int toSubmit,
+        unsigned int minComplete
+        );
+
+    int ReapCqes_i(bool& timerReady); /* returns the number of the ready handlers */
+
+    void SetTimer_i();
+
+    void PollTimers();
+
+    virtual void PRO_CALLTYPE OnInput(PRO_INT64 sockId);
+
+    virtual void PRO_CALLTYPE OnError(
+        PRO_INT64 sockId,
+        long      errorCode
+        );
+
+private:
+
+    int                  m_ringfd;
+    void*                m_ring;     /* the sq and cq rings in a single mmap */
+    size_t               m_ringSize;
+    io_uring_sqe*        m_sqes;
+    size_t               m_sqesSize;
+    unsigned int*        m_sqHead;
+    unsigned int*        m_sqTail;
+    unsigned int*        m_sqArray;
+    unsigned int         m_sqMask;
+    unsigned int         m_sqEntries;
+    unsigned int*        m_cqHead;
+    unsigned int*        m_cqTail;
+    io_uring_cqe*        m_cqes;
+    unsigned int         m_cqMask;
+    unsigned int         m_sqLocalTail;
+    unsigned int         m_toSubmit;
+    PRO_UINT32           m_armSeq;
+
+    int                  m_timerfd;
+    bool                 m_timerArmed;
+    PRO_INT64            m_armedTick;
+    CProTimerFactory     m_timerFactory;
+    PRO_EPOLL_READY_INFO m_ready[PRO_EPOLLFD_GETSIZE];
+
+    CProStlVector<PRO_URING_POLL_INFO>  m_polls;        /* indexed by sockId */
+    CProStlVector<PRO_INT64>            m_dirty;
+    CProStlVector<PRO_EPOLL_READY_INFO> m_raised;
+    CProStlVector<PRO_EPOLL_READY_INFO> m_raised2;      /* swapped with m_raised */
+    bool                                m_raisedBySelf;
+    bool                                m_cqBacklog;    /* more cqes than m_ready */
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+#endif /* PRO_HAS_EPOLL, PRO_HAS_IO_URING */
+
+#endif /* PRO_URING_REACTOR_H */
@@ -420,6 +420,13 @@ CRtpPacket::GetTick_i() const
     return (m_tick);
 }
 
+IProSendBuffer*
+PRO_CALLTYPE
+CRtpPacket::GetSendBuffer_i()
+{
+    return (this);
+}
+
 const RTP_PACKET&
 CRtpPacket::GetPacket() const
 {
@@ -24,6 +24,7 @@
 #define RTP_PACKET_H
 
 #include "rtp_framework.h"
+#include "../pro_net/pro_net.h"
 #include "../pro_util/pro_memory_pool.h"
 #include "../pro_util/pro_ref_count.h"
 
@@ -89,7 +90,7 @@ struct RTP_PACKET
 /////////////////////////////////////////////////////////////////////////////
 ////
 
-class CRtpPacket : public IRtpPacket, public CProRefCount
+class CRtpPacket : public IRtpPacket, public IProSendBuffer, public CProRefCount
 {
 public:
 
@@ -165,6 +166,8 @@ public:
 
     virtual PRO_INT64 PRO_CALLTYPE GetTick_i() const;
 
+    virtual IProSendBuffer* PRO_CALLTYPE GetSendBuffer_i();
+
     /*
      * Don't use this method unless you know why and how to use it.
      */
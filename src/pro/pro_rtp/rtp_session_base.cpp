@@ -68,7 +68,7 @@ CRtpSessionBase::CRtpSessionBase()
     m_onSendTick     = m_initTick; /* assert(m_onSendTick >= m_sendTick) */
     m_peerAliveTick  = m_initTick;
     m_timeoutTimerId = 0;
-    m_onOkTimerId    = 0;
+    m_onOkTaskId     = 0;
     m_handshakeOk    = false;
     m_onOkCalled     = false;
 
@@ -316,7 +316,8 @@ CRtpSessionBase::SendPacket(IRtpPacket* packet,
         {
             if (m_remoteAddr.sin_addr.s_addr != 0)
             {
-                ret = m_trans->SendData(
+                ret = m_trans->SendBuffer(
+                    packet->GetSendBuffer_i(),
                     (char*)packet->GetPayloadBuffer() - otherSize,
                     packet->GetPayloadSize() + otherSize,
                     m_actionId + 1,
@@ -325,7 +326,8 @@ CRtpSessionBase::SendPacket(IRtpPacket* packet,
             }
             else if (m_remoteAddrConfig.sin_addr.s_addr != 0)
             {
-                ret = m_trans->SendData(
+                ret = m_trans->SendBuffer(
+                    packet->GetSendBuffer_i(),
                     (char*)packet->GetPayloadBuffer() - otherSize,
                     packet->GetPayloadSize() + otherSize,
                     m_actionId + 1,
@@ -339,7 +341,8 @@ CRtpSessionBase::SendPacket(IRtpPacket* packet,
         }
         else
         {
-            ret = m_trans->SendData(
+            ret = m_trans->SendBuffer(
+                packet->GetSendBuffer_i(),
                 (char*)packet->GetPayloadBuffer() - otherSize,
                 packet->GetPayloadSize() + otherSize,
                 m_actionId + 1,
@@ -1148,7 +1151,7 @@ CRtpSessionBase::OnTimer(unsigned long timerId,
             return;
         }
 
-        if (timerId != m_timeoutTimerId && timerId != m_onOkTimerId)
+        if (timerId != m_timeoutTimerId && timerId != m_onOkTaskId)
         {
             return;
         }
@@ -1162,8 +1165,7 @@ CRtpSessionBase::OnTimer(unsigned long timerId,
         }
         else
         {
-            m_reactor->CancelTimer(m_onOkTimerId);
-            m_onOkTimerId = 0;
+            m_onOkTaskId = 0;
         }
 
         m_observer->AddRef();
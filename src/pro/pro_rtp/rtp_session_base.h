@@ -213,7 +213,7 @@ protected:
     PRO_INT64               m_onSendTick;       /* for tcp, tcp_ex, ssl_ex */
     PRO_INT64               m_peerAliveTick;
     unsigned long           m_timeoutTimerId;
-    unsigned long           m_onOkTimerId;
+    unsigned long           m_onOkTaskId;
     bool                    m_handshakeOk;      /* for udp_ex, tcp_ex, ssl_ex */
     bool                    m_onOkCalled;
     mutable CProThreadMutex m_lock;
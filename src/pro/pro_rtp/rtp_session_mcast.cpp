@@ -148,7 +148,7 @@ CRtpSessionMcast::Init(IRtpSessionObserver* observer,
         observer->AddRef();
         m_observer    = observer;
         m_reactor     = reactor;
-        m_onOkTimerId = reactor->ScheduleTimer(this, 0, false);
+        m_onOkTaskId  = reactor->PostTaskToTransport(m_trans, this);
     }
 
     return (true);
@@ -168,8 +168,7 @@ CRtpSessionMcast::Fini()
             return;
         }
 
-        m_reactor->CancelTimer(m_onOkTimerId);
-        m_onOkTimerId = 0;
+        m_onOkTaskId = 0;
 
         ProCloseSockId(m_dummySockId);
         m_dummySockId = -1;
@@ -136,7 +136,7 @@ CRtpSessionMcastEx::Init(IRtpSessionObserver* observer,
         observer->AddRef();
         m_observer    = observer;
         m_reactor     = reactor;
-        m_onOkTimerId = reactor->ScheduleTimer(this, 0, false);
+        m_onOkTaskId  = reactor->PostTaskToTransport(m_trans, this);
     }
 
     return (true);
@@ -156,8 +156,7 @@ CRtpSessionMcastEx::Fini()
             return;
         }
 
-        m_reactor->CancelTimer(m_onOkTimerId);
-        m_onOkTimerId = 0;
+        m_onOkTaskId = 0;
 
         trans = m_trans;
         m_trans = NULL;
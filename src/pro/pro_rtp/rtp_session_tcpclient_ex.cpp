@@ -26,6 +26,7 @@
 #include "../pro_util/pro_time_util.h"
 #include "../pro_util/pro_z.h"
 #include <cassert>
+#include <cstring>
 
 /////////////////////////////////////////////////////////////////////////////
 ////
@@ -717,8 +718,22 @@ CRtpSessionTcpclientEx::OnRecv(IProTransport*          trans,
                 break;
             }
 
+            /*
+             * the packet is parsed in the pool, unless it wraps around the ring
+             */
+            const void*   buf1  = NULL;
+            unsigned long size1 = 0;
+            recvPool.PeekSegments(&buf1, &size1, NULL, NULL);
+
             RTP_EXT ext;
-            recvPool.PeekData(&ext, sizeof(RTP_EXT));
+            if (size1 >= sizeof(RTP_EXT))
+            {
+                ext = *(const RTP_EXT*)buf1;
+            }
+            else
+            {
+                recvPool.PeekData(&ext, sizeof(RTP_EXT));
+            }
             ext.hdrAndPayloadSize = pbsd_ntoh16(ext.hdrAndPayloadSize);
             if (dataSize < sizeof(RTP_EXT) + ext.hdrAndPayloadSize)
             {
@@ -733,17 +748,34 @@ CRtpSessionTcpclientEx::OnRecv(IProTransport*          trans,
 
             assert(m_handshakeOk);
 
-            packet = CRtpPacket::CreateInstance(sizeof(RTP_EXT) + ext.hdrAndPayloadSize);
-            if (packet == NULL)
+            const unsigned long packetSize = sizeof(RTP_EXT) + ext.hdrAndPayloadSize;
+            const bool          inPlace    = size1 >= packetSize;
+
+            if (inPlace && !CRtpPacket::ParseExtBuffer((const char*)buf1, (PRO_UINT16)packetSize))
+            {
+                error = true; /* a bad packet is not copied */
+            }
+            else
+            {
+                packet = CRtpPacket::CreateInstance(packetSize);
+            }
+
+            if (error || packet == NULL)
             {
                 error = true;
             }
             else
             {
-                recvPool.PeekData(
-                    packet->GetPayloadBuffer(), sizeof(RTP_EXT) + ext.hdrAndPayloadSize);
+                if (inPlace)
+                {
+                    memcpy(packet->GetPayloadBuffer(), buf1, packetSize);
+                }
+                else
+                {
+                    recvPool.PeekData(packet->GetPayloadBuffer(), packetSize);
+                }
 
-                if (!CRtpPacket::ParseExtBuffer(
+                if (!inPlace && !CRtpPacket::ParseExtBuffer(
                     (char*)packet->GetPayloadBuffer(), packet->GetPayloadSize()))
                 {
                     error = true;
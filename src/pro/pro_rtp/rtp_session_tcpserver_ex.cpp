@@ -24,6 +24,7 @@
 #include "../pro_util/pro_time_util.h"
 #include "../pro_util/pro_z.h"
 #include <cassert>
+#include <cstring>
 
 /////////////////////////////////////////////////////////////////////////////
 ////
@@ -126,15 +127,14 @@ CRtpSessionTcpserverEx::Init(IRtpSessionObserver* observer,
         m_reactor      = reactor;
         m_tcpConnected = true;
         m_handshakeOk  = true;
-        m_onOkTimerId  = reactor->ScheduleTimer(this, 0, false);
+        m_onOkTaskId   = reactor->PostTaskToTransport(m_trans, this);
 
         if (DoHandshake())
         {
             return (true);
         }
 
-        m_reactor->CancelTimer(m_onOkTimerId);
-        m_onOkTimerId = 0;
+        m_onOkTaskId = 0;
     }
 
     Fini();
@@ -156,8 +156,7 @@ CRtpSessionTcpserverEx::Fini()
             return;
         }
 
-        m_reactor->CancelTimer(m_onOkTimerId);
-        m_onOkTimerId = 0;
+        m_onOkTaskId = 0;
 
         trans = m_trans;
         m_trans = NULL;
@@ -230,8 +229,22 @@ CRtpSessionTcpserverEx::OnRecv(IProTransport*          trans,
                 break;
             }
 
+            /*
+             * the packet is parsed in the pool, unless it wraps around the ring
+             */
+            const void*   buf1  = NULL;
+            unsigned long size1 = 0;
+            recvPool.PeekSegments(&buf1, &size1, NULL, NULL);
+
             RTP_EXT ext;
-            recvPool.PeekData(&ext, sizeof(RTP_EXT));
+            if (size1 >= sizeof(RTP_EXT))
+            {
+                ext = *(const RTP_EXT*)buf1;
+            }
+            else
+            {
+                recvPool.PeekData(&ext, sizeof(RTP_EXT));
+            }
             ext.hdrAndPayloadSize = pbsd_ntoh16(ext.hdrAndPayloadSize);
             if (dataSize < sizeof(RTP_EXT) + ext.hdrAndPayloadSize)
             {
@@ -244,17 +257,34 @@ CRtpSessionTcpserverEx::OnRecv(IProTransport*          trans,
                 continue;
             }
 
-            packet = CRtpPacket::CreateInstance(sizeof(RTP_EXT) + ext.hdrAndPayloadSize);
-            if (packet == NULL)
+            const unsigned long packetSize = sizeof(RTP_EXT) + ext.hdrAndPayloadSize;
+            const bool          inPlace    = size1 >= packetSize;
+
+            if (inPlace && !CRtpPacket::ParseExtBuffer((const char*)buf1, (PRO_UINT16)packetSize))
+            {
+                error = true; /* a bad packet is not copied */
+            }
+            else
+            {
+                packet = CRtpPacket::CreateInstance(packetSize);
+            }
+
+            if (error || packet == NULL)
             {
                 error = true;
             }
             else
             {
-                recvPool.PeekData(
-                    packet->GetPayloadBuffer(), sizeof(RTP_EXT) + ext.hdrAndPayloadSize);
+                if (inPlace)
+                {
+                    memcpy(packet->GetPayloadBuffer(), buf1, packetSize);
+                }
+                else
+                {
+                    recvPool.PeekData(packet->GetPayloadBuffer(), packetSize);
+                }
 
-                if (!CRtpPacket::ParseExtBuffer(
+                if (!inPlace && !CRtpPacket::ParseExtBuffer(
                     (char*)packet->GetPayloadBuffer(), packet->GetPayloadSize()))
                 {
                     error = true;
@@ -140,7 +140,7 @@ CRtpSessionUdpclient::Init(IRtpSessionObserver* observer,
         observer->AddRef();
         m_observer    = observer;
         m_reactor     = reactor;
-        m_onOkTimerId = reactor->ScheduleTimer(this, 0, false);
+        m_onOkTaskId  = reactor->PostTaskToTransport(m_trans, this);
     }
 
     return (true);
@@ -160,8 +160,7 @@ CRtpSessionUdpclient::Fini()
             return;
         }
 
-        m_reactor->CancelTimer(m_onOkTimerId);
-        m_onOkTimerId = 0;
+        m_onOkTaskId = 0;
 
         ProCloseSockId(m_dummySockId);
         m_dummySockId = -1;
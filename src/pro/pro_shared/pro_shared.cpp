@@ -45,6 +45,11 @@
 #include <cassert>
 #include <cstddef>
 
+#if defined(_MSC_VER) && (_MSC_VER > 1200) /* 1200 is 6.0 */
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#endif
+
 #if defined(_MSC_VER)
 #if defined(_WIN32_WCE)
 #pragma comment(lib, "mmtimer.lib")
@@ -139,6 +144,70 @@ private:
 
 #define SMALL_OBJ_SIZE 4096        /* sizeof(obj) <= 4096 */
 
+#if defined(__GNUC__)
+#define CALLER_ADDRESS() __builtin_return_address(0)
+#elif defined(_MSC_VER) && (_MSC_VER > 1200) /* 1200 is 6.0 */
+#define CALLER_ADDRESS() _ReturnAddress()
+#else
+#define CALLER_ADDRESS() NULL
+#endif
+
+#if !defined(WIN32) && !defined(_WIN32_WCE) && !defined(PRO_LACKS_SGI_POOL_CACHE)
+#define PRO_HAS_SGI_POOL_CACHE
+#endif
+
+#define CACHE_MAX_OBJS  64          /* per size-class, per pool, per thread */
+#define CACHE_MAX_BYTES (1024 * 32) /* per size-class, per pool, per thread */
+
+#define STAT_COUNTED    0x80000000 /* the 2nd UINT32 of the buffer header */
+#define STAT_MAX_SAMPLES 4096
+
+/*
+ * the statistics of a size-class
+ */
+struct PRO_SGI_STAT_I
+{
+    volatile unsigned long allocs;
+    volatile unsigned long frees;
+    volatile unsigned long liveObjs;
+    volatile unsigned long maxLiveObjs;
+    volatile unsigned long liveBytes;
+};
+
+/*
+ * a sampled live buffer
+ */
+struct PRO_SGI_SAMPLE_I
+{
+    const void*   caller;
+    unsigned long poolIndex;
+    unsigned long size;
+    unsigned long nextFree; /* index + 1 */
+};
+
+/*
+ * a thread-local magazine of a size-class
+ */
+struct PRO_SGI_MAGAZINE
+{
+    std::_Obj*    head;
+    unsigned long count;
+};
+
+/*
+ * the thread-local caches in front of the SGI pools
+ */
+struct PRO_SGI_CACHE
+{
+    PRO_SGI_MAGAZINE magazines[10][60];
+    PRO_UINT64       hits[10][2];   /* [poolIndex][small/big] */
+    PRO_UINT64       misses[10][2]; /* [poolIndex][small/big] */
+    unsigned long    trimGen[10];   /* the last g_s_cacheTrimGen seen */
+    bool             enabled;
+    PRO_SGI_CACHE*   prev;
+    PRO_SGI_CACHE*   next;
+};
+
 #if defined(WIN32) || defined(_WIN32_WCE)
 static volatile bool                     g_s_tlsFlag       = false;
 static unsigned long                     g_s_tlsKey0       = (unsigned long)-1;
@@ -224,6 +293,36 @@ static std::__default_alloc_template<90> g_s_allocator9a; /* small, (   1 <= siz
 static std::__default_alloc_template<91> g_s_allocator9b; /* big  , (4097 <= sizeof(obj) <= 1024 * 128) */
 static CProThreadMutex_s                 g_s_lock9;
 
+/*
+ * thread-local caches
+ */
+#if defined(PRO_HAS_SGI_POOL_CACHE)
+static volatile bool                     g_s_cacheEnabled  = true;
+#else
+static volatile bool                     g_s_cacheEnabled  = false;
+#endif
+static volatile bool                     g_s_cacheKeyFlag  = false;
+#if defined(PRO_HAS_SGI_POOL_CACHE)
+static pthread_key_t                     g_s_cacheKey;
+static volatile unsigned long            g_s_cacheTrimGen[10]; /* bumped by ProTrimSgiPool() */
+#endif
+static PRO_SGI_CACHE*                    g_s_cacheList     = NULL;
+static PRO_UINT64                        g_s_cacheHits[10][2];   /* for the exited threads */
+static PRO_UINT64                        g_s_cacheMisses[10][2]; /* for the exited threads */
+static CProThreadMutex_s                 g_s_cacheLock;
+
+/*
+ * statistics
+ */
+static volatile bool                     g_s_statEnabled    = false;
+static volatile unsigned long            g_s_statSampleRate = 0;
+static volatile unsigned long            g_s_statSampleTick = 0;
+static PRO_SGI_STAT_I                    g_s_stats[10][60];
+static PRO_SGI_SAMPLE_I                  g_s_samples[STAT_MAX_SAMPLES];
+static unsigned long                     g_s_sampleFree     = 0; /* index + 1 */
+static unsigned long                     g_s_sampleNext     = 0; /* never used */
+static CProThreadMutex_s                 g_s_statLock;
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -394,65 +493,889 @@ pbsd_select_i(PRO_INT64       nfds,
     while (retc < 0 && pbsd_errno_i() == PBSD_EINTR);
 #endif
 
-    return (retc);
+    return (retc);
+}
+
+static
+void
+PRO_CALLTYPE
+pbsd_closesocket_i(PRO_INT64 fd)
+{
+    if (fd == -1)
+    {
+        return;
+    }
+
+#if defined(WIN32) || defined(_WIN32_WCE)
+    closesocket((SOCKET)fd);
+#else
+    close((int)fd);
+#endif
+}
+
+static
+void
+PRO_CALLTYPE
+InitSocket_i()
+{
+    g_s_sockId = pbsd_socket_i(AF_INET, SOCK_DGRAM, 0);
+}
+
+static
+void
+PRO_CALLTYPE
+FiniSocket_i()
+{
+    pbsd_closesocket_i(g_s_sockId);
+    g_s_sockId = -1;
+}
+
+static
+void
+PRO_CALLTYPE
+Delay_i(unsigned long milliseconds)
+{
+    const PRO_INT64 te = ProGetTickCount64_s() + milliseconds;
+
+    while (1)
+    {
+#if defined(WIN32) || defined(_WIN32_WCE)
+        ::Sleep(1);
+#else
+        usleep(500);
+#endif
+
+        if (ProGetTickCount64_s() >= te)
+        {
+            break;
+        }
+    }
+}
+
+static
+unsigned long
+PRO_CALLTYPE
+AtomicAdd_i(volatile unsigned long* value,
+            long                    delta)
+{
+#if defined(WIN32) || defined(_WIN32_WCE)
+    const unsigned long ret =
+        (unsigned long)(::InterlockedExchangeAdd((long*)value, delta) + delta);
+#elif defined(PRO_HAS_ATOMOP)
+    const unsigned long ret = __sync_add_and_fetch(value, (unsigned long)delta);
+#else
+    g_s_statLock.Lock();
+    *value += (unsigned long)delta;
+    const unsigned long ret = *value;
+    g_s_statLock.Unlock();
+#endif
+
+    return (ret);
+}
+
+static
+void
+PRO_CALLTYPE
+AtomicMax_i(volatile unsigned long* value,
+            unsigned long           newValue)
+{
+#if defined(WIN32) || defined(_WIN32_WCE)
+    unsigned long oldValue = *value;
+    while (newValue > oldValue)
+    {
+        const unsigned long ret = (unsigned long)::InterlockedCompareExchange(
+            (long*)value, (long)newValue, (long)oldValue);
+        if (ret == oldValue)
+        {
+            break;
+        }
+
+        oldValue = ret;
+    }
+#elif defined(PRO_HAS_ATOMOP)
+    unsigned long oldValue = *value;
+    while (newValue > oldValue)
+    {
+        const unsigned long ret =
+            __sync_val_compare_and_swap(value, oldValue, newValue);
+        if (ret == oldValue)
+        {
+            break;
+        }
+
+        oldValue = ret;
+    }
+#else
+    g_s_statLock.Lock();
+    if (newValue > *value)
+    {
+        *value = newValue;
+    }
+    g_s_statLock.Unlock();
+#endif
+}
+
+static
+int
+PRO_CALLTYPE
+StatIndex_i(size_t size)
+{
+    if (size > (size_t)std::_MAX_BYTES)
+    {
+        return (59);
+    }
+
+    return (g_s_allocator0a.freelist_index(size));
+}
+
+/*
+ * p[0] is the size, p[1] is the tag
+ */
+static
+void
+PRO_CALLTYPE
+StatAllocate_i(PRO_UINT32*   p,
+               unsigned long poolIndex,
+               const void*   caller)
+{
+    p[1] = 0;
+
+    if (!g_s_statEnabled)
+    {
+        return;
+    }
+
+    PRO_SGI_STAT_I& stat = g_s_stats[poolIndex][StatIndex_i(p[0])];
+
+    AtomicAdd_i(&stat.allocs, 1);
+    AtomicAdd_i(&stat.liveBytes, (long)p[0]);
+    AtomicMax_i(&stat.maxLiveObjs, AtomicAdd_i(&stat.liveObjs, 1));
+
+    p[1] = STAT_COUNTED;
+
+    const unsigned long sampleRate = g_s_statSampleRate;
+    if (sampleRate == 0 || AtomicAdd_i(&g_s_statSampleTick, 1) % sampleRate != 0)
+    {
+        return;
+    }
+
+    g_s_statLock.Lock();
+
+    unsigned long index = 0; /* index + 1 */
+    if (g_s_sampleFree > 0)
+    {
+        index          = g_s_sampleFree;
+        g_s_sampleFree = g_s_samples[index - 1].nextFree;
+    }
+    else if (g_s_sampleNext < STAT_MAX_SAMPLES)
+    {
+        index = ++g_s_sampleNext;
+    }
+    else
+    {
+    }
+
+    if (index > 0)
+    {
+        PRO_SGI_SAMPLE_I& sample = g_s_samples[index - 1];
+        sample.caller    = caller;
+        sample.poolIndex = poolIndex;
+        sample.size      = p[0];
+        sample.nextFree  = 0;
+
+        p[1] |= index;
+    }
+
+    g_s_statLock.Unlock();
+}
+
+static
+void
+PRO_CALLTYPE
+StatDeallocate_i(PRO_UINT32*   p,
+                 unsigned long poolIndex)
+{
+    if ((p[1] & STAT_COUNTED) == 0)
+    {
+        return;
+    }
+
+    PRO_SGI_STAT_I& stat = g_s_stats[poolIndex][StatIndex_i(p[0])];
+
+    AtomicAdd_i(&stat.frees, 1);
+    AtomicAdd_i(&stat.liveBytes, -(long)p[0]);
+    AtomicAdd_i(&stat.liveObjs, -1);
+
+    const unsigned long index = p[1] & ~STAT_COUNTED;
+    if (index > 0 && index <= STAT_MAX_SAMPLES)
+    {
+        g_s_statLock.Lock();
+
+        PRO_SGI_SAMPLE_I& sample = g_s_samples[index - 1];
+        sample.caller   = NULL;
+        sample.nextFree = g_s_sampleFree;
+        g_s_sampleFree  = index;
+
+        g_s_statLock.Unlock();
+    }
+
+    p[1] = 0;
+}
+
+#if defined(PRO_HAS_SGI_POOL_CACHE)
+
+static
+unsigned long
+PRO_CALLTYPE
+CacheCapacity_i(size_t objSize)
+{
+    if (objSize * 2 > CACHE_MAX_BYTES)
+    {
+        return (0);
+    }
+
+    unsigned long capacity = (unsigned long)(CACHE_MAX_BYTES / objSize);
+    if (capacity > CACHE_MAX_OBJS)
+    {
+        capacity = CACHE_MAX_OBJS;
+    }
+
+    return (capacity);
+}
+
+static
+int
+PRO_CALLTYPE
+AllocateBatch_i(size_t        objSize,
+                int           count,
+                std::_Obj*&   head,
+                unsigned long poolIndex)
+{
+    int got = 0;
+
+    if (objSize <= SMALL_OBJ_SIZE)
+    {
+        switch (poolIndex)
+        {
+        case 0:
+            {
+                g_s_lock0.Lock();
+                got = g_s_allocator0a.allocate_batch(objSize, count, head);
+                g_s_lock0.Unlock();
+                break;
+            }
+        case 1:
+            {
+                g_s_lock1.Lock();
+                got = g_s_allocator1a.allocate_batch(objSize, count, head);
+                g_s_lock1.Unlock();
+                break;
+            }
+        case 2:
+            {
+                g_s_lock2.Lock();
+                got = g_s_allocator2a.allocate_batch(objSize, count, head);
+                g_s_lock2.Unlock();
+                break;
+            }
+        case 3:
+            {
+                g_s_lock3.Lock();
+                got = g_s_allocator3a.allocate_batch(objSize, count, head);
+                g_s_lock3.Unlock();
+                break;
+            }
+        case 4:
+            {
+                g_s_lock4.Lock();
+                got = g_s_allocator4a.allocate_batch(objSize, count, head);
+                g_s_lock4.Unlock();
+                break;
+            }
+        case 5:
+            {
+                g_s_lock5.Lock();
+                got = g_s_allocator5a.allocate_batch(objSize, count, head);
+                g_s_lock5.Unlock();
+                break;
+            }
+        case 6:
+            {
+                g_s_lock6.Lock();
+                got = g_s_allocator6a.allocate_batch(objSize, count, head);
+                g_s_lock6.Unlock();
+                break;
+            }
+        case 7:
+            {
+                g_s_lock7.Lock();
+                got = g_s_allocator7a.allocate_batch(objSize, count, head);
+                g_s_lock7.Unlock();
+                break;
+            }
+        case 8:
+            {
+                g_s_lock8.Lock();
+                got = g_s_allocator8a.allocate_batch(objSize, count, head);
+                g_s_lock8.Unlock();
+                break;
+            }
+        case 9:
+            {
+                g_s_lock9.Lock();
+                got = g_s_allocator9a.allocate_batch(objSize, count, head);
+                g_s_lock9.Unlock();
+                break;
+            }
+        } /* end of switch (...) */
+    }
+    else
+    {
+        switch (poolIndex)
+        {
+        case 0:
+            {
+                g_s_lock0.Lock();
+                got = g_s_allocator0b.allocate_batch(objSize, count, head);
+                g_s_lock0.Unlock();
+                break;
+            }
+        case 1:
+            {
+                g_s_lock1.Lock();
+                got = g_s_allocator1b.allocate_batch(objSize, count, head);
+                g_s_lock1.Unlock();
+                break;
+            }
+        case 2:
+            {
+                g_s_lock2.Lock();
+                got = g_s_allocator2b.allocate_batch(objSize, count, head);
+                g_s_lock2.Unlock();
+                break;
+            }
+        case 3:
+            {
+                g_s_lock3.Lock();
+                got = g_s_allocator3b.allocate_batch(objSize, count, head);
+                g_s_lock3.Unlock();
+                break;
+            }
+        case 4:
+            {
+                g_s_lock4.Lock();
+                got = g_s_allocator4b.allocate_batch(objSize, count, head);
+                g_s_lock4.Unlock();
+                break;
+            }
+        case 5:
+            {
+                g_s_lock5.Lock();
+                got = g_s_allocator5b.allocate_batch(objSize, count, head);
+                g_s_lock5.Unlock();
+                break;
+            }
+        case 6:
+            {
+                g_s_lock6.Lock();
+                got = g_s_allocator6b.allocate_batch(objSize, count, head);
+                g_s_lock6.Unlock();
+                break;
+            }
+        case 7:
+            {
+                g_s_lock7.Lock();
+                got = g_s_allocator7b.allocate_batch(objSize, count, head);
+                g_s_lock7.Unlock();
+                break;
+            }
+        case 8:
+            {
+                g_s_lock8.Lock();
+                got = g_s_allocator8b.allocate_batch(objSize, count, head);
+                g_s_lock8.Unlock();
+                break;
+            }
+        case 9:
+            {
+                g_s_lock9.Lock();
+                got = g_s_allocator9b.allocate_batch(objSize, count, head);
+                g_s_lock9.Unlock();
+                break;
+            }
+        } /* end of switch (...) */
+    }
+
+    return (got);
+}
+
+static
+void
+PRO_CALLTYPE
+DeallocateBatch_i(size_t        objSize,
+                  std::_Obj*    head,
+                  std::_Obj*    tail,
+                  unsigned long poolIndex)
+{
+    if (objSize <= SMALL_OBJ_SIZE)
+    {
+        switch (poolIndex)
+        {
+        case 0:
+            {
+                g_s_lock0.Lock();
+                g_s_allocator0a.deallocate_batch(head, tail, objSize);
+                g_s_lock0.Unlock();
+                break;
+            }
+        case 1:
+            {
+                g_s_lock1.Lock();
+                g_s_allocator1a.deallocate_batch(head, tail, objSize);
+                g_s_lock1.Unlock();
+                break;
+            }
+        case 2:
+            {
+                g_s_lock2.Lock();
+                g_s_allocator2a.deallocate_batch(head, tail, objSize);
+                g_s_lock2.Unlock();
+                break;
+            }
+        case 3:
+            {
+                g_s_lock3.Lock();
+                g_s_allocator3a.deallocate_batch(head, tail, objSize);
+                g_s_lock3.Unlock();
+                break;
+            }
+        case 4:
+            {
+                g_s_lock4.Lock();
+                g_s_allocator4a.deallocate_batch(head, tail, objSize);
+                g_s_lock4.Unlock();
+                break;
+            }
+        case 5:
+            {
+                g_s_lock5.Lock();
+                g_s_allocator5a.deallocate_batch(head, tail, objSize);
+                g_s_lock5.Unlock();
+                break;
+            }
+        case 6:
+            {
+                g_s_lock6.Lock();
+                g_s_allocator6a.deallocate_batch(head, tail, objSize);
+                g_s_lock6.Unlock();
+                break;
+            }
+        case 7:
+            {
+                g_s_lock7.Lock();
+                g_s_allocator7a.deallocate_batch(head, tail, objSize);
+                g_s_lock7.Unlock();
+                break;
+            }
+        case 8:
+            {
+                g_s_lock8.Lock();
+                g_s_allocator8a.deallocate_batch(head, tail, objSize);
+                g_s_lock8.Unlock();
+                break;
+            }
+        case 9:
+            {
+                g_s_lock9.Lock();
+                g_s_allocator9a.deallocate_batch(head, tail, objSize);
+                g_s_lock9.Unlock();
+                break;
+            }
+        } /* end of switch (...) */
+    }
+    else
+    {
+        switch (poolIndex)
+        {
+        case 0:
+            {
+                g_s_lock0.Lock();
+                g_s_allocator0b.deallocate_batch(head, tail, objSize);
+                g_s_lock0.Unlock();
+                break;
+            }
+        case 1:
+            {
+                g_s_lock1.Lock();
+                g_s_allocator1b.deallocate_batch(head, tail, objSize);
+                g_s_lock1.Unlock();
+                break;
+            }
+        case 2:
+            {
+                g_s_lock2.Lock();
+                g_s_allocator2b.deallocate_batch(head, tail, objSize);
+                g_s_lock2.Unlock();
+                break;
+            }
+        case 3:
+            {
+                g_s_lock3.Lock();
+                g_s_allocator3b.deallocate_batch(head, tail, objSize);
+                g_s_lock3.Unlock();
+                break;
+            }
+        case 4:
+            {
+                g_s_lock4.Lock();
+                g_s_allocator4b.deallocate_batch(head, tail, objSize);
+                g_s_lock4.Unlock();
+                break;
+            }
+        case 5:
+            {
+                g_s_lock5.Lock();
+                g_s_allocator5b.deallocate_batch(head, tail, objSize);
+                g_s_lock5.Unlock();
+                break;
+            }
+        case 6:
+            {
+                g_s_lock6.Lock();
+                g_s_allocator6b.deallocate_batch(head, tail, objSize);
+                g_s_lock6.Unlock();
+                break;
+            }
+        case 7:
+            {
+                g_s_lock7.Lock();
+                g_s_allocator7b.deallocate_batch(head, tail, objSize);
+                g_s_lock7.Unlock();
+                break;
+            }
+        case 8:
+            {
+                g_s_lock8.Lock();
+                g_s_allocator8b.deallocate_batch(head, tail, objSize);
+                g_s_lock8.Unlock();
+                break;
+            }
+        case 9:
+            {
+                g_s_lock9.Lock();
+                g_s_allocator9b.deallocate_batch(head, tail, objSize);
+                g_s_lock9.Unlock();
+                break;
+            }
+        } /* end of switch (...) */
+    }
+}
+
+static
+void
+PRO_CALLTYPE
+FlushCachePool_i(PRO_SGI_CACHE* cache,
+                 unsigned long  poolIndex)
+{
+    for (int i = 0; i < 60; ++i)
+    {
+        PRO_SGI_MAGAZINE& magazine = cache->magazines[poolIndex][i];
+        if (magazine.head == NULL)
+        {
+            continue;
+        }
+
+        std::_Obj* tail = magazine.head;
+        while (tail->_M_free_list_link != NULL)
+        {
+            tail = tail->_M_free_list_link;
+        }
+
+        DeallocateBatch_i(g_s_allocator0a.obj_size(i), magazine.head, tail, poolIndex);
+
+        magazine.head  = NULL;
+        magazine.count = 0;
+    }
+}
+
+static
+void
+PRO_CALLTYPE
+FlushCache_i(PRO_SGI_CACHE* cache)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        FlushCachePool_i(cache, i);
+    }
+}
+
+/*
+ * the magazines are owned by their threads, and can't be flushed by others.
+ * after a ProTrimSgiPool(), each thread flushes its own on the next call
+ */
+static
+void
+PRO_CALLTYPE
+CheckTrim_i(PRO_SGI_CACHE* cache,
+            unsigned long  poolIndex)
+{
+    const unsigned long trimGen = g_s_cacheTrimGen[poolIndex];
+    if (cache->trimGen[poolIndex] != trimGen)
+    {
+        cache->trimGen[poolIndex] = trimGen;
+        FlushCachePool_i(cache, poolIndex);
+    }
+}
+
+static
+void
+DestroyCache_i(void* arg)
+{
+    PRO_SGI_CACHE* const cache = (PRO_SGI_CACHE*)arg;
+    if (cache == NULL)
+    {
+        return;
+    }
+
+    FlushCache_i(cache);
+
+    g_s_cacheLock.Lock();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        g_s_cacheHits[i][0]   += cache->hits[i][0];
+        g_s_cacheHits[i][1]   += cache->hits[i][1];
+        g_s_cacheMisses[i][0] += cache->misses[i][0];
+        g_s_cacheMisses[i][1] += cache->misses[i][1];
+    }
+
+    if (cache->prev != NULL)
+    {
+        cache->prev->next = cache->next;
+    }
+    else
+    {
+        g_s_cacheList = cache->next;
+    }
+    if (cache->next != NULL)
+    {
+        cache->next->prev = cache->prev;
+    }
+
+    g_s_cacheLock.Unlock();
+
+    free(cache);
+}
+
+static
+PRO_SGI_CACHE*
+PRO_CALLTYPE
+GetCache_i()
+{
+    if (!g_s_cacheKeyFlag)
+    {
+        g_s_lock.Lock();
+        if (!g_s_cacheKeyFlag) /* double check */
+        {
+            if (pthread_key_create(&g_s_cacheKey, &DestroyCache_i) == 0)
+            {
+                g_s_cacheKeyFlag = true;
+            }
+            else
+            {
+                g_s_cacheEnabled = false;
+            }
+        }
+        g_s_lock.Unlock();
+
+        if (!g_s_cacheKeyFlag)
+        {
+            return (NULL);
+        }
+    }
+
+    PRO_SGI_CACHE* cache = (PRO_SGI_CACHE*)pthread_getspecific(g_s_cacheKey);
+    if (cache != NULL)
+    {
+        return (cache);
+    }
+
+    cache = (PRO_SGI_CACHE*)calloc(1, sizeof(PRO_SGI_CACHE));
+    if (cache == NULL)
+    {
+        return (NULL);
+    }
+
+    if (pthread_setspecific(g_s_cacheKey, cache) != 0)
+    {
+        free(cache);
+
+        return (NULL);
+    }
+
+    cache->enabled = true;
+
+    int i = 0;
+    for (; i < 10; ++i)
+    {
+        cache->trimGen[i] = g_s_cacheTrimGen[i];
+    }
+
+    g_s_cacheLock.Lock();
+
+    cache->next = g_s_cacheList;
+    if (g_s_cacheList != NULL)
+    {
+        g_s_cacheList->prev = cache;
+    }
+    g_s_cacheList = cache;
+
+    g_s_cacheLock.Unlock();
+
+    return (cache);
+}
+
+/*
+ * the caller must make sure that (size <= _MAX_BYTES)
+ */
+static
+void*
+PRO_CALLTYPE
+CacheAllocate_i(size_t        size,
+                unsigned long poolIndex)
+{
+    if (!g_s_cacheEnabled)
+    {
+        return (NULL);
+    }
+
+    const int           index    = g_s_allocator0a.freelist_index(size);
+    const size_t        objSize  = g_s_allocator0a.obj_size(index);
+    const unsigned long capacity = CacheCapacity_i(objSize);
+    if (capacity == 0)
+    {
+        return (NULL);
+    }
+
+    PRO_SGI_CACHE* const cache = GetCache_i();
+    if (cache == NULL)
+    {
+        return (NULL);
+    }
+
+    cache->enabled = true;
+    CheckTrim_i(cache, poolIndex);
+
+    PRO_SGI_MAGAZINE& magazine = cache->magazines[poolIndex][index];
+    const int         big      = objSize <= SMALL_OBJ_SIZE ? 0 : 1;
+
+    if (magazine.head == NULL)
+    {
+        std::_Obj* head = NULL;
+        const int  got  = AllocateBatch_i(objSize, (int)(capacity + 1) / 2, head, poolIndex);
+        if (got == 0)
+        {
+            return (NULL);
+        }
+
+        magazine.head  = head;
+        magazine.count = got;
+        ++cache->misses[poolIndex][big];
+    }
+    else
+    {
+        ++cache->hits[poolIndex][big];
+    }
+
+    std::_Obj* const obj = magazine.head;
+    magazine.head = obj->_M_free_list_link;
+    --magazine.count;
+
+    return (obj);
 }
 
+/*
+ * the caller must make sure that (size <= _MAX_BYTES)
+ */
 static
-void
+bool
 PRO_CALLTYPE
-pbsd_closesocket_i(PRO_INT64 fd)
+CacheDeallocate_i(void*         buf,
+                  size_t        size,
+                  unsigned long poolIndex)
 {
-    if (fd == -1)
+    if (!g_s_cacheEnabled)
     {
-        return;
+        if (g_s_cacheKeyFlag)
+        {
+            /*
+             * return the objects of the current thread to the shared pools
+             */
+            PRO_SGI_CACHE* const cache =
+                (PRO_SGI_CACHE*)pthread_getspecific(g_s_cacheKey);
+            if (cache != NULL && cache->enabled)
+            {
+                FlushCache_i(cache);
+                cache->enabled = false;
+            }
+        }
+
+        return (false);
     }
 
-#if defined(WIN32) || defined(_WIN32_WCE)
-    closesocket((SOCKET)fd);
-#else
-    close((int)fd);
-#endif
-}
+    const int           index    = g_s_allocator0a.freelist_index(size);
+    const size_t        objSize  = g_s_allocator0a.obj_size(index);
+    const unsigned long capacity = CacheCapacity_i(objSize);
+    if (capacity == 0)
+    {
+        return (false);
+    }
 
-static
-void
-PRO_CALLTYPE
-InitSocket_i()
-{
-    g_s_sockId = pbsd_socket_i(AF_INET, SOCK_DGRAM, 0);
-}
+    PRO_SGI_CACHE* const cache = GetCache_i();
+    if (cache == NULL)
+    {
+        return (false);
+    }
 
-static
-void
-PRO_CALLTYPE
-FiniSocket_i()
-{
-    pbsd_closesocket_i(g_s_sockId);
-    g_s_sockId = -1;
-}
+    cache->enabled = true;
+    CheckTrim_i(cache, poolIndex);
 
-static
-void
-PRO_CALLTYPE
-Delay_i(unsigned long milliseconds)
-{
-    const PRO_INT64 te = ProGetTickCount64_s() + milliseconds;
+    PRO_SGI_MAGAZINE& magazine = cache->magazines[poolIndex][index];
 
-    while (1)
+    std::_Obj* const obj = (std::_Obj*)buf;
+    obj->_M_free_list_link = magazine.head;
+    magazine.head = obj;
+    ++magazine.count;
+
+    if (magazine.count > capacity)
     {
-#if defined(WIN32) || defined(_WIN32_WCE)
-        ::Sleep(1);
-#else
-        usleep(500);
-#endif
+        /*
+         * keep the newest half, and flush the rest in a batch
+         */
+        std::_Obj* keepTail = magazine.head;
+        for (unsigned long i = 1; i < capacity / 2; ++i)
+        {
+            keepTail = keepTail->_M_free_list_link;
+        }
 
-        if (ProGetTickCount64_s() >= te)
+        std::_Obj* const head = keepTail->_M_free_list_link;
+        std::_Obj*       tail = head;
+        while (tail->_M_free_list_link != NULL)
         {
-            break;
+            tail = tail->_M_free_list_link;
         }
+
+        keepTail->_M_free_list_link = NULL;
+        magazine.count = capacity / 2;
+
+        DeallocateBatch_i(objSize, head, tail, poolIndex);
     }
+
+    return (true);
 }
 
+#endif /* PRO_HAS_SGI_POOL_CACHE */
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -789,6 +1712,20 @@ ProAllocateSgiPoolBuffer(size_t        size,
 
     PRO_UINT32* p = NULL;
 
+#if defined(PRO_HAS_SGI_POOL_CACHE)
+    if (size <= (size_t)std::_MAX_BYTES)
+    {
+        p = (PRO_UINT32*)CacheAllocate_i(size, poolIndex);
+        if (p != NULL)
+        {
+            *p = (PRO_UINT32)size;
+            StatAllocate_i(p, poolIndex, CALLER_ADDRESS());
+
+            return (p + 2);
+        }
+    }
+#endif
+
     if (size <= SMALL_OBJ_SIZE)
     {
         switch (poolIndex)
@@ -948,6 +1885,7 @@ ProAllocateSgiPoolBuffer(size_t        size,
     }
 
     *p = (PRO_UINT32)size;
+    StatAllocate_i(p, poolIndex, CALLER_ADDRESS());
 
     return (p + 2);
 }
@@ -1142,10 +2080,16 @@ ProReallocateSgiPoolBuffer(void*         buf,
 
     if (q == NULL)
     {
-        return (NULL);
+        return (NULL); /* the old buffer is still counted */
     }
 
+    /*
+     * the header has been copied, so "q" still has the old size and stat
+     */
+    StatDeallocate_i(q, poolIndex);
+
     *q = (PRO_UINT32)newSize;
+    StatAllocate_i(q, poolIndex, CALLER_ADDRESS());
 
     return (q + 2);
 }
@@ -1168,6 +2112,15 @@ ProDeallocateSgiPoolBuffer(void*         buf,
         return;
     }
 
+    StatDeallocate_i(p, poolIndex);
+
+#if defined(PRO_HAS_SGI_POOL_CACHE)
+    if (*p <= (PRO_UINT32)std::_MAX_BYTES && CacheDeallocate_i(p, *p, poolIndex))
+    {
+        return;
+    }
+#endif
+
     if (*p <= SMALL_OBJ_SIZE)
     {
         switch (poolIndex)
@@ -1322,6 +2275,133 @@ ProDeallocateSgiPoolBuffer(void*         buf,
     }
 }
 
+PRO_SHARED_API
+size_t
+PRO_CALLTYPE
+ProTrimSgiPool(unsigned long poolIndex) /* 0 ~ 9 */
+{
+    assert(poolIndex <= 9);
+    if (poolIndex > 9)
+    {
+        return (0);
+    }
+
+#if defined(PRO_HAS_SGI_POOL_CACHE)
+    if (g_s_cacheKeyFlag)
+    {
+        g_s_cacheLock.Lock();
+        ++g_s_cacheTrimGen[poolIndex]; /* the other threads flush on their next call */
+        g_s_cacheLock.Unlock();
+
+        PRO_SGI_CACHE* const cache =
+            (PRO_SGI_CACHE*)pthread_getspecific(g_s_cacheKey);
+        if (cache != NULL)
+        {
+            cache->trimGen[poolIndex] = g_s_cacheTrimGen[poolIndex];
+            FlushCachePool_i(cache, poolIndex);
+        }
+    }
+#endif
+
+    size_t released = 0;
+
+    switch (poolIndex)
+    {
+    case 0:
+        {
+            g_s_lock0.Lock();
+            released += g_s_allocator0a.trim();
+            released += g_s_allocator0b.trim();
+            g_s_lock0.Unlock();
+            break;
+        }
+    case 1:
+        {
+            g_s_lock1.Lock();
+            released += g_s_allocator1a.trim();
+            released += g_s_allocator1b.trim();
+            g_s_lock1.Unlock();
+            break;
+        }
+    case 2:
+        {
+            g_s_lock2.Lock();
+            released += g_s_allocator2a.trim();
+            released += g_s_allocator2b.trim();
+            g_s_lock2.Unlock();
+            break;
+        }
+    case 3:
+        {
+            g_s_lock3.Lock();
+            released += g_s_allocator3a.trim();
+            released += g_s_allocator3b.trim();
+            g_s_lock3.Unlock();
+            break;
+        }
+    case 4:
+        {
+            g_s_lock4.Lock();
+            released += g_s_allocator4a.trim();
+            released += g_s_allocator4b.trim();
+            g_s_lock4.Unlock();
+            break;
+        }
+    case 5:
+        {
+            g_s_lock5.Lock();
+            released += g_s_allocator5a.trim();
+            released += g_s_allocator5b.trim();
+            g_s_lock5.Unlock();
+            break;
+        }
+    case 6:
+        {
+            g_s_lock6.Lock();
+            released += g_s_allocator6a.trim();
+            released += g_s_allocator6b.trim();
+            g_s_lock6.Unlock();
+            break;
+        }
+    case 7:
+        {
+            g_s_lock7.Lock();
+            released += g_s_allocator7a.trim();
+            released += g_s_allocator7b.trim();
+            g_s_lock7.Unlock();
+            break;
+        }
+    case 8:
+        {
+            g_s_lock8.Lock();
+            released += g_s_allocator8a.trim();
+            released += g_s_allocator8b.trim();
+            g_s_lock8.Unlock();
+            break;
+        }
+    case 9:
+        {
+            g_s_lock9.Lock();
+            released += g_s_allocator9a.trim();
+            released += g_s_allocator9b.trim();
+            g_s_lock9.Unlock();
+            break;
+        }
+    } /* end of switch (...) */
+
+    return (released);
+}
+
+PRO_SHARED_API
+void
+PRO_CALLTYPE
+ProEnableSgiPoolCache(bool enable)
+{
+#if defined(PRO_HAS_SGI_POOL_CACHE)
+    g_s_cacheEnabled = enable;
+#endif
+}
+
 PRO_SHARED_API
 void
 PRO_CALLTYPE
@@ -1514,6 +2594,173 @@ ProGetSgiBigPoolInfo(void*         freeList[60],
     }
 }
 
+PRO_SHARED_API
+void
+PRO_CALLTYPE
+ProGetSgiPoolCacheInfo(size_t        cacheObjs[60], /* = NULL */
+                       PRO_UINT64*   cacheHits,     /* = NULL */
+                       PRO_UINT64*   cacheMisses,   /* = NULL */
+                       unsigned long poolIndex)     /* 0 ~ 9 */
+{
+    assert(poolIndex <= 9);
+    if (poolIndex > 9)
+    {
+        return;
+    }
+
+    if (cacheObjs != NULL)
+    {
+        memset(cacheObjs, 0, sizeof(size_t) * 60);
+    }
+
+    PRO_UINT64 hits   = 0;
+    PRO_UINT64 misses = 0;
+
+    g_s_cacheLock.Lock();
+
+    hits   = g_s_cacheHits[poolIndex][0]   + g_s_cacheHits[poolIndex][1];
+    misses = g_s_cacheMisses[poolIndex][0] + g_s_cacheMisses[poolIndex][1];
+
+    for (PRO_SGI_CACHE* cache = g_s_cacheList; cache != NULL; cache = cache->next)
+    {
+        hits   += cache->hits[poolIndex][0]   + cache->hits[poolIndex][1];
+        misses += cache->misses[poolIndex][0] + cache->misses[poolIndex][1];
+
+        if (cacheObjs == NULL)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < 60; ++i)
+        {
+            cacheObjs[i] += cache->magazines[poolIndex][i].count;
+        }
+    }
+
+    g_s_cacheLock.Unlock();
+
+    if (cacheHits != NULL)
+    {
+        *cacheHits = hits;
+    }
+    if (cacheMisses != NULL)
+    {
+        *cacheMisses = misses;
+    }
+}
+
+PRO_SHARED_API
+void
+PRO_CALLTYPE
+ProEnableSgiPoolStat(bool          enable,
+                     unsigned long sampleRate) /* = 0 */
+{
+    g_s_statSampleRate = sampleRate;
+    g_s_statEnabled    = enable;
+}
+
+PRO_SHARED_API
+bool
+PRO_CALLTYPE
+ProGetSgiPoolStat(PRO_SGI_CLASS_STAT stat[60],
+                  unsigned long      poolIndex) /* 0 ~ 9 */
+{
+    assert(stat != NULL);
+    assert(poolIndex <= 9);
+    if (stat == NULL || poolIndex > 9)
+    {
+        return (false);
+    }
+
+    for (int i = 0; i < 60; ++i)
+    {
+        const PRO_SGI_STAT_I& item = g_s_stats[poolIndex][i];
+
+        stat[i].objSize     = g_s_allocator0a.obj_size(i);
+        stat[i].allocs      = item.allocs;
+        stat[i].frees       = item.frees;
+        stat[i].liveObjs    = item.liveObjs;
+        stat[i].maxLiveObjs = item.maxLiveObjs;
+        stat[i].liveBytes   = item.liveBytes;
+    }
+
+    return (g_s_statEnabled);
+}
+
+PRO_SHARED_API
+unsigned long
+PRO_CALLTYPE
+ProGetSgiPoolCallerStat(PRO_SGI_CALLER_STAT* stat,
+                        unsigned long        count)
+{
+    assert(stat != NULL);
+    assert(count > 0);
+    if (stat == NULL || count == 0)
+    {
+        return (0);
+    }
+
+    unsigned long ret = 0;
+
+    g_s_statLock.Lock();
+
+    for (unsigned long i = 0; i < g_s_sampleNext; ++i)
+    {
+        const PRO_SGI_SAMPLE_I& sample = g_s_samples[i];
+        if (sample.caller == NULL)
+        {
+            continue;
+        }
+
+        unsigned long j = 0;
+        for (; j < ret; ++j)
+        {
+            if (stat[j].caller == sample.caller &&
+                stat[j].poolIndex == sample.poolIndex)
+            {
+                break;
+            }
+        }
+
+        if (j == ret)
+        {
+            if (ret == count)
+            {
+                continue;
+            }
+
+            stat[j].caller    = sample.caller;
+            stat[j].poolIndex = sample.poolIndex;
+            stat[j].liveObjs  = 0;
+            stat[j].liveBytes = 0;
+            ++ret;
+        }
+
+        ++stat[j].liveObjs;
+        stat[j].liveBytes += sample.size;
+    }
+
+    g_s_statLock.Unlock();
+
+    /*
+     * sort by liveBytes, descending
+     */
+    for (unsigned long k = 1; k < ret; ++k)
+    {
+        const PRO_SGI_CALLER_STAT item = stat[k];
+
+        unsigned long l = k;
+        for (; l > 0 && stat[l - 1].liveBytes < item.liveBytes; --l)
+        {
+            stat[l] = stat[l - 1];
+        }
+
+        stat[l] = item;
+    }
+
+    return (ret);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
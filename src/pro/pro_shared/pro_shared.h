@@ -150,6 +150,33 @@ extern "C" {
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+/*
+ * SGIڴĳߴ缶ͳϢ
+ */
+struct PRO_SGI_CLASS_STAT
+{
+    size_t        objSize;     /* üĶߴ. 128KĶһ */
+    unsigned long allocs;      /* ۼƷ */
+    unsigned long frees;       /* ۼͷŴ */
+    unsigned long liveObjs;    /* ǰĶ */
+    unsigned long maxLiveObjs; /* ķֵ */
+    size_t        liveBytes;   /* ǰֽ(8ֽͷ) */
+};
+
+/*
+ * SGIڴĳõĳͳϢ
+ */
+struct PRO_SGI_CALLER_STAT
+{
+    const void*   caller;      /* õ(亯ķصַ) */
+    unsigned long poolIndex;   /* ڴ */
+    unsigned long liveObjs;    /* Ĵ */
+    size_t        liveBytes;   /* Ĵֽ(8ֽͷ) */
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
 /*
  * : ȡÿİ汾
  *
@@ -267,6 +294,10 @@ ProMakeMmTimerId();
  * ֵ: ڴַNULL
  *
  * ˵: ÿڴһһСӳع,ÿӳԼķ
+ *
+ *       Windowsƽ̨,ÿ߳ӳǰһ鰴ߴּ̻߳,
+ *       ķ/ͷŲ̻߳,Ҫ.̻߳˻
+ *       ʱ,Żӳس.μProEnableSgiPoolCache(...)
  */
 PRO_SHARED_API
 void*
@@ -310,6 +341,48 @@ PRO_CALLTYPE
 ProDeallocateSgiPoolBuffer(void*         buf,
                            unsigned long poolIndex); /* 0 ~ 9 */
 
+/*
+ * : SGIڴȫеĿ黹ϵͳ
+ *
+ * :
+ * poolIndex : ڴ. [0 ~ 9],һ10ڴ
+ *
+ * ֵ: 黹ֽ
+ *
+ * ˵: ڴ2MΪλϵͳڴ.Եķ,Ե
+ *       ú,жͷŵĿ黹ϵͳ,Խͽ̵RSS
+ *
+ *       úȰѵ̵̻߳߳黹ӳ.̵ֻ̻߳߳
+ *       Ե̲߳,һη/ͷŸڴʱ(߳˳ʱ)
+ *       Ż黹ӳ,ڴ֮ǰ,еĶʹڵĿ޷黹.,
+ *       ̱߳Եķ,ӦõЩ߳ٴʹڴ֮(
+ *       ˳֮)ٵһθú
+ *
+ *       úҪӳص,Ƶ
+ */
+PRO_SHARED_API
+size_t
+PRO_CALLTYPE
+ProTrimSgiPool(unsigned long poolIndex); /* 0 ~ 9 */
+
+/*
+ * : 򿪻رSGIڴص̻߳
+ *
+ * :
+ * enable : Ƿ
+ *
+ * ֵ: 
+ *
+ * ˵: ȱʡǴ򿪵. رպ,̻߳Ķڸ߳һͷڴʱ
+ *       黹ӳ,߳˳ʱҲ黹
+ *
+ *       Windowsƽ̨PRO_LACKS_SGI_POOL_CACHEʱ,̻߳治
+ */
+PRO_SHARED_API
+void
+PRO_CALLTYPE
+ProEnableSgiPoolCache(bool enable);
+
 /*
  * : ȡС(sizeof(obj)<=4096)SGIӳϢ
  *
@@ -352,6 +425,84 @@ ProGetSgiBigPoolInfo(void*         freeList[60],
                      size_t*       heapSize,     /* = NULL */
                      unsigned long poolIndex);   /* 0 ~ 9 */
 
+/*
+ * : ȡSGIڴص̻߳Ϣ
+ *
+ * :
+ * cacheObjs   : ڽϢ. ߴ缶̻ͣ߳Ķ
+ * cacheHits   : ڽϢ. ֱ̻߳ķ
+ * cacheMisses : ڽϢ. ̻߳Ĵ
+ * poolIndex   : ڴ. [0 ~ 9],һ10ڴ
+ *
+ * ֵ: 
+ *
+ * ˵: úڵԻ״̬. cacheObjsĳߴ缶ProGetSgiPoolStat(...)
+ *       ͬ,Сʹ
+ */
+PRO_SHARED_API
+void
+PRO_CALLTYPE
+ProGetSgiPoolCacheInfo(size_t        cacheObjs[60], /* = NULL */
+                       PRO_UINT64*   cacheHits,     /* = NULL */
+                       PRO_UINT64*   cacheMisses,   /* = NULL */
+                       unsigned long poolIndex);    /* 0 ~ 9 */
+
+/*
+ * : 򿪻رSGIڴصͳƹ
+ *
+ * :
+ * enable     : Ƿ
+ * sampleRate : õĳ. 0ʾ, NʾÿNη1
+ *
+ * ֵ: 
+ *
+ * ˵: ȱʡǹرյ. 򿪺,ÿη/ͷŻӼԭӲĿ
+ *
+ *       ͳƿʼ֮ǰĶ󲻼ͳ;ͳƹر֮,ѼͳƵĶ
+ *       ͷʱԻᱻ۳,Ա֤׼ȷ
+ *
+ *       ¼ౣ4096,ڶλڴĳ
+ */
+PRO_SHARED_API
+void
+PRO_CALLTYPE
+ProEnableSgiPoolStat(bool          enable,
+                     unsigned long sampleRate); /* = 0 */
+
+/*
+ * : ȡSGIڴظߴ缶ͳϢ
+ *
+ * :
+ * stat      : ڽϢ
+ * poolIndex : ڴ. [0 ~ 9],һ10ڴ
+ *
+ * ֵ: ͳƹǷ
+ *
+ * ˵: ú,С,ȡһƵĿ
+ */
+PRO_SHARED_API
+bool
+PRO_CALLTYPE
+ProGetSgiPoolStat(PRO_SGI_CLASS_STAT stat[60],
+                  unsigned long      poolIndex); /* 0 ~ 9 */
+
+/*
+ * : ȡSGIڴسĵõͳϢ
+ *
+ * :
+ * stat  : ڽϢ
+ * count : statԪظ
+ *
+ * ֵ: ʵдԪظ
+ *
+ * ˵: liveBytesӴС. ԳΪֵ
+ */
+PRO_SHARED_API
+unsigned long
+PRO_CALLTYPE
+ProGetSgiPoolCallerStat(PRO_SGI_CALLER_STAT* stat,
+                        unsigned long        count);
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
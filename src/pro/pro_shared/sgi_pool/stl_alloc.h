@@ -25,6 +25,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if !defined(WIN32) && !defined(_WIN32_WCE)
+#include <sys/mman.h>
+#endif
+
 #if !defined(____STD____)
 #define ____STD____
 #define ____STD_BEGIN namespace std {
@@ -66,6 +70,39 @@ union _Obj
     char        _M_client_data[1];
 };
 
+struct _Chunk
+{
+    char*  _M_start;
+    size_t _M_size;
+    size_t _M_free_bytes; /* for trimming */
+};
+
+/* Chunks are obtained from the OS directly, so that they can be returned. */
+inline char* _S_os_alloc(size_t __bytes)
+{
+#if !defined(WIN32) && !defined(_WIN32_WCE)
+    void* __p = mmap(0, __bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (__p == MAP_FAILED)
+    {
+        __p = 0;
+    }
+
+    return ((char*)__p);
+#else
+    return ((char*)malloc(__bytes));
+#endif
+}
+
+inline void _S_os_free(char* __p, size_t __bytes)
+{
+#if !defined(WIN32) && !defined(_WIN32_WCE)
+    munmap(__p, __bytes);
+#else
+    (void)__bytes;
+    free(__p);
+#endif
+}
+
 template<int inst>
 class __default_alloc_template
 {
@@ -131,6 +168,73 @@ private:
     static char*  _S_end_free;
     static size_t _S_heap_size;
 
+    // Chunk bookkeeping, sorted by address.
+    static _Chunk* _S_chunks;
+    static size_t  _S_chunk_count;
+    static size_t  _S_chunk_capacity;
+
+    static bool _S_add_chunk(char* __start, size_t __size)
+    {
+        if (_S_chunk_count == _S_chunk_capacity)
+        {
+            size_t  __capacity = _S_chunk_capacity == 0 ? 64 : _S_chunk_capacity * 2;
+            _Chunk* __chunks   = (_Chunk*)realloc(_S_chunks, sizeof(_Chunk) * __capacity);
+            if (__chunks == 0)
+            {
+                return (false);
+            }
+
+            _S_chunks         = __chunks;
+            _S_chunk_capacity = __capacity;
+        }
+
+        size_t __i = _S_chunk_count;
+        for (; __i > 0 && _S_chunks[__i - 1]._M_start > __start; --__i)
+        {
+            _S_chunks[__i] = _S_chunks[__i - 1];
+        }
+
+        _S_chunks[__i]._M_start      = __start;
+        _S_chunks[__i]._M_size       = __size;
+        _S_chunks[__i]._M_free_bytes = 0;
+        ++_S_chunk_count;
+
+        return (true);
+    }
+
+    static _Chunk* _S_find_chunk(const char* __p)
+    {
+        size_t __l = 0, __r = _S_chunk_count;
+
+        while (__l < __r)
+        {
+            size_t  __m     = (__l + __r) / 2;
+            _Chunk& __chunk = _S_chunks[__m];
+
+            if (__p < __chunk._M_start)
+            {
+                __r = __m;
+            }
+            else if (__p >= __chunk._M_start + __chunk._M_size)
+            {
+                __l = __m + 1;
+            }
+            else
+            {
+                return (&__chunk);
+            }
+        }
+
+        return (0);
+    }
+
+    static bool _S_is_free_chunk(const char* __p)
+    {
+        _Chunk* __chunk = _S_find_chunk(__p);
+
+        return (__chunk != 0 && __chunk->_M_free_bytes == __chunk->_M_size);
+    }
+
 public:
 
     /* __n must be > 0      */
@@ -223,6 +327,171 @@ public:
         return (__result);
     }
 
+    static int freelist_index(size_t __bytes)
+    {
+        return (_S_freelist_index(__bytes));
+    }
+
+    static size_t obj_size(int __index)
+    {
+        return (_S_obj_size[__index]);
+    }
+
+    /* __n must be <= _MAX_BYTES. the objects are linked by _M_free_list_link */
+    static int allocate_batch(size_t __n, int __count, _Obj*& __head)
+    {
+        __head = 0;
+
+        if (__n == 0 || __n > (size_t)_MAX_BYTES || __count <= 0)
+        {
+            return (0);
+        }
+
+        const size_t    __size         = _S_round_up(__n);
+        _Obj* volatile* __my_free_list = _S_free_list + _S_freelist_index(__n);
+        int             __got          = 0;
+
+        while (__got < __count)
+        {
+            _Obj* __result = *__my_free_list;
+
+            if (__result == 0)
+            {
+                __result = (_Obj*)_S_refill(__size);
+                if (__result == 0)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                *__my_free_list = __result->_M_free_list_link;
+            }
+
+            __result->_M_free_list_link = __head;
+            __head = __result;
+            ++__got;
+        }
+
+        return (__got);
+    }
+
+    /* __n must be <= _MAX_BYTES. the objects are linked by _M_free_list_link */
+    static void deallocate_batch(_Obj* __head, _Obj* __tail, size_t __n)
+    {
+        if (__head == 0 || __tail == 0 || __n == 0 || __n > (size_t)_MAX_BYTES)
+        {
+            return;
+        }
+
+        _Obj* volatile* __my_free_list = _S_free_list + _S_freelist_index(__n);
+
+        __tail->_M_free_list_link = *__my_free_list;
+        *__my_free_list = __head;
+    }
+
+    // Returns the chunks that have no objects in use to the OS.
+    // Returns the number of bytes released.
+    static size_t trim()
+    {
+        if (_S_chunk_count == 0)
+        {
+            return (0);
+        }
+
+        size_t __i = 0;
+
+        for (__i = 0; __i < _S_chunk_count; ++__i)
+        {
+            _S_chunks[__i]._M_free_bytes = 0;
+        }
+
+        if (_S_end_free > _S_start_free)
+        {
+            _Chunk* __chunk = _S_find_chunk(_S_start_free);
+            if (__chunk != 0)
+            {
+                __chunk->_M_free_bytes += _S_end_free - _S_start_free;
+            }
+        }
+
+        for (int __j = 0; __j < _NFREELISTS; ++__j)
+        {
+            for (_Obj* __p = _S_free_list[__j]; __p != 0; __p = __p->_M_free_list_link)
+            {
+                _Chunk* __chunk = _S_find_chunk((char*)__p);
+                if (__chunk != 0)
+                {
+                    __chunk->_M_free_bytes += _S_obj_size[__j];
+                }
+            }
+        }
+
+        bool __found = false;
+
+        for (__i = 0; __i < _S_chunk_count; ++__i)
+        {
+            if (_S_chunks[__i]._M_free_bytes == _S_chunks[__i]._M_size)
+            {
+                __found = true;
+                break;
+            }
+        }
+
+        if (!__found)
+        {
+            return (0);
+        }
+
+        /* Unlink the objects of the free chunks. */
+        for (int __k = 0; __k < _NFREELISTS; ++__k)
+        {
+            _Obj* volatile* __link = _S_free_list + __k;
+
+            while (*__link != 0)
+            {
+                if (_S_is_free_chunk((char*)*__link))
+                {
+                    *__link = (*__link)->_M_free_list_link;
+                }
+                else
+                {
+                    __link = &(*__link)->_M_free_list_link;
+                }
+            }
+        }
+
+        if (_S_end_free > _S_start_free && _S_is_free_chunk(_S_start_free))
+        {
+            _S_start_free = 0;
+            _S_end_free   = 0;
+        }
+
+        size_t __released = 0;
+        size_t __count    = 0;
+
+        for (__i = 0; __i < _S_chunk_count; ++__i)
+        {
+            _Chunk& __chunk = _S_chunks[__i];
+
+            if (__chunk._M_free_bytes == __chunk._M_size)
+            {
+                _S_os_free(__chunk._M_start, __chunk._M_size);
+                __released += __chunk._M_size;
+            }
+            else
+            {
+                _S_chunks[__count] = __chunk;
+                ++__count;
+            }
+        }
+
+        _S_chunk_count =  __count;
+        _S_heap_size   -= __released;
+
+        return (__released);
+    }
+
     static void get_info(
         void*   __free_list[_NFREELISTS],
         size_t  __obj_size[_NFREELISTS],
@@ -343,12 +612,18 @@ __default_alloc_template<__inst>::_S_chunk_alloc(size_t __size,
 
         size_t __bytes_to_get = _CHUNK_SIZE;
 
-        _S_start_free = (char*)malloc(__bytes_to_get);
+        _S_start_free = _S_os_alloc(__bytes_to_get);
         _S_end_free   = 0;
         if (_S_start_free == 0)
         {
             __bytes_to_get = _CHUNK_SIZE / 2;
-            _S_start_free  = (char*)malloc(__bytes_to_get); /* retry */
+            _S_start_free  = _S_os_alloc(__bytes_to_get); /* retry */
+        }
+
+        if (_S_start_free != 0 && !_S_add_chunk(_S_start_free, __bytes_to_get))
+        {
+            _S_os_free(_S_start_free, __bytes_to_get);
+            _S_start_free = 0;
         }
 
         if (_S_start_free != 0)
@@ -390,6 +665,15 @@ char* __default_alloc_template<__inst>::_S_end_free   = 0;
 template<int __inst>
 size_t __default_alloc_template<__inst>::_S_heap_size = 0;
 
+template<int __inst>
+_Chunk* __default_alloc_template<__inst>::_S_chunks = 0;
+
+template<int __inst>
+size_t __default_alloc_template<__inst>::_S_chunk_count = 0;
+
+template<int __inst>
+size_t __default_alloc_template<__inst>::_S_chunk_capacity = 0;
+
 template<int __inst>
 _Obj* volatile
 __default_alloc_template<__inst>::_S_free_list[_NFREELISTS] =
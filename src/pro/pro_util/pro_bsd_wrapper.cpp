@@ -856,7 +856,8 @@ PRO_CALLTYPE
 pbsd_accept(PRO_INT64         fd,
             pbsd_sockaddr_in* addr)
 {
-    PRO_INT64 newfd = -1;
+    PRO_INT64 newfd    = -1;
+    bool      flagsSet = false; /* O_NONBLOCK and FD_CLOEXEC */
 
 #if defined(WIN32) || defined(_WIN32_WCE)
 
@@ -878,23 +879,29 @@ pbsd_accept(PRO_INT64         fd,
 
 #else  /* WIN32, _WIN32_WCE */
 
-#if defined(PRO_HAS_ACCEPT4) && defined(SOCK_CLOEXEC)
+    int errorcode = 0;
+
+#if defined(PRO_HAS_ACCEPT4) && defined(SOCK_CLOEXEC) && defined(SOCK_NONBLOCK)
     static bool s_hasclose = true;
-    int         errorcode  = 0;
     if (s_hasclose)
     {
         do
         {
             socklen_t addrlen = sizeof(pbsd_sockaddr_in);
-            newfd     = (PRO_INT32)accept4(
-                (int)fd, (struct sockaddr*)addr, addr != NULL ? &addrlen : NULL, SOCK_CLOEXEC);
+            newfd     = (PRO_INT32)accept4((int)fd, (struct sockaddr*)addr,
+                addr != NULL ? &addrlen : NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
             errorcode = pbsd_errno((void*)&pbsd_accept);
         }
         while (newfd < 0 && errorcode == PBSD_EINTR);
+
+        flagsSet = newfd >= 0;
     }
 #endif
 
-    if (newfd < 0)
+    /*
+     * EAGAIN ends every accept batch. don't retry it with accept()
+     */
+    if (newfd < 0 && errorcode != PBSD_EWOULDBLOCK)
     {
         do
         {
@@ -904,7 +911,7 @@ pbsd_accept(PRO_INT64         fd,
         }
         while (newfd < 0 && pbsd_errno((void*)&pbsd_accept) == PBSD_EINTR);
 
-#if defined(PRO_HAS_ACCEPT4) && defined(SOCK_CLOEXEC)
+#if defined(PRO_HAS_ACCEPT4) && defined(SOCK_CLOEXEC) && defined(SOCK_NONBLOCK)
         if (newfd >= 0 && errorcode == PBSD_EINVAL)
         {
             s_hasclose = false;
@@ -916,8 +923,11 @@ pbsd_accept(PRO_INT64         fd,
 
     if (newfd >= 0)
     {
-        pbsd_ioctl_nonblock(newfd);
-        pbsd_ioctl_closexec(newfd);
+        if (!flagsSet)
+        {
+            pbsd_ioctl_nonblock(newfd);
+            pbsd_ioctl_closexec(newfd);
+        }
     }
     else
     {
@@ -932,27 +942,34 @@ PRO_CALLTYPE
 pbsd_accept_un(PRO_INT64         fd,
                pbsd_sockaddr_un* addr)
 {
-    PRO_INT64 newfd = -1;
+    PRO_INT64 newfd    = -1;
+    bool      flagsSet = false; /* O_NONBLOCK and FD_CLOEXEC */
 
 #if !defined(WIN32) && !defined(_WIN32_WCE)
 
-#if defined(PRO_HAS_ACCEPT4) && defined(SOCK_CLOEXEC)
+    int errorcode = 0;
+
+#if defined(PRO_HAS_ACCEPT4) && defined(SOCK_CLOEXEC) && defined(SOCK_NONBLOCK)
     static bool s_hasclose = true;
-    int         errorcode  = 0;
     if (s_hasclose)
     {
         do
         {
             socklen_t addrlen = sizeof(pbsd_sockaddr_un);
-            newfd     = (PRO_INT32)accept4(
-                (int)fd, (struct sockaddr*)addr, addr != NULL ? &addrlen : NULL, SOCK_CLOEXEC);
+            newfd     = (PRO_INT32)accept4((int)fd, (struct sockaddr*)addr,
+                addr != NULL ? &addrlen : NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
             errorcode = pbsd_errno((void*)&pbsd_accept_un);
         }
         while (newfd < 0 && errorcode == PBSD_EINTR);
+
+        flagsSet = newfd >= 0;
     }
 #endif
 
-    if (newfd < 0)
+    /*
+     * EAGAIN ends every accept batch. don't retry it with accept()
+     */
+    if (newfd < 0 && errorcode != PBSD_EWOULDBLOCK)
     {
         do
         {
@@ -962,7 +979,7 @@ pbsd_accept_un(PRO_INT64         fd,
         }
         while (newfd < 0 && pbsd_errno((void*)&pbsd_accept_un) == PBSD_EINTR);
 
-#if defined(PRO_HAS_ACCEPT4) && defined(SOCK_CLOEXEC)
+#if defined(PRO_HAS_ACCEPT4) && defined(SOCK_CLOEXEC) && defined(SOCK_NONBLOCK)
         if (newfd >= 0 && errorcode == PBSD_EINVAL)
         {
             s_hasclose = false;
@@ -972,8 +989,11 @@ pbsd_accept_un(PRO_INT64         fd,
 
     if (newfd >= 0)
     {
-        pbsd_ioctl_nonblock(newfd);
-        pbsd_ioctl_closexec(newfd);
+        if (!flagsSet)
+        {
+            pbsd_ioctl_nonblock(newfd);
+            pbsd_ioctl_closexec(newfd);
+        }
     }
     else
     {
@@ -1104,6 +1124,42 @@ pbsd_sendmsg(PRO_INT64          fd,
     return (retc);
 }
 
+int
+PRO_CALLTYPE
+pbsd_sendv(PRO_INT64         fd,
+           const pbsd_iovec* iov,
+           int               iovcnt,
+           int               flags)
+{
+    int retc = -1;
+
+#if defined(WIN32) || defined(_WIN32_WCE)
+    do
+    {
+        DWORD sentBytes = 0;
+        if (::WSASend((SOCKET)fd, (LPWSABUF)iov, (DWORD)iovcnt,
+            &sentBytes, (DWORD)flags, NULL, NULL) == 0)
+        {
+            retc = (int)sentBytes;
+        }
+    }
+    while (0);
+#else
+    pbsd_msghdr msg;
+    memset(&msg, 0, sizeof(pbsd_msghdr));
+    msg.msg_iov    = (struct iovec*)iov;
+    msg.msg_iovlen = iovcnt;
+
+    do
+    {
+        retc = sendmsg((int)fd, &msg, flags);
+    }
+    while (retc < 0 && pbsd_errno((void*)&pbsd_sendv) == PBSD_EINTR);
+#endif
+
+    return (retc);
+}
+
 int
 PRO_CALLTYPE
 pbsd_recv(PRO_INT64 fd,
@@ -1130,6 +1186,43 @@ pbsd_recv(PRO_INT64 fd,
     return (retc);
 }
 
+int
+PRO_CALLTYPE
+pbsd_recvv(PRO_INT64         fd,
+           const pbsd_iovec* iov,
+           int               iovcnt,
+           int               flags)
+{
+    int retc = -1;
+
+#if defined(WIN32) || defined(_WIN32_WCE)
+    do
+    {
+        DWORD recvBytes = 0;
+        DWORD recvFlags = (DWORD)flags;
+        if (::WSARecv((SOCKET)fd, (LPWSABUF)iov, (DWORD)iovcnt,
+            &recvBytes, &recvFlags, NULL, NULL) == 0)
+        {
+            retc = (int)recvBytes;
+        }
+    }
+    while (0);
+#else
+    pbsd_msghdr msg;
+    memset(&msg, 0, sizeof(pbsd_msghdr));
+    msg.msg_iov    = (struct iovec*)iov;
+    msg.msg_iovlen = iovcnt;
+
+    do
+    {
+        retc = recvmsg((int)fd, &msg, flags);
+    }
+    while (retc < 0 && pbsd_errno((void*)&pbsd_recvv) == PBSD_EINTR);
+#endif
+
+    return (retc);
+}
+
 int
 PRO_CALLTYPE
 pbsd_recvfrom(PRO_INT64         fd,
@@ -1206,6 +1299,46 @@ pbsd_recvmsg(PRO_INT64    fd,
     return (retc);
 }
 
+#if defined(PRO_HAS_MMSG)
+
+int
+PRO_CALLTYPE
+pbsd_sendmmsg(PRO_INT64     fd,
+              pbsd_mmsghdr* msgvec,
+              unsigned int  vlen,
+              int           flags)
+{
+    int retc = -1;
+
+    do
+    {
+        retc = sendmmsg((int)fd, msgvec, vlen, flags);
+    }
+    while (retc < 0 && pbsd_errno((void*)&pbsd_sendmmsg) == PBSD_EINTR);
+
+    return (retc);
+}
+
+int
+PRO_CALLTYPE
+pbsd_recvmmsg(PRO_INT64     fd,
+              pbsd_mmsghdr* msgvec,
+              unsigned int  vlen,
+              int           flags)
+{
+    int retc = -1;
+
+    do
+    {
+        retc = recvmmsg((int)fd, msgvec, vlen, flags, NULL);
+    }
+    while (retc < 0 && pbsd_errno((void*)&pbsd_recvmmsg) == PBSD_EINTR);
+
+    return (retc);
+}
+
+#endif /* PRO_HAS_MMSG */
+
 int
 PRO_CALLTYPE
 pbsd_select(PRO_INT64       nfds,
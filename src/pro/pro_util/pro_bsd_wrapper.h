@@ -58,6 +58,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 
 #if defined(PRO_FD_SETSIZE)
@@ -99,11 +100,14 @@ extern "C" {
 #define SIO_UDP_CONNRESET      _WSAIOW(IOC_VENDOR, 12)
 #endif
 
+#define PBSD_EIO               EIO            /*     5 */
 #define PBSD_EBADF             WSAEBADF       /* 10009 */
+#define PBSD_EINVAL            WSAEINVAL      /* 10022 */
 #define PBSD_EWOULDBLOCK       WSAEWOULDBLOCK /* 10035 */
 #define PBSD_EINPROGRESS       WSAEINPROGRESS /* 10036 */
 #define PBSD_EMSGSIZE          WSAEMSGSIZE    /* 10040 */
 #define PBSD_ECONNRESET        WSAECONNRESET  /* 10054 */
+#define PBSD_ENOBUFS           WSAENOBUFS     /* 10055 */
 #define PBSD_ETIMEDOUT         WSAETIMEDOUT   /* 10060 */
 
 #define PBSD_FD_ZERO(set)      FD_ZERO(set)
@@ -113,11 +117,14 @@ extern "C" {
 
 #else  /* WIN32, _WIN32_WCE */
 
+#define PBSD_EIO               EIO            /*   5 */
 #define PBSD_EBADF             EBADF          /*   9 */
 #define PBSD_EWOULDBLOCK       EAGAIN         /*  11 */
+#define PBSD_EINVAL            EINVAL         /*  22 */
 #define PBSD_EINPROGRESS       EINPROGRESS    /* 115 */
 #define PBSD_EMSGSIZE          EMSGSIZE       /*  90 */
 #define PBSD_ECONNRESET        ECONNRESET     /* 104 */
+#define PBSD_ENOBUFS           ENOBUFS        /* 105 */
 #define PBSD_ETIMEDOUT         ETIMEDOUT      /* 110 */
 
 #define PBSD_FD_ZERO(set)      FD_ZERO(set)
@@ -149,6 +156,14 @@ struct pbsd_msghdr      /* a dummy on Windows */
     DECLARE_SGI_POOL(0);
 };
 
+struct pbsd_iovec       /* the layout of WSABUF */
+{
+    unsigned long iov_len;
+    void*         iov_base;
+};
+
+#define PBSD_IOV_MAX 64
+
 #else  /* WIN32, _WIN32_WCE */
 
 struct pbsd_sockaddr_un : public sockaddr_un
@@ -161,6 +176,24 @@ struct pbsd_msghdr : public msghdr
     DECLARE_SGI_POOL(0);
 };
 
+struct pbsd_iovec : public iovec
+{
+};
+
+#if defined(IOV_MAX)
+#define PBSD_IOV_MAX IOV_MAX
+#else
+#define PBSD_IOV_MAX 64
+#endif
+
+#if defined(PRO_HAS_MMSG)
+
+struct pbsd_mmsghdr : public mmsghdr
+{
+};
+
+#endif /* PRO_HAS_MMSG */
+
 #endif /* WIN32, _WIN32_WCE */
 
 #if defined(PRO_HAS_EPOLL)
@@ -337,6 +370,16 @@ pbsd_sendmsg(PRO_INT64          fd,
              const pbsd_msghdr* msg,
              int                flags);
 
+/*
+ * gathers iovcnt buffers into one send. iovcnt is no more than PBSD_IOV_MAX
+ */
+int
+PRO_CALLTYPE
+pbsd_sendv(PRO_INT64         fd,
+           const pbsd_iovec* iov,
+           int               iovcnt,
+           int               flags);
+
 int
 PRO_CALLTYPE
 pbsd_recv(PRO_INT64 fd,
@@ -344,6 +387,16 @@ pbsd_recv(PRO_INT64 fd,
           int       buflen,
           int       flags);
 
+/*
+ * scatters one receive into iovcnt buffers. iovcnt is no more than PBSD_IOV_MAX
+ */
+int
+PRO_CALLTYPE
+pbsd_recvv(PRO_INT64         fd,
+           const pbsd_iovec* iov,
+           int               iovcnt,
+           int               flags);
+
 int
 PRO_CALLTYPE
 pbsd_recvfrom(PRO_INT64         fd,
@@ -358,6 +411,28 @@ pbsd_recvmsg(PRO_INT64    fd,
              pbsd_msghdr* msg,
              int          flags);
 
+#if defined(PRO_HAS_MMSG)
+
+/*
+ * the batch versions of sendmsg() and recvmsg(). they return the number of
+ * the messages, and msg_len of each message is set
+ */
+int
+PRO_CALLTYPE
+pbsd_sendmmsg(PRO_INT64     fd,
+              pbsd_mmsghdr* msgvec,
+              unsigned int  vlen,
+              int           flags);
+
+int
+PRO_CALLTYPE
+pbsd_recvmmsg(PRO_INT64     fd,
+              pbsd_mmsghdr* msgvec,
+              unsigned int  vlen,
+              int           flags);
+
+#endif /* PRO_HAS_MMSG */
+
 int
 PRO_CALLTYPE
 pbsd_select(PRO_INT64       nfds,
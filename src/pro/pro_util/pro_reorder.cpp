@@ -36,6 +36,8 @@
 #define RTP_MM_TYPE unsigned char
 #endif
 
+class IProSendBuffer;
+
 /*
  * rtp packet
  *
@@ -96,6 +98,8 @@ public:
     virtual void PRO_CALLTYPE SetTick_i(PRO_INT64 tick) = 0;
 
     virtual PRO_INT64 PRO_CALLTYPE GetTick_i() const = 0;
+
+    virtual IProSendBuffer* PRO_CALLTYPE GetSendBuffer_i() = 0;
 };
 #endif /* ____IRtpPacket____ */
 
@@ -19,10 +19,12 @@
 #include "pro_a.h"
 #include "pro_thread.h"
 #include "pro_memory_pool.h"
+#include "pro_stl.h"
 #include "pro_thread_mutex.h"
 #include "pro_time_util.h"
 #include "pro_z.h"
 #include "../pro_shared/pro_shared.h"
+#include <cassert>
 
 #if defined(_WIN32_WCE)
 #include <windows.h>
@@ -30,7 +32,10 @@
 #include <windows.h>
 #include <process.h>
 #else
+#include <errno.h>
 #include <pthread.h>
+#include <sched.h>
+#include <time.h>
 #endif
 
 /////////////////////////////////////////////////////////////////////////////
@@ -44,6 +49,102 @@
 #define PRO_THREAD_STACK_SIZE             1040384 /* (1024 * 1024 - 8192) */
 #endif
 
+#define PRO_MIN_SET_CPUS                  1024
+#define PRO_MAX_SET_CPUS                  (1024 * 64)
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+#if defined(CPU_SET)
+
+struct PRO_CORE_CPU
+{
+    int           node;
+    int           package;
+    int           core;
+    unsigned long cpu;
+};
+
+static
+int
+ReadSysInt_i(const char* fileName)
+{
+    int value = -1;
+
+    FILE* const file = fopen(fileName, "r");
+    if (file != NULL)
+    {
+        if (fscanf(file, "%d", &value) != 1)
+        {
+            value = -1;
+        }
+
+        fclose(file);
+    }
+
+    return (value);
+}
+
+/*
+ * "0-3,8-11\n". returns false if the file can't be read
+ */
+static
+bool
+ReadSysCpuList_i(const char*                   fileName,
+                 CProStlVector<unsigned long>& cpus)
+{
+    cpus.clear();
+
+    FILE* const file = fopen(fileName, "r");
+    if (file == NULL)
+    {
+        return (false);
+    }
+
+    char buf[4096] = "";
+    if (fgets(buf, sizeof(buf), file) != NULL)
+    {
+        const char* p = buf;
+
+        while (*p >= '0' && *p <= '9')
+        {
+            char*               q     = NULL;
+            const unsigned long first = strtoul(p, &q, 10);
+            unsigned long       last  = first;
+            if (*q == '-')
+            {
+                last = strtoul(q + 1, &q, 10);
+            }
+
+            for (unsigned long i = first; i <= last && i < PRO_MAX_SET_CPUS; ++i)
+            {
+                cpus.push_back(i);
+            }
+
+            p = *q == ',' ? q + 1 : q;
+        }
+    }
+
+    fclose(file);
+
+    return (true);
+}
+
+/*
+ * the c libraries without the dynamic cpu sets have the fixed cpu_set_t
+ * of CPU_SETSIZE cpus only
+ */
+#if !defined(CPU_ALLOC)
+#define CPU_ALLOC_SIZE(count)       sizeof(cpu_set_t)
+#define CPU_ALLOC(count)            ((cpu_set_t*)malloc(sizeof(cpu_set_t)))
+#define CPU_FREE(set)               free(set)
+#define CPU_ZERO_S(size, set)       CPU_ZERO(set)
+#define CPU_SET_S(cpu, size, set)   CPU_SET(cpu, set)
+#define CPU_ISSET_S(cpu, size, set) CPU_ISSET(cpu, set)
+#endif
+
+#endif /* CPU_SET */
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
@@ -213,3 +314,384 @@ ProGetThreadId()
 
     return (threadId);
 }
+
+void
+PRO_CALLTYPE
+ProSetThreadName(const char* name)
+{
+    if (name == NULL || name[0] == '\0')
+    {
+        return;
+    }
+
+#if defined(CPU_SET)
+    char name2[16] = "";
+    strncpy_pro(name2, sizeof(name2), name);
+    pthread_setname_np(pthread_self(), name2);
+#endif
+}
+
+bool
+PRO_CALLTYPE
+ProSetThreadAffinity(const unsigned long* cpus,
+                     unsigned long        count)
+{
+    assert(cpus != NULL);
+    assert(count > 0);
+    if (cpus == NULL || count == 0)
+    {
+        return (false);
+    }
+
+#if defined(_WIN32_WCE)
+
+    return (false);
+
+#elif defined(WIN32)
+
+    /*
+     * a thread runs in one processor group, so only its cpus can be used
+     */
+    DWORD_PTR cpuMask = 0;
+
+    for (unsigned long i = 0; i < count; ++i)
+    {
+        if (cpus[i] < sizeof(DWORD_PTR) * 8)
+        {
+            cpuMask |= (DWORD_PTR)1 << cpus[i];
+        }
+    }
+
+    if (cpuMask == 0)
+    {
+        return (false);
+    }
+
+    return (::SetThreadAffinityMask(::GetCurrentThread(), cpuMask) != 0);
+
+#elif defined(CPU_SET)
+
+    unsigned long maxCpu = 0;
+
+    for (unsigned long i = 0; i < count; ++i)
+    {
+        if (cpus[i] < PRO_MAX_SET_CPUS && cpus[i] > maxCpu)
+        {
+            maxCpu = cpus[i];
+        }
+    }
+
+    cpu_set_t* const cpuSet = CPU_ALLOC(maxCpu + 1);
+    if (cpuSet == NULL)
+    {
+        return (false);
+    }
+
+    const size_t setSize = CPU_ALLOC_SIZE(maxCpu + 1);
+    CPU_ZERO_S(setSize, cpuSet);
+
+    for (unsigned long j = 0; j < count; ++j)
+    {
+        if (cpus[j] < setSize * 8)
+        {
+            CPU_SET_S(cpus[j], setSize, cpuSet);
+        }
+    }
+
+    const bool ret = pthread_setaffinity_np(pthread_self(), setSize, cpuSet) == 0;
+    CPU_FREE(cpuSet);
+
+    return (ret);
+
+#else
+
+    return (false);
+
+#endif
+}
+
+unsigned long
+PRO_CALLTYPE
+ProGetThreadAffinity(unsigned long* cpus,  /* = NULL */
+                     unsigned long  count) /* = 0 */
+{
+    if (cpus == NULL)
+    {
+        count = 0;
+    }
+
+    unsigned long ret = 0;
+
+#if defined(_WIN32_WCE)
+
+#elif defined(WIN32)
+
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask  = 0;
+    if (::GetProcessAffinityMask(::GetCurrentProcess(), &processMask, &systemMask))
+    {
+        /*
+         * there's no getter for a thread, so set and restore it
+         */
+        const DWORD_PTR threadMask =
+            ::SetThreadAffinityMask(::GetCurrentThread(), processMask);
+        if (threadMask != 0)
+        {
+            ::SetThreadAffinityMask(::GetCurrentThread(), threadMask);
+
+            for (unsigned long i = 0; i < sizeof(DWORD_PTR) * 8; ++i)
+            {
+                if ((threadMask >> i) & 1)
+                {
+                    if (ret < count)
+                    {
+                        cpus[ret] = i;
+                    }
+                    ++ret;
+                }
+            }
+        }
+    }
+
+#elif defined(CPU_SET)
+
+    /*
+     * the kernel may have more cpus than a cpu_set_t holds, so the set
+     * grows until it's large enough
+     */
+    for (unsigned long cpuCount = PRO_MIN_SET_CPUS; cpuCount <= PRO_MAX_SET_CPUS; cpuCount *= 2)
+    {
+        cpu_set_t* const cpuSet = CPU_ALLOC(cpuCount);
+        if (cpuSet == NULL)
+        {
+            break;
+        }
+
+        const size_t setSize = CPU_ALLOC_SIZE(cpuCount);
+        CPU_ZERO_S(setSize, cpuSet);
+
+        const int retc = pthread_getaffinity_np(pthread_self(), setSize, cpuSet);
+        if (retc == 0)
+        {
+            for (unsigned long i = 0; i < setSize * 8; ++i)
+            {
+                if (CPU_ISSET_S(i, setSize, cpuSet))
+                {
+                    if (ret < count)
+                    {
+                        cpus[ret] = i;
+                    }
+                    ++ret;
+                }
+            }
+        }
+
+        CPU_FREE(cpuSet);
+
+        if (retc != EINVAL)
+        {
+            break;
+        }
+    }
+
+#endif
+
+    return (ret);
+}
+
+unsigned long
+PRO_CALLTYPE
+ProGetCoreCpus(unsigned long* cpus,
+               unsigned long  count)
+{
+    assert(cpus != NULL);
+    assert(count > 0);
+    if (cpus == NULL || count == 0)
+    {
+        return (0);
+    }
+
+    CProStlVector<unsigned long> allowed;
+    allowed.resize(ProGetThreadAffinity());
+    if (allowed.size() == 0)
+    {
+        return (0);
+    }
+
+    const unsigned long allowedCount2 =
+        ProGetThreadAffinity(&allowed[0], (unsigned long)allowed.size());
+    if (allowedCount2 < allowed.size())
+    {
+        allowed.resize(allowedCount2); /* changed in between */
+    }
+
+    const int allowedCount = (int)allowed.size();
+    if (allowedCount == 0)
+    {
+        return (0);
+    }
+
+    unsigned long ret = 0;
+
+#if defined(CPU_SET)
+
+    /*
+     * the numa node of each allowed cpu
+     */
+    CProStlVector<int> nodes;
+    nodes.resize(allowed[allowedCount - 1] + 1, 0); /* ascending */
+
+    CProStlVector<unsigned long> nodeIds;
+    CProStlVector<unsigned long> nodeCpus;
+    ReadSysCpuList_i("/sys/devices/system/node/online", nodeIds);
+
+    int       i = 0;
+    const int c = (int)nodeIds.size();
+
+    for (; i < c; ++i)
+    {
+        char fileName[128] = "";
+        sprintf(fileName, "/sys/devices/system/node/node%lu/cpulist", nodeIds[i]);
+        ReadSysCpuList_i(fileName, nodeCpus);
+
+        int       k = 0;
+        const int d = (int)nodeCpus.size();
+
+        for (; k < d; ++k)
+        {
+            if (nodeCpus[k] < nodes.size())
+            {
+                nodes[nodeCpus[k]] = (int)nodeIds[i];
+            }
+        }
+    }
+
+    CProStlVector<PRO_CORE_CPU> cores;
+
+    for (int j = 0; j < allowedCount; ++j)
+    {
+        const unsigned long cpu = allowed[j];
+
+        PRO_CORE_CPU core;
+        core.node    = nodes[cpu];
+        core.package = 0;
+        core.core    = (int)cpu;
+        core.cpu     = cpu;
+
+        char fileName[128] = "";
+        sprintf(fileName, "/sys/devices/system/cpu/cpu%lu/topology/physical_package_id", cpu);
+        int value = ReadSysInt_i(fileName);
+        if (value >= 0)
+        {
+            core.package = value;
+        }
+
+        sprintf(fileName, "/sys/devices/system/cpu/cpu%lu/topology/core_id", cpu);
+        value = ReadSysInt_i(fileName);
+        if (value >= 0)
+        {
+            core.core = value;
+        }
+
+        /*
+         * skip the hyperthread siblings, and keep the order of
+         * (node, package, core)
+         */
+        const int coreCount = (int)cores.size();
+        int       pos       = coreCount;
+        int       l         = 0;
+
+        for (; l < coreCount; ++l)
+        {
+            if (cores[l].package == core.package && cores[l].core == core.core)
+            {
+                break;
+            }
+
+            if (pos == coreCount &&
+                (cores[l].node > core.node
+                ||
+                (cores[l].node == core.node && cores[l].package > core.package)
+                ||
+                (cores[l].node == core.node && cores[l].package == core.package &&
+                 cores[l].core > core.core)))
+            {
+                pos = l;
+            }
+        }
+
+        if (l < coreCount)
+        {
+            continue;
+        }
+
+        cores.insert(cores.begin() + pos, core);
+    }
+
+    for (; ret < count && ret < (unsigned long)cores.size(); ++ret)
+    {
+        cpus[ret] = cores[ret].cpu;
+    }
+
+#else  /* CPU_SET */
+
+    for (; ret < count && ret < (unsigned long)allowedCount; ++ret)
+    {
+        cpus[ret] = allowed[ret];
+    }
+
+#endif /* CPU_SET */
+
+    return (ret);
+}
+
+PRO_INT64
+PRO_CALLTYPE
+ProGetThreadCpuTime(PRO_UINT64 threadId)
+{
+    PRO_INT64 cpuTime = -1;
+
+#if defined(_WIN32_WCE)
+
+#elif defined(WIN32)
+
+    HANDLE const thread = ::OpenThread(THREAD_QUERY_INFORMATION, FALSE, (DWORD)threadId);
+    if (thread != NULL)
+    {
+        FILETIME creationTime;
+        FILETIME exitTime;
+        FILETIME kernelTime;
+        FILETIME userTime;
+
+        if (::GetThreadTimes(thread, &creationTime, &exitTime, &kernelTime, &userTime))
+        {
+            PRO_INT64 kernelTime64 = kernelTime.dwHighDateTime;
+            kernelTime64 <<= 32;
+            kernelTime64 |=  kernelTime.dwLowDateTime;
+
+            PRO_INT64 userTime64 = userTime.dwHighDateTime;
+            userTime64 <<= 32;
+            userTime64 |=  userTime.dwLowDateTime;
+
+            cpuTime = (kernelTime64 + userTime64) / 10;
+        }
+
+        ::CloseHandle(thread);
+    }
+
+#elif defined(_POSIX_THREAD_CPUTIME)
+
+    clockid_t clockId;
+    if (pthread_getcpuclockid((pthread_t)threadId, &clockId) == 0)
+    {
+        struct timespec ts;
+        if (clock_gettime(clockId, &ts) == 0)
+        {
+            cpuTime = (PRO_INT64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+        }
+    }
+
+#endif
+
+    return (cpuTime);
+}
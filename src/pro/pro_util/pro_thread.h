@@ -72,6 +72,53 @@ PRO_UINT64
 PRO_CALLTYPE
 ProGetThreadId();
 
+/*
+ * the names show up in ps/top/perf. at most 15 chars on Linux.
+ * it's a no-op on the systems that don't support it
+ */
+void
+PRO_CALLTYPE
+ProSetThreadName(const char* name);
+
+/*
+ * binds the calling thread to the "count" cpus in "cpus", which are the
+ * cpu indexes. on Windows, only the cpus of the thread's processor group
+ * can be used.
+ * returns false if it fails or isn't supported
+ */
+bool
+PRO_CALLTYPE
+ProSetThreadAffinity(const unsigned long* cpus,
+                     unsigned long        count);
+
+/*
+ * the cpus that the calling thread may run on, in ascending order.
+ * returns the number of them, of which at most "count" are written to
+ * "cpus". returns 0 if it fails or isn't supported
+ */
+unsigned long
+PRO_CALLTYPE
+ProGetThreadAffinity(unsigned long* cpus  = NULL,
+                     unsigned long  count = 0);
+
+/*
+ * the first cpu of each physical core that the calling thread may run on,
+ * ordered by the numa node. the hyperthread siblings are skipped.
+ * returns the number of the cpus written to "cpus"
+ */
+unsigned long
+PRO_CALLTYPE
+ProGetCoreCpus(unsigned long* cpus,
+               unsigned long  count);
+
+/*
+ * the cpu time of a running thread in microseconds, where "threadId" is
+ * returned by ProGetThreadId(). returns -1 if it's unavailable
+ */
+PRO_INT64
+PRO_CALLTYPE
+ProGetThreadCpuTime(PRO_UINT64 threadId);
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
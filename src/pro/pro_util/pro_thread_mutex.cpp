@@ -24,7 +24,15 @@
 #if defined(WIN32) || defined(_WIN32_WCE)
 #include <windows.h>
 #else
+#include <errno.h>
 #include <pthread.h>
+#include <sys/time.h>
+#include <time.h>
+#endif
+
+#if !defined(WIN32) && !defined(_WIN32_WCE) && \
+    !defined(PRO_LACKS_CLOCK_GETTIME) && !defined(__ANDROID__)
+#define PRO_HAS_MONOTONIC_CONDITION
 #endif
 
 /////////////////////////////////////////////////////////////////////////////
@@ -111,6 +119,26 @@ public:
         }
     }
 
+    bool TimedWait(
+        CProThreadMutex* mutex,
+        unsigned long    milliseconds
+        )
+    {
+        if (mutex != NULL)
+        {
+            mutex->Unlock();
+        }
+
+        const DWORD retc = ::WaitForSingleObject(m_sem, milliseconds);
+
+        if (mutex != NULL)
+        {
+            mutex->Lock();
+        }
+
+        return (retc == WAIT_OBJECT_0);
+    }
+
     void Signal()
     {
         ::ReleaseSemaphore(m_sem, 1, NULL);
@@ -166,7 +194,16 @@ public:
     {
         m_signal  = false;
         m_waiters = 0;
+
+#if defined(PRO_HAS_MONOTONIC_CONDITION)
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&m_condt, &attr);
+        pthread_condattr_destroy(&attr);
+#else
         pthread_cond_init(&m_condt, NULL);
+#endif
     }
 
     ~CProThreadMutexConditionImpl()
@@ -226,6 +263,62 @@ public:
         }
     }
 
+    bool TimedWait(
+        CProThreadMutex* mutex,
+        unsigned long    milliseconds
+        )
+    {
+        struct timespec ts;
+
+#if defined(PRO_HAS_MONOTONIC_CONDITION)
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        ts.tv_sec  = tv.tv_sec;
+        ts.tv_nsec = tv.tv_usec * 1000;
+#endif
+
+        ts.tv_sec  += milliseconds / 1000;
+        ts.tv_nsec += (long)(milliseconds % 1000) * 1000000;
+        if (ts.tv_nsec >= 1000000000)
+        {
+            ts.tv_sec  += 1;
+            ts.tv_nsec -= 1000000000;
+        }
+
+        if (mutex != NULL)
+        {
+            mutex->Unlock();
+        }
+
+        m_mutex.Lock();   /* [[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[ */
+
+        while (!m_signal)
+        {
+            ++m_waiters;
+            const int retc = pthread_cond_timedwait(&m_condt, &m_mutex.m_mutext, &ts);
+            --m_waiters;
+
+            if (retc == ETIMEDOUT)
+            {
+                break;
+            }
+        }
+
+        const bool ret = m_signal;
+        m_signal = false;
+
+        m_mutex.Unlock(); /* ]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]] */
+
+        if (mutex != NULL)
+        {
+            mutex->Lock();
+        }
+
+        return (ret);
+    }
+
     void Signal()
     {
         m_mutex.Lock();   /* [[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[ */
@@ -525,6 +618,13 @@ CProThreadMutexCondition::Waitrc(CProRecursiveThreadMutex* rcmutex)
     m_impl->Waitrc(rcmutex);
 }
 
+bool
+CProThreadMutexCondition::TimedWait(CProThreadMutex* mutex,
+                                    unsigned long    milliseconds)
+{
+    return (m_impl->TimedWait(mutex, milliseconds));
+}
+
 void
 CProThreadMutexCondition::Signal()
 {
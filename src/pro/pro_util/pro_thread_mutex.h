@@ -174,6 +174,14 @@ public:
      */
     void Waitrc(CProRecursiveThreadMutex* rcmutex);
 
+    /*
+     * the "mutex" can be NULL. returns false if timed out
+     */
+    bool TimedWait(
+        CProThreadMutex* mutex,
+        unsigned long    milliseconds
+        );
+
     void Signal();
 
 private:
@@ -25,6 +25,8 @@
 
 #if defined(WIN32) || defined(_WIN32_WCE)
 #include <windows.h>
+#else
+#include <time.h>
 #endif
 
 #include <cassert>
@@ -39,6 +41,34 @@ ProGetTickCount64()
     return (ProGetTickCount64_s());
 }
 
+PRO_INT64
+PRO_CALLTYPE
+ProGetMicroTickCount64()
+{
+#if defined(WIN32) || defined(_WIN32_WCE)
+
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (::QueryPerformanceFrequency(&frequency) && frequency.QuadPart > 0 &&
+        ::QueryPerformanceCounter(&counter))
+    {
+        return (counter.QuadPart / frequency.QuadPart * 1000000 +
+            counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+    }
+
+#elif defined(CLOCK_MONOTONIC)
+
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+    {
+        return ((PRO_INT64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+    }
+
+#endif
+
+    return (ProGetTickCount64() * 1000);
+}
+
 void
 PRO_CALLTYPE
 ProSleep(PRO_UINT32 milliseconds)
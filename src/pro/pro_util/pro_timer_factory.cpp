@@ -22,6 +22,7 @@
 #include "pro_functor_command_task.h"
 #include "pro_memory_pool.h"
 #include "pro_stl.h"
+#include "pro_thread.h"
 #include "pro_thread_mutex.h"
 #include "pro_time_util.h"
 #include "pro_z.h"
@@ -33,6 +34,7 @@
 #endif
 
 #include <cassert>
+#include <cstring>
 
 #if defined(_MSC_VER)
 #if defined(_WIN32_WCE)
@@ -51,20 +53,409 @@
 
 #define DEFAULT_HEARTBEAT_INTERVAL 25
 
+#define WHEEL_BITS0                8
+#define WHEEL_BITSN                6
+#define WHEEL_SLOTS0               (1 << WHEEL_BITS0)
+#define WHEEL_SLOTSN               (1 << WHEEL_BITSN)
+#define WHEEL_MASK0                (WHEEL_SLOTS0 - 1)
+#define WHEEL_MASKN                (WHEEL_SLOTSN - 1)
+#define WHEEL_LEVELS               4
+#define WHEEL_MAX_SPAN             (((PRO_INT64)1 << (WHEEL_BITS0 + WHEEL_BITSN * WHEEL_LEVELS)) - 1)
+#define WHEEL_INIT_BUCKETS         256
+#define WHEEL_MAX_WAIT             60000
+
 typedef void (CProTimerFactory::* ACTION)(PRO_INT64*);
 
+struct PRO_TIMER_WHEEL_NODE
+{
+    PRO_TIMER_NODE         node;
+    PRO_TIMER_WHEEL_NODE*  prev;
+    PRO_TIMER_WHEEL_NODE*  next;
+    PRO_TIMER_WHEEL_NODE*  hashNext;
+    PRO_TIMER_WHEEL_NODE** slot;
+
+    DECLARE_SGI_POOL(0);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+static inline
+int
+WheelShift_i(int level) /* 1 ~ 4 */
+{
+    return (WHEEL_BITS0 + WHEEL_BITSN * (level - 1));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+CProTimerWheel::CProTimerWheel()
+{
+    m_tick   = 0;
+    m_count  = 0;
+    m_count0 = 0;
+
+    memset(m_slots0, 0, sizeof(m_slots0));
+    memset(m_slotsN, 0, sizeof(m_slotsN));
+
+    m_buckets.resize(WHEEL_INIT_BUCKETS, NULL);
+}
+
+CProTimerWheel::~CProTimerWheel()
+{
+    Clear();
+}
+
+void
+CProTimerWheel::Reset(PRO_INT64 tick)
+{
+    assert(m_count == 0);
+    if (m_count != 0)
+    {
+        return;
+    }
+
+    m_tick = tick;
+}
+
+void
+CProTimerWheel::Insert(const PRO_TIMER_NODE& node)
+{
+    if (m_count >= m_buckets.size())
+    {
+        Rehash_i((unsigned long)m_buckets.size() * 2);
+    }
+
+    PRO_TIMER_WHEEL_NODE* const wnode = new PRO_TIMER_WHEEL_NODE;
+    wnode->node = node;
+
+    const unsigned long index =
+        (node.timerId >> 1) & ((unsigned long)m_buckets.size() - 1);
+    wnode->hashNext  = m_buckets[index];
+    m_buckets[index] = wnode;
+
+    Link_i(wnode);
+    ++m_count;
+}
+
+bool
+CProTimerWheel::Erase(unsigned long   timerId,
+                      PRO_TIMER_NODE* node) /* = NULL */
+{
+    const unsigned long index =
+        (timerId >> 1) & ((unsigned long)m_buckets.size() - 1);
+
+    PRO_TIMER_WHEEL_NODE** link  = &m_buckets[index];
+    PRO_TIMER_WHEEL_NODE*  wnode = *link;
+
+    while (wnode != NULL && wnode->node.timerId != timerId)
+    {
+        link  = &wnode->hashNext;
+        wnode = *link;
+    }
+
+    if (wnode == NULL)
+    {
+        return (false);
+    }
+
+    *link = wnode->hashNext;
+
+    Unlink_i(wnode);
+    --m_count;
+
+    if (node != NULL)
+    {
+        *node = wnode->node;
+    }
+
+    delete wnode;
+
+    return (true);
+}
+
+void
+CProTimerWheel::Expire(PRO_INT64                      tick,
+                       CProStlVector<PRO_TIMER_NODE>& timers)
+{
+    while (m_tick <= tick)
+    {
+        if (m_count == 0)
+        {
+            m_tick = tick + 1;
+            break;
+        }
+
+        const int index = (int)(m_tick & WHEEL_MASK0);
+
+        if (index == 0)
+        {
+            for (int level = 1; level <= WHEEL_LEVELS; ++level)
+            {
+                Cascade_i(level);
+
+                if (((m_tick >> WheelShift_i(level)) & WHEEL_MASKN) != 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        /*
+         * jump to the next cascade point if level 0 is empty
+         */
+        if (m_count0 == 0)
+        {
+            const PRO_INT64 next = (m_tick | WHEEL_MASK0) + 1;
+            m_tick = next <= tick ? next : tick + 1;
+            continue;
+        }
+
+        while (m_slots0[index] != NULL)
+        {
+            PRO_TIMER_WHEEL_NODE* const wnode = m_slots0[index];
+            timers.push_back(wnode->node);
+            Erase(wnode->node.timerId, NULL);
+        }
+
+        ++m_tick;
+    }
+}
+
+PRO_INT64
+CProTimerWheel::GetNextExpireTick() const
+{
+    if (m_count == 0)
+    {
+        return (-1);
+    }
+
+    PRO_INT64 nextTick = -1;
+
+    if (m_count0 > 0)
+    {
+        for (int i = 0; i < WHEEL_SLOTS0; ++i)
+        {
+            if (m_slots0[(m_tick + i) & WHEEL_MASK0] != NULL)
+            {
+                nextTick = m_tick + i;
+                break;
+            }
+        }
+    }
+
+    if (m_count == m_count0)
+    {
+        return (nextTick);
+    }
+
+    /*
+     * the nodes of the higher levels will be cascaded at the slot boundaries
+     */
+    for (int level = 1; level <= WHEEL_LEVELS; ++level)
+    {
+        const int       shift = WheelShift_i(level);
+        const PRO_INT64 first = ((m_tick + ((PRO_INT64)1 << shift) - 1) >> shift);
+
+        for (int i = 0; i < WHEEL_SLOTSN; ++i)
+        {
+            const PRO_INT64 tick = (first + i) << shift;
+            if (nextTick >= 0 && tick >= nextTick)
+            {
+                break;
+            }
+
+            if (m_slotsN[level - 1][(first + i) & WHEEL_MASKN] != NULL)
+            {
+                nextTick = tick;
+                break;
+            }
+        }
+    }
+
+    return (nextTick);
+}
+
+void
+CProTimerWheel::GetAll(CProStlVector<PRO_TIMER_NODE>& timers) const
+{
+    int       i = 0;
+    const int c = (int)m_buckets.size();
+
+    for (; i < c; ++i)
+    {
+        const PRO_TIMER_WHEEL_NODE* wnode = m_buckets[i];
+        for (; wnode != NULL; wnode = wnode->hashNext)
+        {
+            timers.push_back(wnode->node);
+        }
+    }
+}
+
+void
+CProTimerWheel::Clear()
+{
+    int       i = 0;
+    const int c = (int)m_buckets.size();
+
+    for (; i < c; ++i)
+    {
+        PRO_TIMER_WHEEL_NODE* wnode = m_buckets[i];
+        while (wnode != NULL)
+        {
+            PRO_TIMER_WHEEL_NODE* const next = wnode->hashNext;
+            delete wnode;
+            wnode = next;
+        }
+
+        m_buckets[i] = NULL;
+    }
+
+    m_count  = 0;
+    m_count0 = 0;
+
+    memset(m_slots0, 0, sizeof(m_slots0));
+    memset(m_slotsN, 0, sizeof(m_slotsN));
+}
+
+void
+CProTimerWheel::Link_i(PRO_TIMER_WHEEL_NODE* wnode)
+{
+    assert(wnode != NULL);
+
+    PRO_INT64 expireTick = wnode->node.expireTick;
+    if (expireTick < m_tick)
+    {
+        expireTick = m_tick;
+    }
+    else if (expireTick - m_tick > WHEEL_MAX_SPAN)
+    {
+        expireTick = m_tick + WHEEL_MAX_SPAN; /* cascaded again later */
+    }
+
+    const PRO_INT64 delta = expireTick - m_tick;
+
+    if (delta < WHEEL_SLOTS0)
+    {
+        wnode->slot = &m_slots0[expireTick & WHEEL_MASK0];
+        ++m_count0;
+    }
+    else
+    {
+        int level = 1;
+        while (level < WHEEL_LEVELS &&
+            delta >= ((PRO_INT64)1 << (WheelShift_i(level) + WHEEL_BITSN)))
+        {
+            ++level;
+        }
+
+        wnode->slot = &m_slotsN[level - 1]
+            [(expireTick >> WheelShift_i(level)) & WHEEL_MASKN];
+    }
+
+    wnode->prev = NULL;
+    wnode->next = *wnode->slot;
+    if (wnode->next != NULL)
+    {
+        wnode->next->prev = wnode;
+    }
+    *wnode->slot = wnode;
+}
+
+void
+CProTimerWheel::Unlink_i(PRO_TIMER_WHEEL_NODE* wnode)
+{
+    assert(wnode != NULL);
+
+    if (wnode->prev != NULL)
+    {
+        wnode->prev->next = wnode->next;
+    }
+    else
+    {
+        *wnode->slot = wnode->next;
+    }
+
+    if (wnode->next != NULL)
+    {
+        wnode->next->prev = wnode->prev;
+    }
+
+    if (wnode->slot >= &m_slots0[0] && wnode->slot < &m_slots0[WHEEL_SLOTS0])
+    {
+        --m_count0;
+    }
+
+    wnode->prev = NULL;
+    wnode->next = NULL;
+    wnode->slot = NULL;
+}
+
+void
+CProTimerWheel::Cascade_i(int level) /* 1 ~ 4 */
+{
+    PRO_TIMER_WHEEL_NODE** const slot = &m_slotsN[level - 1]
+        [(m_tick >> WheelShift_i(level)) & WHEEL_MASKN];
+
+    PRO_TIMER_WHEEL_NODE* wnode = *slot;
+    *slot = NULL;
+
+    while (wnode != NULL)
+    {
+        PRO_TIMER_WHEEL_NODE* const next = wnode->next;
+        Link_i(wnode);
+        wnode = next;
+    }
+}
+
+void
+CProTimerWheel::Rehash_i(unsigned long bucketCount)
+{
+    CProStlVector<PRO_TIMER_WHEEL_NODE*> buckets;
+    buckets.resize(bucketCount, NULL);
+
+    int       i = 0;
+    const int c = (int)m_buckets.size();
+
+    for (; i < c; ++i)
+    {
+        PRO_TIMER_WHEEL_NODE* wnode = m_buckets[i];
+        while (wnode != NULL)
+        {
+            PRO_TIMER_WHEEL_NODE* const next = wnode->hashNext;
+
+            const unsigned long index =
+                (wnode->node.timerId >> 1) & (bucketCount - 1);
+            wnode->hashNext = buckets[index];
+            buckets[index]  = wnode;
+
+            wnode = next;
+        }
+    }
+
+    m_buckets.swap(buckets);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 ////
 
 CProTimerFactory::CProTimerFactory()
 {
     m_task         = NULL;
+    m_wheel        = NULL;
+    m_started      = false;
     m_wantExit     = false;
     m_mmTimer      = false;
     m_mmResolution = 0;
     m_htbtTimeSpan = DEFAULT_HEARTBEAT_INTERVAL * 1000;
 
+    m_htbtCursor      = 0;
+    m_htbtMemberCount = 0;
+
     m_htbtCounts.resize(1000); /* 1000 steps */
+    m_htbtGroups.resize(1000, NULL);
+    m_htbtGroupTimerIds.resize(1000, 0);
 }
 
 CProTimerFactory::~CProTimerFactory()
@@ -73,26 +464,31 @@ CProTimerFactory::~CProTimerFactory()
 }
 
 bool
-CProTimerFactory::Start(bool mmTimer)
+CProTimerFactory::Start(bool mmTimer,
+                        bool timingWheel,  /* = false */
+                        bool workerThread) /* = true */
 {{
     CProThreadMutexGuard mon(m_lockAtom);
 
     {
         CProThreadMutexGuard mon(m_lock);
 
-        assert(m_task == NULL);
-        if (m_task != NULL)
+        assert(!m_started);
+        if (m_started)
         {
             return (false);
         }
 
-        m_task = new CProFunctorCommandTask;
-        if (!m_task->Start(mmTimer))
+        if (workerThread)
         {
-            delete m_task;
-            m_task = NULL;
+            m_task = new CProFunctorCommandTask;
+            if (!m_task->Start(mmTimer))
+            {
+                delete m_task;
+                m_task = NULL;
 
-            return (false);
+                return (false);
+            }
         }
 
 #if defined(WIN32) || defined(_WIN32_WCE)
@@ -111,22 +507,37 @@ CProTimerFactory::Start(bool mmTimer)
         }
 #endif
 
+        m_started = true;
         m_mmTimer = mmTimer;
 
+        if (timingWheel)
+        {
+            m_wheel = new CProTimerWheel;
+            m_wheel->Reset(ProGetTickCount64());
+        }
+
         int       i = 0;
         const int c = (int)m_htbtCounts.size();
 
         for (; i < c; ++i)
         {
-            m_htbtCounts[i] = 0;
+            m_htbtCounts[i]        = 0;
+            m_htbtGroups[i]        = NULL;
+            m_htbtGroupTimerIds[i] = 0;
         }
 
-        IProFunctorCommand* const command =
-            CProFunctorCommand_cpp<CProTimerFactory, ACTION>::CreateInstance(
-            *this,
-            &CProTimerFactory::WorkerRun
-            );
-        m_task->Put(command);
+        m_htbtCursor      = 0;
+        m_htbtMemberCount = 0;
+
+        if (m_task != NULL)
+        {
+            IProFunctorCommand* const command =
+                CProFunctorCommand_cpp<CProTimerFactory, ACTION>::CreateInstance(
+                *this,
+                &CProTimerFactory::WorkerRun
+                );
+            m_task->Put(command);
+        }
     }
 
     return (true);
@@ -137,33 +548,72 @@ CProTimerFactory::Stop()
 {{
     CProThreadMutexGuard mon(m_lockAtom);
 
-    CProStlSet<PRO_TIMER_NODE> timers;
+    CProStlVector<PRO_TIMER_NODE> timers;
 
     {
         CProThreadMutexGuard mon(m_lock);
 
-        if (m_task == NULL)
+        if (!m_started)
         {
             return;
         }
 
+        if (m_wheel != NULL)
+        {
+            m_wheel->GetAll(timers);
+            m_wheel->Clear();
+        }
+        else
+        {
+            timers.assign(m_timers.begin(), m_timers.end());
+        }
+
         m_timerId2ExpireTick.clear();
-        timers = m_timers;
         m_timers.clear();
 
+        int       i = 0;
+        const int c = (int)m_htbtGroups.size();
+
+        for (; i < c; ++i)
+        {
+            PRO_HEARTBEAT_ENTRY* entry = m_htbtGroups[i];
+            while (entry != NULL)
+            {
+                PRO_HEARTBEAT_ENTRY* const next = entry->next;
+
+                PRO_TIMER_NODE node;
+                node.onTimer = entry->onTimer;
+                timers.push_back(node);
+
+                entry->Reset();
+                entry = next;
+            }
+
+            m_htbtGroups[i]        = NULL;
+            m_htbtGroupTimerIds[i] = 0;
+        }
+
+        m_htbtMemberCount = 0;
+
         m_wantExit = true;
         m_cond.Signal();
     }
 
-    m_task->Stop();
+    if (m_task != NULL)
+    {
+        m_task->Stop();
+    }
 
-    CProStlSet<PRO_TIMER_NODE>::const_iterator       itr = timers.begin();
-    CProStlSet<PRO_TIMER_NODE>::const_iterator const end = timers.end();
+    int       i = 0;
+    const int c = (int)timers.size();
 
-    for (; itr != end; ++itr)
+    for (; i < c; ++i)
     {
-        const PRO_TIMER_NODE& node = *itr;
-        node.onTimer->Release();
+        const PRO_TIMER_NODE& node = timers[i];
+        if (node.onTimer != NULL) /* a group timer has no target */
+        {
+            node.onTimer->Release();
+        }
     }
 
     {
@@ -177,8 +627,11 @@ CProTimerFactory::Stop()
 #endif
 
         delete m_task;
+        delete m_wheel;
 
         m_task         = NULL;
+        m_wheel        = NULL;
+        m_started      = false;
         m_wantExit     = false;
         m_mmTimer      = false;
         m_mmResolution = 0;
@@ -198,7 +651,7 @@ CProTimerFactory::ScheduleTimer(IProOnTimer* onTimer,
     assert(timeSpan2 > 0 || !recurring);
     if (onTimer == NULL
         ||
-        timeSpan2 == 0 && recurring)
+        (timeSpan2 == 0 && recurring))
     {
         return (0);
     }
@@ -208,7 +661,7 @@ CProTimerFactory::ScheduleTimer(IProOnTimer* onTimer,
     {
         CProThreadMutexGuard mon(m_lock);
 
-        if (m_task == NULL || m_wantExit)
+        if (!m_started || m_wantExit)
         {
             return (0);
         }
@@ -221,9 +674,7 @@ CProTimerFactory::ScheduleTimer(IProOnTimer* onTimer,
         node.userData   = userData;
 
         node.onTimer->AddRef();
-        m_timers.insert(node);
-        m_timerId2ExpireTick[node.timerId] = node.expireTick;
-        assert(m_timers.size() == m_timerId2ExpireTick.size());
+        InsertTimer_i(node);
         m_cond.Signal();
     }
 
@@ -245,7 +696,7 @@ CProTimerFactory::ScheduleHeartbeatTimer(IProOnTimer* onTimer,
     {
         CProThreadMutexGuard mon(m_lock);
 
-        if (m_task == NULL || m_wantExit)
+        if (!m_started || m_wantExit)
         {
             return (0);
         }
@@ -273,36 +724,29 @@ CProTimerFactory::ScheduleHeartbeatTimer(IProOnTimer* onTimer,
 
         ++m_htbtCounts[index];
 
-        const PRO_INT64 step = m_htbtTimeSpan / c;
-        const PRO_INT64 tick = ProGetTickCount64();
-
-        node.expireTick =  (tick + m_htbtTimeSpan - 1) / m_htbtTimeSpan * m_htbtTimeSpan;
-        node.expireTick += step * index;
-        node.expireTick += (PRO_INT64)(ProRand_0_1() * (step - 1));
-        node.timerId    =  ProMakeTimerId();
-        node.onTimer    =  onTimer;
-        node.timeSpan   =  m_htbtTimeSpan;
-        node.recurring  =  true;
-        node.heartbeat  =  true;
-        node.htbtIndex  =  index;
-        node.userData   =  userData;
+        node.expireTick = HeartbeatExpireTick_i(ProGetTickCount64(), index);
+        node.timerId    = ProMakeTimerId();
+        node.onTimer    = onTimer;
+        node.timeSpan   = m_htbtTimeSpan;
+        node.recurring  = true;
+        node.heartbeat  = true;
+        node.htbtIndex  = index;
+        node.userData   = userData;
 
         node.onTimer->AddRef();
-        m_timers.insert(node);
-        m_timerId2ExpireTick[node.timerId] = node.expireTick;
-        assert(m_timers.size() == m_timerId2ExpireTick.size());
+        InsertTimer_i(node);
         m_cond.Signal();
     }
 
     return (node.timerId);
 }
 
-void
+bool
 CProTimerFactory::CancelTimer(unsigned long timerId)
 {
     if (timerId == 0)
     {
-        return;
+        return (false);
     }
 
     PRO_TIMER_NODE node;
@@ -310,33 +754,16 @@ CProTimerFactory::CancelTimer(unsigned long timerId)
     {
         CProThreadMutexGuard mon(m_lock);
 
-        if (m_task == NULL)
-        {
-            return;
-        }
-
-        CProStlMap<unsigned long, PRO_INT64>::iterator const itr =
-            m_timerId2ExpireTick.find(timerId);
-        if (itr == m_timerId2ExpireTick.end())
+        if (!m_started)
         {
-            return;
+            return (false);
         }
 
-        node.expireTick = itr->second;
-        node.timerId    = timerId;
-
-        CProStlSet<PRO_TIMER_NODE>::iterator const itr2 = m_timers.find(node);
-        if (itr2 == m_timers.end())
+        if (!EraseTimer_i(timerId, node))
         {
-            return;
+            return (false);
         }
 
-        node = *itr2;
-
-        m_timers.erase(itr2);
-        m_timerId2ExpireTick.erase(itr);
-        assert(m_timers.size() == m_timerId2ExpireTick.size());
-
         if (node.heartbeat)
         {
             --m_htbtCounts[node.htbtIndex];
@@ -344,6 +771,8 @@ CProTimerFactory::CancelTimer(unsigned long timerId)
     }
 
     node.onTimer->Release();
+
+    return (true);
 }
 
 unsigned long
@@ -354,9 +783,32 @@ CProTimerFactory::GetTimerCount() const
     {
         CProThreadMutexGuard mon(m_lock);
 
-        count = (unsigned long)m_timers.size();
-    }
-
+        if (m_wheel != NULL)
+        {
+            count = m_wheel->GetCount();
+        }
+        else
+        {
+            count = (unsigned long)m_timers.size();
+        }
+
+        /*
+         * count the members instead of the group timers
+         */
+        int       i = 0;
+        const int c = (int)m_htbtGroupTimerIds.size();
+
+        for (; i < c; ++i)
+        {
+            if (m_htbtGroupTimerIds[i] != 0)
+            {
+                --count;
+            }
+        }
+
+        count += m_htbtMemberCount;
+    }
+
     return (count);
 }
 
@@ -375,7 +827,7 @@ CProTimerFactory::UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds)
     {
         CProThreadMutexGuard mon(m_lock);
 
-        if (m_task == NULL || m_wantExit)
+        if (!m_started || m_wantExit)
         {
             return (false);
         }
@@ -395,58 +847,204 @@ CProTimerFactory::UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds)
          */
         CProStlVector<PRO_TIMER_NODE> timers;
 
-        CProStlSet<PRO_TIMER_NODE>::iterator       itr = m_timers.begin();
-        CProStlSet<PRO_TIMER_NODE>::iterator const end = m_timers.end();
-
-        while (itr != end)
+        if (m_wheel != NULL)
         {
-            const PRO_TIMER_NODE& node = *itr;
-            if (node.heartbeat)
-            {
-                timers.push_back(node);
+            CProStlVector<PRO_TIMER_NODE> all;
+            m_wheel->GetAll(all);
 
-                CProStlSet<PRO_TIMER_NODE>::iterator const oldItr = itr;
-                ++itr;
-                m_timers.erase(oldItr);
+            int       i = 0;
+            const int c = (int)all.size();
+
+            for (; i < c; ++i)
+            {
+                if (all[i].heartbeat)
+                {
+                    timers.push_back(all[i]);
+                    m_wheel->Erase(all[i].timerId, NULL);
+                }
             }
-            else
+        }
+        else
+        {
+            CProStlSet<PRO_TIMER_NODE>::iterator       itr = m_timers.begin();
+            CProStlSet<PRO_TIMER_NODE>::iterator const end = m_timers.end();
+
+            while (itr != end)
             {
-                ++itr;
+                const PRO_TIMER_NODE& node = *itr;
+                if (node.heartbeat)
+                {
+                    timers.push_back(node);
+
+                    CProStlSet<PRO_TIMER_NODE>::iterator const oldItr = itr;
+                    ++itr;
+                    m_timers.erase(oldItr);
+                }
+                else
+                {
+                    ++itr;
+                }
             }
         }
 
         int             index = 0;
         const int       steps = (int)m_htbtCounts.size();
-        const PRO_INT64 step  = m_htbtTimeSpan / steps;
         const PRO_INT64 tick  = ProGetTickCount64();
 
-        int       i = 0;
+        int i = 0;
+
+        for (; i < steps; ++i)
+        {
+            m_htbtCounts[i] = 0;
+        }
+
         const int c = (int)timers.size();
 
-        for (; i < c; ++i)
+        for (i = 0; i < c; ++i)
         {
-            if (index < steps)
-            {
-                m_htbtCounts[index] = 1;
-            }
-            else
+            PRO_TIMER_NODE& node = timers[i];
+
+            /*
+             * a group timer keeps its slot
+             */
+            if (node.onTimer != NULL)
             {
-                ++m_htbtCounts[index % steps];
+                node.htbtIndex = index++ % steps;
+                ++m_htbtCounts[node.htbtIndex];
             }
 
-            PRO_TIMER_NODE& node = timers[i];
-            node.expireTick =  (tick + m_htbtTimeSpan - 1) / m_htbtTimeSpan * m_htbtTimeSpan;
-            node.expireTick += step * index;
-            node.expireTick += (PRO_INT64)(ProRand_0_1() * (step - 1));
-            node.timeSpan   =  m_htbtTimeSpan;
-            node.htbtIndex  =  index++;
-
-            m_timers.insert(node);
-            m_timerId2ExpireTick[node.timerId] = node.expireTick;
-            assert(m_timers.size() == m_timerId2ExpireTick.size());
+            node.expireTick = HeartbeatExpireTick_i(tick, node.htbtIndex);
+            node.timeSpan   = m_htbtTimeSpan;
+
+            InsertTimer_i(node);
+        }
+
+        m_cond.Signal();
+    }
+
+    return (true);
+}
+
+unsigned long
+CProTimerFactory::JoinHeartbeatGroup(PRO_HEARTBEAT_ENTRY* entry,
+                                     IProOnTimer*         onTimer,
+                                     PRO_INT64            userData) /* = 0 */
+{
+    assert(entry != NULL);
+    assert(onTimer != NULL);
+    if (entry == NULL || onTimer == NULL)
+    {
+        return (0);
+    }
+
+    unsigned long timerId = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (!m_started || m_wantExit)
+        {
+            return (0);
+        }
+
+        assert(!m_mmTimer);
+        assert(entry->timerId == 0);
+        if (m_mmTimer || entry->timerId != 0)
+        {
+            return (0);
+        }
+
+        /*
+         * round-robin, O(1)
+         */
+        const unsigned long index = m_htbtCursor;
+        m_htbtCursor = (m_htbtCursor + 1) % (unsigned long)m_htbtGroups.size();
+
+        if (m_htbtGroupTimerIds[index] == 0)
+        {
+            PRO_TIMER_NODE node;
+            node.expireTick = HeartbeatExpireTick_i(ProGetTickCount64(), index);
+            node.timerId    = ProMakeTimerId();
+            node.onTimer    = NULL; /* a group timer */
+            node.timeSpan   = m_htbtTimeSpan;
+            node.recurring  = true;
+            node.heartbeat  = true;
+            node.htbtIndex  = index;
+
+            InsertTimer_i(node);
+            m_htbtGroupTimerIds[index] = node.timerId;
+            m_cond.Signal();
+        }
+
+        entry->factory   = this;
+        entry->onTimer   = onTimer;
+        entry->userData  = userData;
+        entry->timerId   = ProMakeTimerId();
+        entry->htbtIndex = index;
+        entry->prev      = NULL;
+        entry->next      = m_htbtGroups[index];
+        if (entry->next != NULL)
+        {
+            entry->next->prev = entry;
+        }
+        m_htbtGroups[index] = entry;
+
+        ++m_htbtMemberCount;
+        onTimer->AddRef();
+        timerId = entry->timerId;
+    }
+
+    return (timerId);
+}
+
+bool
+CProTimerFactory::LeaveHeartbeatGroup(PRO_HEARTBEAT_ENTRY* entry,
+                                      unsigned long        timerId)
+{
+    if (entry == NULL || timerId == 0)
+    {
+        return (false);
+    }
+
+    IProOnTimer* onTimer = NULL;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (!m_started || entry->factory != this || entry->timerId != timerId)
+        {
+            return (false);
+        }
+
+        const unsigned long index = entry->htbtIndex;
+
+        if (entry->prev != NULL)
+        {
+            entry->prev->next = entry->next;
         }
+        else
+        {
+            m_htbtGroups[index] = entry->next;
+        }
+        if (entry->next != NULL)
+        {
+            entry->next->prev = entry->prev;
+        }
+
+        if (m_htbtGroups[index] == NULL)
+        {
+            PRO_TIMER_NODE node;
+            EraseTimer_i(m_htbtGroupTimerIds[index], node);
+            m_htbtGroupTimerIds[index] = 0;
+        }
+
+        --m_htbtMemberCount;
+        onTimer = entry->onTimer;
+        entry->Reset();
     }
 
+    onTimer->Release();
+
     return (true);
 }
 
@@ -464,89 +1062,298 @@ CProTimerFactory::GetHeartbeatInterval() const
     return ((unsigned long)(timeSpan / 1000));
 }
 
+PRO_INT64
+CProTimerFactory::GetNextExpireTick() const
+{
+    PRO_INT64 nextTick = -1;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        if (m_wheel != NULL)
+        {
+            nextTick = m_wheel->GetNextExpireTick();
+        }
+        else if (m_timers.size() > 0)
+        {
+            nextTick = m_timers.begin()->expireTick;
+        }
+    }
+
+    return (nextTick);
+}
+
 void
-CProTimerFactory::WorkerRun(PRO_INT64* args)
+CProTimerFactory::Poll()
 {
-    while (1)
+    CProStlVector<PRO_TIMER_NODE> timers;
+
     {
-        CProStlVector<PRO_TIMER_NODE> timers;
+        CProThreadMutexGuard mon(m_lock);
 
+        assert(m_task == NULL);
+        if (!m_started || m_task != NULL || m_wantExit)
         {
-            CProThreadMutexGuard mon(m_lock);
+            return;
+        }
 
-            while (1)
-            {
-                if (m_wantExit || m_timers.size() > 0)
-                {
-                    break;
-                }
+        ExpireTimers_i(ProGetTickCount64(), timers);
+    }
 
-                m_cond.Wait(&m_lock);
-            }
+    int       i = 0;
+    const int c = (int)timers.size();
 
-            if (m_wantExit)
+    for (; i < c; ++i)
+    {
+        const PRO_TIMER_NODE& node = timers[i];
+        node.onTimer->OnTimer(node.timerId, node.userData);
+        node.onTimer->Release();
+    }
+}
+
+PRO_INT64
+CProTimerFactory::HeartbeatExpireTick_i(PRO_INT64     tick,
+                                        unsigned long htbtIndex) const
+{
+    const PRO_INT64 step = m_htbtTimeSpan / (PRO_INT64)m_htbtCounts.size();
+
+    PRO_INT64 expireTick = (tick + m_htbtTimeSpan - 1) / m_htbtTimeSpan * m_htbtTimeSpan;
+    expireTick += step * htbtIndex;
+    expireTick += (PRO_INT64)(ProRand_0_1() * (step - 1));
+
+    return (expireTick);
+}
+
+void
+CProTimerFactory::InsertTimer_i(const PRO_TIMER_NODE& node)
+{
+    if (m_wheel != NULL)
+    {
+        if (m_wheel->GetCount() == 0)
+        {
+            m_wheel->Reset(ProGetTickCount64());
+        }
+
+        m_wheel->Insert(node);
+
+        return;
+    }
+
+    m_timers.insert(node);
+    m_timerId2ExpireTick[node.timerId] = node.expireTick;
+    assert(m_timers.size() == m_timerId2ExpireTick.size());
+}
+
+bool
+CProTimerFactory::EraseTimer_i(unsigned long   timerId,
+                               PRO_TIMER_NODE& node)
+{
+    if (m_wheel != NULL)
+    {
+        return (m_wheel->Erase(timerId, &node));
+    }
+
+    CProStlMap<unsigned long, PRO_INT64>::iterator const itr =
+        m_timerId2ExpireTick.find(timerId);
+    if (itr == m_timerId2ExpireTick.end())
+    {
+        return (false);
+    }
+
+    node.expireTick = itr->second;
+    node.timerId    = timerId;
+
+    CProStlSet<PRO_TIMER_NODE>::iterator const itr2 = m_timers.find(node);
+    if (itr2 == m_timers.end())
+    {
+        return (false);
+    }
+
+    node = *itr2;
+
+    m_timers.erase(itr2);
+    m_timerId2ExpireTick.erase(itr);
+    assert(m_timers.size() == m_timerId2ExpireTick.size());
+
+    return (true);
+}
+
+void
+CProTimerFactory::ExpireTimers_i(PRO_INT64                      tick,
+                                 CProStlVector<PRO_TIMER_NODE>& timers)
+{
+    if (m_wheel != NULL)
+    {
+        m_wheel->Expire(tick, timers);
+    }
+    else
+    {
+        CProStlSet<PRO_TIMER_NODE>::const_iterator       itr = m_timers.begin();
+        CProStlSet<PRO_TIMER_NODE>::const_iterator const end = m_timers.end();
+
+        for (; itr != end; ++itr)
+        {
+            const PRO_TIMER_NODE& node = *itr;
+            if (node.expireTick > tick)
             {
                 break;
             }
 
-            const PRO_INT64 tick = ProGetTickCount64();
+            timers.push_back(node);
+        }
+    }
 
-            CProStlSet<PRO_TIMER_NODE>::const_iterator       itr = m_timers.begin();
-            CProStlSet<PRO_TIMER_NODE>::const_iterator const end = m_timers.end();
+    int       i = 0;
+    const int c = (int)timers.size();
 
-            for (; itr != end; ++itr)
+    for (; i < c; ++i)
+    {
+        PRO_TIMER_NODE& node = timers[i];
+        if (node.recurring || node.heartbeat)
+        {
+            if (m_wheel == NULL)
             {
-                const PRO_TIMER_NODE& node = *itr;
-                if (node.expireTick > tick)
+                m_timers.erase(node);
+            }
+
+            if (node.heartbeat)
+            {
+                const PRO_INT64 offset = node.expireTick % node.timeSpan;
+                node.expireTick = (tick + node.timeSpan - 1) /
+                    node.timeSpan * node.timeSpan + offset;
+                if (node.expireTick == tick)
                 {
-                    break;
+                    node.expireTick += node.timeSpan; /* !!! */
                 }
+            }
+            else
+            {
+                node.expireTick = tick + node.timeSpan;
+            }
 
-                timers.push_back(node);
+            if (node.onTimer != NULL)
+            {
+                node.onTimer->AddRef();               /* !!! */
             }
+            InsertTimer_i(node);
+        }
+        else if (m_wheel == NULL)
+        {
+            m_timers.erase(node);
+            m_timerId2ExpireTick.erase(node.timerId);
+            assert(m_timers.size() == m_timerId2ExpireTick.size());
+        }
+    }
 
-            int       i = 0;
-            const int c = (int)timers.size();
+    if (m_htbtMemberCount == 0)
+    {
+        return;
+    }
 
-            for (; i < c; ++i)
+    /*
+     * replace the group timers with their members
+     */
+    CProStlVector<PRO_TIMER_NODE> timers2;
+
+    for (i = 0; i < c; ++i)
+    {
+        const PRO_TIMER_NODE& node = timers[i];
+        if (node.onTimer != NULL)
+        {
+            timers2.push_back(node);
+            continue;
+        }
+
+        PRO_HEARTBEAT_ENTRY* entry = m_htbtGroups[node.htbtIndex];
+        for (; entry != NULL; entry = entry->next)
+        {
+            PRO_TIMER_NODE member;
+            member.expireTick = node.expireTick;
+            member.timerId    = entry->timerId;
+            member.onTimer    = entry->onTimer;
+            member.timeSpan   = node.timeSpan;
+            member.recurring  = true;
+            member.heartbeat  = true;
+            member.htbtIndex  = node.htbtIndex;
+            member.userData   = entry->userData;
+
+            member.onTimer->AddRef();
+            timers2.push_back(member);
+        }
+    }
+
+    timers.swap(timers2);
+}
+
+void
+CProTimerFactory::WorkerRun(PRO_INT64* args)
+{
+    ProSetThreadName(m_mmTimer ? "pro_mm_timer" : "pro_timer");
+
+    while (1)
+    {
+        CProStlVector<PRO_TIMER_NODE> timers;
+
+        {
+            CProThreadMutexGuard mon(m_lock);
+
+            while (1)
             {
-                PRO_TIMER_NODE& node = timers[i];
-                if (node.recurring || node.heartbeat)
+                if (m_wantExit)
                 {
-                    m_timers.erase(node);
+                    break;
+                }
 
-                    if (node.heartbeat)
-                    {
-                        const PRO_INT64 offset = node.expireTick % node.timeSpan;
-                        node.expireTick = (tick + node.timeSpan - 1) /
-                            node.timeSpan * node.timeSpan + offset;
-                        if (node.expireTick == tick)
-                        {
-                            node.expireTick += node.timeSpan; /* !!! */
-                        }
-                    }
-                    else
+                if (m_wheel == NULL)
+                {
+                    if (m_timers.size() > 0)
                     {
-                        node.expireTick = tick + node.timeSpan;
+                        break;
                     }
 
-                    node.onTimer->AddRef();                   /* !!! */
-                    m_timers.insert(node);
-                    m_timerId2ExpireTick[node.timerId] = node.expireTick;
+                    m_cond.Wait(&m_lock);
+                    continue;
                 }
-                else
+
+                /*
+                 * sleep until the next non-empty slot
+                 */
+                const PRO_INT64 nextTick = m_wheel->GetNextExpireTick();
+                if (nextTick < 0)
                 {
-                    m_timers.erase(node);
-                    m_timerId2ExpireTick.erase(node.timerId);
+                    m_cond.Wait(&m_lock);
+                    continue;
+                }
+
+                const PRO_INT64 tick = ProGetTickCount64();
+                if (nextTick <= tick)
+                {
+                    break;
                 }
 
-                assert(m_timers.size() == m_timerId2ExpireTick.size());
+                PRO_INT64 waitTime = nextTick - tick;
+                if (waitTime > WHEEL_MAX_WAIT)
+                {
+                    waitTime = WHEEL_MAX_WAIT;
+                }
+
+                m_cond.TimedWait(&m_lock, (unsigned long)waitTime);
             }
+
+            if (m_wantExit)
+            {
+                break;
+            }
+
+            ExpireTimers_i(ProGetTickCount64(), timers);
         }
 
         if (timers.size() == 0)
         {
-            ProSleep(1); /* 1ms */
+            if (m_wheel == NULL)
+            {
+                ProSleep(1); /* 1ms */
+            }
             continue;
         }
 
@@ -560,7 +1367,9 @@ CProTimerFactory::WorkerRun(PRO_INT64* args)
             node.onTimer->Release();
 
             ++j;
-            if (j == PRO_TIMER_UPCALL_COUNT || i == c - 1)
+            if ((j == PRO_TIMER_UPCALL_COUNT && i < c - 1)
+                ||
+                (i == c - 1 && m_wheel == NULL))
             {
                 j = 0;
                 ProSleep(1); /* 1ms */
@@ -28,6 +28,7 @@
 ////
 
 class CProFunctorCommandTask;
+class CProTimerFactory;
 class IProOnTimer;
 
 struct PRO_TIMER_NODE
@@ -80,6 +81,39 @@ struct PRO_TIMER_NODE
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+/*
+ * a member of the heartbeat groups. it's embedded in the target object
+ */
+struct PRO_HEARTBEAT_ENTRY
+{
+    PRO_HEARTBEAT_ENTRY()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        factory   = NULL;
+        onTimer   = NULL;
+        userData  = 0;
+        timerId   = 0;
+        htbtIndex = 0;
+        prev      = NULL;
+        next      = NULL;
+    }
+
+    CProTimerFactory*    factory;
+    IProOnTimer*         onTimer;
+    PRO_INT64            userData;
+    unsigned long        timerId;
+    unsigned long        htbtIndex;
+    PRO_HEARTBEAT_ENTRY* prev;
+    PRO_HEARTBEAT_ENTRY* next;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
 /*
  * please refer to "pro_net/pro_net.h"
  */
@@ -103,6 +137,78 @@ public:
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+struct PRO_TIMER_WHEEL_NODE;
+
+/*
+ * hierarchical timing wheel. level 0 has 256 slots of 1ms, and levels 1~4
+ * have 64 slots each. Insert() and Erase() are O(1)
+ *
+ * not thread-safe, the caller should hold a lock
+ */
+class CProTimerWheel
+{
+public:
+
+    CProTimerWheel();
+
+    ~CProTimerWheel();
+
+    void Reset(PRO_INT64 tick);
+
+    void Insert(const PRO_TIMER_NODE& node);
+
+    bool Erase(
+        unsigned long   timerId,
+        PRO_TIMER_NODE* node /* = NULL */
+        );
+
+    /*
+     * removes the expired nodes from the wheel and appends them to "timers"
+     */
+    void Expire(
+        PRO_INT64                      tick,
+        CProStlVector<PRO_TIMER_NODE>& timers
+        );
+
+    /*
+     * returns -1 if the wheel is empty
+     */
+    PRO_INT64 GetNextExpireTick() const;
+
+    unsigned long GetCount() const
+    {
+        return (m_count);
+    }
+
+    void GetAll(CProStlVector<PRO_TIMER_NODE>& timers) const;
+
+    void Clear();
+
+private:
+
+    void Link_i(PRO_TIMER_WHEEL_NODE* wnode);
+
+    void Unlink_i(PRO_TIMER_WHEEL_NODE* wnode);
+
+    void Cascade_i(int level);
+
+    void Rehash_i(unsigned long bucketCount);
+
+private:
+
+    PRO_INT64                            m_tick; /* the next tick to process */
+    unsigned long                        m_count;
+    unsigned long                        m_count0;
+    PRO_TIMER_WHEEL_NODE*                m_slots0[256];
+    PRO_TIMER_WHEEL_NODE*                m_slotsN[4][64];
+    CProStlVector<PRO_TIMER_WHEEL_NODE*> m_buckets;
+
+    DECLARE_SGI_POOL(0);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
 class CProTimerFactory
 {
 public:
@@ -111,7 +217,15 @@ public:
 
     ~CProTimerFactory();
 
-    bool Start(bool mmTimer);
+    /*
+     * without a worker thread, the owner should drive the factory by
+     * GetNextExpireTick() and Poll()
+     */
+    bool Start(
+        bool mmTimer,
+        bool timingWheel  = false,
+        bool workerThread = true
+        );
 
     void Stop();
 
@@ -127,28 +241,77 @@ public:
         PRO_INT64    userData = 0
         );
 
-    void CancelTimer(unsigned long timerId);
+    bool CancelTimer(unsigned long timerId);
 
     unsigned long GetTimerCount() const;
 
+    /*
+     * the members of a heartbeat group share one timer per heartbeat slot.
+     * the "entry" should be valid until LeaveHeartbeatGroup(), and the
+     * "onTimer" is referenced meanwhile. returns the timerId of the upcalls
+     */
+    unsigned long JoinHeartbeatGroup(
+        PRO_HEARTBEAT_ENTRY* entry,
+        IProOnTimer*         onTimer,
+        PRO_INT64            userData = 0
+        );
+
+    bool LeaveHeartbeatGroup(
+        PRO_HEARTBEAT_ENTRY* entry,
+        unsigned long        timerId
+        );
+
     bool UpdateHeartbeatTimers(unsigned long htbtIntervalInSeconds);
 
     unsigned long GetHeartbeatInterval() const;
 
+    /*
+     * returns -1 if there is no timer
+     */
+    PRO_INT64 GetNextExpireTick() const;
+
+    /*
+     * expires the due timers and upcalls them in the calling thread
+     */
+    void Poll();
+
 private:
 
+    PRO_INT64 HeartbeatExpireTick_i(
+        PRO_INT64     tick,
+        unsigned long htbtIndex
+        ) const;
+
+    void InsertTimer_i(const PRO_TIMER_NODE& node);
+
+    bool EraseTimer_i(
+        unsigned long   timerId,
+        PRO_TIMER_NODE& node
+        );
+
+    void ExpireTimers_i(
+        PRO_INT64                      tick,
+        CProStlVector<PRO_TIMER_NODE>& timers
+        );
+
     void WorkerRun(PRO_INT64* args);
 
 private:
 
     CProFunctorCommandTask*              m_task;
+    bool                                 m_started;
     bool                                 m_wantExit;
     bool                                 m_mmTimer;
     unsigned long                        m_mmResolution;
     CProStlSet<PRO_TIMER_NODE>           m_timers;
     CProStlMap<unsigned long, PRO_INT64> m_timerId2ExpireTick;
+    CProTimerWheel*                      m_wheel;
     PRO_INT64                            m_htbtTimeSpan;
     CProStlVector<unsigned long>         m_htbtCounts;
+    CProStlVector<PRO_HEARTBEAT_ENTRY*>  m_htbtGroups;
+    CProStlVector<unsigned long>         m_htbtGroupTimerIds;
+    unsigned long                        m_htbtCursor;
+    unsigned long                        m_htbtMemberCount;
     CProThreadMutexCondition             m_cond;
     mutable CProThreadMutex              m_lock;
     CProThreadMutex                      m_lockAtom;
@@ -95,6 +95,10 @@ CC2sServer::Init(IProReactor*                  reactor,
 
             ProSslClientConfig_EnableSha1Cert(
                 uplinkSslConfig, configInfo.c2ss_ssl_enable_sha1cert);
+            ProSslClientConfig_EnableSessionReuse(
+                uplinkSslConfig, configInfo.c2ss_ssl_session_reuse);
+            ProSslClientConfig_EnableDynamicBuffers(
+                uplinkSslConfig, configInfo.c2ss_ssl_dynamic_buffers);
 
             CProStlVector<const char*>      caFiles;
             CProStlVector<const char*>      crlFiles;
@@ -159,6 +163,15 @@ CC2sServer::Init(IProReactor*                  reactor,
             ProSslServerConfig_EnableSha1Cert(
                 localSslConfig, configInfo.c2ss_ssl_enable_sha1cert);
 
+            if (configInfo.c2ss_ssl_session_reuse)
+            {
+                ProSslServerConfig_EnableSessionTickets(localSslConfig, true, 0);
+                ProSslServerConfig_SetSessionCache(localSslConfig, 10000, 0);
+            }
+
+            ProSslServerConfig_EnableDynamicBuffers(
+                localSslConfig, configInfo.c2ss_ssl_dynamic_buffers);
+
             CProStlVector<const char*> caFiles;
             CProStlVector<const char*> crlFiles;
             CProStlVector<const char*> certFiles;
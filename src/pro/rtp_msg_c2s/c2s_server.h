@@ -48,6 +48,8 @@ struct C2S_SERVER_CONFIG_INFO
 
         c2ss_enable_ssl          = true;
         c2ss_ssl_enable_sha1cert = true;
+        c2ss_ssl_session_reuse   = true;
+        c2ss_ssl_dynamic_buffers = false;
         c2ss_ssl_uplink_sni      = "server.libpro.org";
         c2ss_ssl_uplink_aes256   = false;
         c2ss_ssl_local_forced    = false;
@@ -92,6 +94,8 @@ struct C2S_SERVER_CONFIG_INFO
 
         configStream.AddInt ("c2ss_enable_ssl"         , c2ss_enable_ssl);
         configStream.AddInt ("c2ss_ssl_enable_sha1cert", c2ss_ssl_enable_sha1cert);
+        configStream.AddInt ("c2ss_ssl_session_reuse"  , c2ss_ssl_session_reuse);
+        configStream.AddInt ("c2ss_ssl_dynamic_buffers", c2ss_ssl_dynamic_buffers);
         configStream.Add    ("c2ss_ssl_uplink_cafile"  , c2ss_ssl_uplink_cafile);
         configStream.Add    ("c2ss_ssl_uplink_crlfile" , c2ss_ssl_uplink_crlfile);
         configStream.Add    ("c2ss_ssl_uplink_sni"     , c2ss_ssl_uplink_sni);
@@ -123,6 +127,8 @@ struct C2S_SERVER_CONFIG_INFO
 
     bool                         c2ss_enable_ssl;
     bool                         c2ss_ssl_enable_sha1cert;
+    bool                         c2ss_ssl_session_reuse;
+    bool                         c2ss_ssl_dynamic_buffers;
     CProStlVector<CProStlString> c2ss_ssl_uplink_cafile;
     CProStlVector<CProStlString> c2ss_ssl_uplink_crlfile;
     CProStlString                c2ss_ssl_uplink_sni;
@@ -102,6 +102,14 @@ CMsgServer::Init(IProReactor*                  reactor,
 
             ProSslServerConfig_EnableSha1Cert(sslConfig, configInfo.msgs_ssl_enable_sha1cert);
 
+            if (configInfo.msgs_ssl_session_reuse)
+            {
+                ProSslServerConfig_EnableSessionTickets(sslConfig, true, 0);
+                ProSslServerConfig_SetSessionCache(sslConfig, 10000, 0);
+            }
+
+            ProSslServerConfig_EnableDynamicBuffers(sslConfig, configInfo.msgs_ssl_dynamic_buffers);
+
             CProStlVector<const char*> caFiles;
             CProStlVector<const char*> crlFiles;
             CProStlVector<const char*> certFiles;
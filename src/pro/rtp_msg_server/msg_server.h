@@ -45,6 +45,8 @@ struct MSG_SERVER_CONFIG_INFO
         msgs_enable_ssl          = true;
         msgs_ssl_forced          = false;
         msgs_ssl_enable_sha1cert = true;
+        msgs_ssl_session_reuse   = true;
+        msgs_ssl_dynamic_buffers = false;
         msgs_ssl_keyfile         = "./server.key";
 
         msgs_log_loop_bytes      = 10 * 1000 * 1000;
@@ -72,6 +74,8 @@ struct MSG_SERVER_CONFIG_INFO
         configStream.AddInt ("msgs_enable_ssl"         , msgs_enable_ssl);
         configStream.AddInt ("msgs_ssl_forced"         , msgs_ssl_forced);
         configStream.AddInt ("msgs_ssl_enable_sha1cert", msgs_ssl_enable_sha1cert);
+        configStream.AddInt ("msgs_ssl_session_reuse"  , msgs_ssl_session_reuse);
+        configStream.AddInt ("msgs_ssl_dynamic_buffers", msgs_ssl_dynamic_buffers);
         configStream.Add    ("msgs_ssl_cafile"         , msgs_ssl_cafile);
         configStream.Add    ("msgs_ssl_crlfile"        , msgs_ssl_crlfile);
         configStream.Add    ("msgs_ssl_certfile"       , msgs_ssl_certfile);
@@ -93,6 +97,8 @@ struct MSG_SERVER_CONFIG_INFO
     bool                         msgs_enable_ssl;
     bool                         msgs_ssl_forced;
     bool                         msgs_ssl_enable_sha1cert;
+    bool                         msgs_ssl_session_reuse;
+    bool                         msgs_ssl_dynamic_buffers;
     CProStlVector<CProStlString> msgs_ssl_cafile;
     CProStlVector<CProStlString> msgs_ssl_crlfile;
     CProStlVector<CProStlString> msgs_ssl_certfile;
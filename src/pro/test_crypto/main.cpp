@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2018 Eric Tung <libpronet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"),
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of LibProNet (http://www.libpro.org)
+ */
+
+/*
+ * usage: test_crypto [seconds_per_case] [ca_file] [cert_file] [key_file]
+ *
+ * it measures the bulk record ciphers and the ssl handshakes of the bundled
+ * mbedtls, so that builds with and without PRO_HAS_MBEDTLS_ASM can be
+ * compared on the same machine
+ */
+
+#include "../pro_net/pro_net.h"
+#include "../pro_util/pro_bsd_wrapper.h"
+#include "../pro_util/pro_time_util.h"
+#include "../pro_util/pro_z.h"
+
+#include "mbedtls/aesni.h"
+#include "mbedtls/chachapoly.h"
+#include "mbedtls/config.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/ssl.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+#define RECORD_SIZE      16384
+#define DEFAULT_SECONDS  2
+#define MAX_STEPS        100
+#define SERVER_HOST_NAME "server.libpro.org" /* the CN of server.crt */
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+static unsigned char g_record[RECORD_SIZE];
+static unsigned char g_output[RECORD_SIZE];
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+static
+void
+PrintAccel_i()
+{
+#if defined(MBEDTLS_HAVE_ASM)
+    const char* const asmInfo = "yes";
+#else
+    const char* const asmInfo = "no";
+#endif
+
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+    const char* const aesInfo   =
+        mbedtls_aesni_has_support(MBEDTLS_AESNI_AES)   ? "yes" : "no (cpu)";
+    const char* const clmulInfo =
+        mbedtls_aesni_has_support(MBEDTLS_AESNI_CLMUL) ? "yes" : "no (cpu)";
+#else
+    const char* const aesInfo   = "no (build)";
+    const char* const clmulInfo = "no (build)";
+#endif
+
+    printf(
+        " [ Accel Asm ] : %s \n"
+        " [ Accel Aes ] : %s \n"
+        " [ Accel Mul ] : %s \n"
+        ,
+        asmInfo,
+        aesInfo,
+        clmulInfo
+        );
+}
+
+static
+void
+BenchGcm_i(const char* name,
+           unsigned    keyBits,
+           PRO_INT64   ms)
+{
+    unsigned char key[32] = { 0 };
+    unsigned char iv[12]  = { 0 };
+    unsigned char tag[16] = { 0 };
+
+    mbedtls_gcm_context gcm;
+    mbedtls_gcm_init(&gcm);
+
+    if (mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, keyBits) != 0)
+    {
+        mbedtls_gcm_free(&gcm);
+        printf(" [ %s ] : error \n", name);
+
+        return;
+    }
+
+    PRO_UINT64      bytes = 0;
+    const PRO_INT64 tick0 = ProGetTickCount64();
+    PRO_INT64       tick1 = tick0;
+
+    while (tick1 - tick0 < ms)
+    {
+        int i = 0;
+        for (; i < 64; ++i)
+        {
+            ++iv[0];
+            mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, sizeof(g_record),
+                iv, sizeof(iv), NULL, 0, g_record, g_output, sizeof(tag), tag);
+            bytes += sizeof(g_record);
+        }
+
+        tick1 = ProGetTickCount64();
+    }
+
+    mbedtls_gcm_free(&gcm);
+
+    printf(
+        " [ %s ] : %.1f MB/s \n"
+        ,
+        name,
+        (double)bytes / 1000.0 / (double)(tick1 - tick0)
+        );
+}
+
+static
+void
+BenchChachaPoly_i(PRO_INT64 ms)
+{
+    unsigned char key[32] = { 0 };
+    unsigned char iv[12]  = { 0 };
+    unsigned char tag[16] = { 0 };
+
+    mbedtls_chachapoly_context chachapoly;
+    mbedtls_chachapoly_init(&chachapoly);
+
+    if (mbedtls_chachapoly_setkey(&chachapoly, key) != 0)
+    {
+        mbedtls_chachapoly_free(&chachapoly);
+        printf(" [ ChaChaPoly ] : error \n");
+
+        return;
+    }
+
+    PRO_UINT64      bytes = 0;
+    const PRO_INT64 tick0 = ProGetTickCount64();
+    PRO_INT64       tick1 = tick0;
+
+    while (tick1 - tick0 < ms)
+    {
+        int i = 0;
+        for (; i < 64; ++i)
+        {
+            ++iv[0];
+            mbedtls_chachapoly_encrypt_and_tag(&chachapoly, sizeof(g_record),
+                iv, NULL, 0, g_record, g_output, tag);
+            bytes += sizeof(g_record);
+        }
+
+        tick1 = ProGetTickCount64();
+    }
+
+    mbedtls_chachapoly_free(&chachapoly);
+
+    printf(
+        " [ ChaChaPoly ] : %.1f MB/s \n"
+        ,
+        (double)bytes / 1000.0 / (double)(tick1 - tick0)
+        );
+}
+
+/*
+ * a client and a server over a socket pair, stepped in turn by one thread
+ */
+static
+bool
+Handshake_i(PRO_SSL_SERVER_CONFIG* serverConfig,
+            PRO_SSL_CLIENT_CONFIG* clientConfig,
+            bool&                  resumed)
+{
+    resumed = false;
+
+    PRO_INT64 fds[2] = { -1, -1 };
+    if (pbsd_socketpair(fds) != 0)
+    {
+        return (false);
+    }
+
+    pbsd_ioctl_nonblock(fds[0]);
+    pbsd_ioctl_nonblock(fds[1]);
+
+    PRO_SSL_CTX* const serverCtx = ProSslCtx_Creates(serverConfig, fds[0], 0);
+    PRO_SSL_CTX* const clientCtx = ProSslCtx_Createc(clientConfig, SERVER_HOST_NAME, fds[1], 0);
+    bool               ret       = false;
+
+    if (serverCtx != NULL && clientCtx != NULL)
+    {
+        int i = 0;
+        for (; i < MAX_STEPS; ++i)
+        {
+            const int clientRet = ProSslCtx_Handshake(clientCtx);
+            const int serverRet = ProSslCtx_Handshake(serverCtx);
+            if (clientRet == 0 && serverRet == 0)
+            {
+                ret     = true;
+                resumed = ProSslCtx_IsResumed(clientCtx);
+                break;
+            }
+
+            if (clientRet != 0 &&
+                clientRet != MBEDTLS_ERR_SSL_WANT_READ && clientRet != MBEDTLS_ERR_SSL_WANT_WRITE)
+            {
+                break;
+            }
+            if (serverRet != 0 &&
+                serverRet != MBEDTLS_ERR_SSL_WANT_READ && serverRet != MBEDTLS_ERR_SSL_WANT_WRITE)
+            {
+                break;
+            }
+        }
+    }
+
+    ProSslCtx_Delete(clientCtx);
+    ProSslCtx_Delete(serverCtx);
+    ProCloseSockId(fds[1]);
+    ProCloseSockId(fds[0]);
+
+    return (ret);
+}
+
+static
+void
+BenchHandshake_i(PRO_SSL_SERVER_CONFIG* serverConfig,
+                 PRO_SSL_CLIENT_CONFIG* clientConfig,
+                 bool                   reuse,
+                 PRO_INT64              ms)
+{
+    ProSslClientConfig_EnableSessionReuse(clientConfig, reuse);
+
+    PRO_UINT64      fullCount    = 0;
+    PRO_UINT64      resumedCount = 0;
+    const PRO_INT64 tick0        = ProGetTickCount64();
+    PRO_INT64       tick1        = tick0;
+
+    while (tick1 - tick0 < ms)
+    {
+        bool resumed = false;
+        if (!Handshake_i(serverConfig, clientConfig, resumed))
+        {
+            printf(" [ SSL  Hshk ] : error \n");
+
+            return;
+        }
+
+        if (resumed)
+        {
+            ++resumedCount;
+        }
+        else
+        {
+            ++fullCount;
+        }
+
+        tick1 = ProGetTickCount64();
+    }
+
+    printf(
+        " [ SSL  Hshk ] : %s, %.1f/s (%u full, %u resumed) \n"
+        ,
+        reuse ? "reuse" : "full ",
+        (double)(fullCount + resumedCount) * 1000.0 / (double)(tick1 - tick0),
+        (unsigned int)fullCount,
+        (unsigned int)resumedCount
+        );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+int main(int argc, char* argv[])
+{
+    ProNetInit();
+
+    int         seconds  = DEFAULT_SECONDS;
+    const char* caFile   = "./ca.crt";
+    const char* certFile = "./server.crt";
+    const char* keyFile  = "./server.key";
+
+    if (argc > 1)
+    {
+        seconds = atoi(argv[1]);
+        if (seconds <= 0)
+        {
+            seconds = DEFAULT_SECONDS;
+        }
+    }
+    if (argc > 2)
+    {
+        caFile   = argv[2];
+    }
+    if (argc > 3)
+    {
+        certFile = argv[3];
+    }
+    if (argc > 4)
+    {
+        keyFile  = argv[4];
+    }
+
+    const PRO_INT64 ms = (PRO_INT64)seconds * 1000;
+
+    printf("\n test_crypto --- %d seconds per case \n\n", seconds);
+
+    PrintAccel_i();
+    BenchGcm_i("AES128-GCM", 128, ms);
+    BenchGcm_i("AES256-GCM", 256, ms);
+    BenchChachaPoly_i(ms);
+
+    PRO_SSL_SERVER_CONFIG* const serverConfig = ProSslServerConfig_Create();
+    PRO_SSL_CLIENT_CONFIG* const clientConfig = ProSslClientConfig_Create();
+
+    if (serverConfig == NULL || clientConfig == NULL)
+    {
+        printf("\n test_crypto --- error! can't create ssl configs. \n");
+
+        goto EXIT;
+    }
+
+    if (!ProSslServerConfig_SetCaList(serverConfig, &caFile, 1, NULL, 0) ||
+        !ProSslServerConfig_AppendCertChain(serverConfig, &certFile, 1, keyFile, NULL) ||
+        !ProSslClientConfig_SetCaList(clientConfig, &caFile, 1, NULL, 0))
+    {
+        printf(
+            "\n test_crypto --- error! can't load [ %s ] [ %s ] [ %s ]. \n"
+            ,
+            caFile,
+            certFile,
+            keyFile
+            );
+
+        goto EXIT;
+    }
+
+    ProSslServerConfig_EnableSessionTickets(serverConfig, true, 0);
+
+    BenchHandshake_i(serverConfig, clientConfig, false, ms);
+    BenchHandshake_i(serverConfig, clientConfig, true , ms);
+
+EXIT:
+
+    ProSslClientConfig_Delete(clientConfig);
+    ProSslServerConfig_Delete(serverConfig);
+
+    return (0);
+}
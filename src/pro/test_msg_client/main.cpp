@@ -204,6 +204,14 @@ int main(int argc, char* argv[])
             {
                 configInfo.msgc_ssl_enable_sha1cert = atoi(configValue.c_str()) != 0;
             }
+            else if (stricmp(configName.c_str(), "msgc_ssl_session_reuse") == 0)
+            {
+                configInfo.msgc_ssl_session_reuse = atoi(configValue.c_str()) != 0;
+            }
+            else if (stricmp(configName.c_str(), "msgc_ssl_dynamic_buffers") == 0)
+            {
+                configInfo.msgc_ssl_dynamic_buffers = atoi(configValue.c_str()) != 0;
+            }
             else if (stricmp(configName.c_str(), "msgc_ssl_cafile") == 0)
             {
                 if (!configValue.empty())
@@ -86,6 +86,8 @@ CTest::Init(IProReactor*                  reactor,
             }
 
             ProSslClientConfig_EnableSha1Cert(sslConfig, configInfo.msgc_ssl_enable_sha1cert);
+            ProSslClientConfig_EnableSessionReuse(sslConfig, configInfo.msgc_ssl_session_reuse);
+            ProSslClientConfig_EnableDynamicBuffers(sslConfig, configInfo.msgc_ssl_dynamic_buffers);
 
             CProStlVector<const char*>      caFiles;
             CProStlVector<const char*>      crlFiles;
@@ -43,6 +43,8 @@ struct MSG_CLIENT_CONFIG_INFO
 
         msgc_enable_ssl          = false;
         msgc_ssl_enable_sha1cert = true;
+        msgc_ssl_session_reuse   = true;
+        msgc_ssl_dynamic_buffers = false;
         msgc_ssl_sni             = "server.libpro.org";
         msgc_ssl_aes256          = false;
 
@@ -70,6 +72,8 @@ struct MSG_CLIENT_CONFIG_INFO
 
         configStream.AddInt ("msgc_enable_ssl"         , msgc_enable_ssl);
         configStream.AddInt ("msgc_ssl_enable_sha1cert", msgc_ssl_enable_sha1cert);
+        configStream.AddInt ("msgc_ssl_session_reuse"  , msgc_ssl_session_reuse);
+        configStream.AddInt ("msgc_ssl_dynamic_buffers", msgc_ssl_dynamic_buffers);
         configStream.Add    ("msgc_ssl_cafile"         , msgc_ssl_cafile);
         configStream.Add    ("msgc_ssl_crlfile"        , msgc_ssl_crlfile);
         configStream.Add    ("msgc_ssl_sni"            , msgc_ssl_sni);
@@ -87,6 +91,8 @@ struct MSG_CLIENT_CONFIG_INFO
 
     bool                         msgc_enable_ssl;
     bool                         msgc_ssl_enable_sha1cert;
+    bool                         msgc_ssl_session_reuse;
+    bool                         msgc_ssl_dynamic_buffers;
     CProStlVector<CProStlString> msgc_ssl_cafile;
     CProStlVector<CProStlString> msgc_ssl_crlfile;
     CProStlString                msgc_ssl_sni;
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2018 Eric Tung <libpronet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"),
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of LibProNet (http://www.libpro.org)
+ */
+
+/*
+ * usage: test_sgi_pool
+ *
+ * it checks that ProTrimSgiPool() returns the chunks of an allocation burst
+ * to the os, and that the RSS drops.
+ *
+ * case 1: the burst is made by the main thread, whose own thread cache is
+ *         flushed by ProTrimSgiPool()
+ * case 2: the burst is made by a worker thread that stays alive. its thread
+ *         cache can only be flushed by itself, so the chunk pinned by it is
+ *         returned only after the worker touches the pool again. the worker
+ *         holds its first object, and frees it as that touch
+ *
+ * it returns 0 if all the checks pass
+ */
+
+#include "../pro_shared/pro_shared.h"
+#include "../pro_util/pro_thread.h"
+#include "../pro_util/pro_thread_mutex.h"
+#include "../pro_util/pro_z.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+#define POOL_INDEX  9           /* a pool not used by the libraries */
+#define OBJ_SIZE    256
+#define OBJ_COUNT   (1024 * 256) /* 64MB */
+#define BURST_BYTES ((size_t)OBJ_SIZE * OBJ_COUNT)
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+static void* g_objs[OBJ_COUNT];
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+/*
+ * the resident set size in bytes. 0 if unknown
+ */
+static
+size_t
+GetRss_i()
+{
+    size_t rss = 0;
+
+#if defined(__linux__) || defined(__ANDROID__)
+    FILE* const file = fopen("/proc/self/statm", "r");
+    if (file != NULL)
+    {
+        unsigned long pages    = 0;
+        unsigned long resident = 0;
+        if (fscanf(file, "%lu %lu", &pages, &resident) == 2)
+        {
+            rss = (size_t)resident * 4096;
+        }
+
+        fclose(file);
+    }
+#endif
+
+    return (rss);
+}
+
+static
+void
+Burst_i(int keepCount)
+{
+    int i = 0;
+    for (; i < OBJ_COUNT; ++i)
+    {
+        g_objs[i] = ProAllocateSgiPoolBuffer(OBJ_SIZE, POOL_INDEX);
+        if (g_objs[i] != NULL)
+        {
+            memset(g_objs[i], 0x55, OBJ_SIZE); /* touch it */
+        }
+    }
+
+    for (i = keepCount; i < OBJ_COUNT; ++i)
+    {
+        ProDeallocateSgiPoolBuffer(g_objs[i], POOL_INDEX);
+        g_objs[i] = NULL;
+    }
+}
+
+static
+bool
+Check_i(const char* name,
+        bool        ok)
+{
+    printf(" [ %s ] : %s \n", name, ok ? "ok" : "FAILED");
+
+    return (ok);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+class CWorker : public CProThreadBase
+{
+public:
+
+    CWorker()
+    {
+    }
+
+    bool Start()
+    {
+        return (Spawn(false));
+    }
+
+    void Stop()
+    {
+        m_toWorker.Signal();
+        Wait();
+    }
+
+    /*
+     * the worker makes a burst, and stays alive
+     */
+    void WaitBurst()
+    {
+        m_toMain.Wait(NULL);
+    }
+
+    /*
+     * the worker frees the object it holds
+     */
+    void Poke()
+    {
+        m_toWorker.Signal();
+        m_toMain.Wait(NULL);
+    }
+
+private:
+
+    virtual void Svc()
+    {
+        Burst_i(1);
+        m_toMain.Signal();
+
+        m_toWorker.Wait(NULL);
+        ProDeallocateSgiPoolBuffer(g_objs[0], POOL_INDEX);
+        g_objs[0] = NULL;
+        m_toMain.Signal();
+
+        m_toWorker.Wait(NULL);
+    }
+
+private:
+
+    CProThreadMutexCondition m_toWorker;
+    CProThreadMutexCondition m_toMain;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
+int main(int argc, char* argv[])
+{
+    bool ok = true;
+
+    printf("\n test_sgi_pool --- burst %u bytes \n\n", (unsigned int)BURST_BYTES);
+
+    /*
+     * case 1
+     */
+    {
+        const size_t rss0     = GetRss_i();
+        Burst_i(0);
+        const size_t rss1     = GetRss_i();
+        const size_t released = ProTrimSgiPool(POOL_INDEX);
+        const size_t rss2     = GetRss_i();
+
+        printf(
+            " [ Main Thrd ] : rss %u -> %u -> %u KB, released %u KB \n"
+            ,
+            (unsigned int)(rss0 / 1024),
+            (unsigned int)(rss1 / 1024),
+            (unsigned int)(rss2 / 1024),
+            (unsigned int)(released / 1024)
+            );
+
+        ok = Check_i("Main Trim", released >= BURST_BYTES / 2) && ok;
+        if (rss1 > 0)
+        {
+            ok = Check_i("Main Rss ", rss1 - rss2 >= BURST_BYTES / 2) && ok;
+        }
+    }
+
+    /*
+     * case 2
+     */
+    {
+        CWorker worker;
+        if (!worker.Start())
+        {
+            printf(" test_sgi_pool --- error! can't spawn a thread. \n");
+
+            return (1);
+        }
+
+        worker.WaitBurst();
+
+        const size_t rss1      = GetRss_i();
+        const size_t released1 = ProTrimSgiPool(POOL_INDEX); /* the worker's cache is pinned */
+        worker.Poke();
+        const size_t released2 = ProTrimSgiPool(POOL_INDEX); /* flushed by the worker itself */
+        const size_t rss2      = GetRss_i();
+
+        PRO_UINT64 cacheHits = 0;
+        ProGetSgiPoolCacheInfo(NULL, &cacheHits, NULL, POOL_INDEX);
+
+        worker.Stop();
+
+        printf(
+            " [ Work Thrd ] : rss %u -> %u KB, released %u + %u KB \n"
+            ,
+            (unsigned int)(rss1 / 1024),
+            (unsigned int)(rss2 / 1024),
+            (unsigned int)(released1 / 1024),
+            (unsigned int)(released2 / 1024)
+            );
+
+        ok = Check_i("Work Trim", released1 + released2 >= BURST_BYTES / 2) && ok;
+        if (cacheHits > 0)
+        {
+            ok = Check_i("Work Late", released2 > 0) && ok;
+        }
+        if (rss1 > 0)
+        {
+            ok = Check_i("Work Rss ", rss1 - rss2 >= BURST_BYTES / 2) && ok;
+        }
+    }
+
+    printf("\n test_sgi_pool --- %s \n", ok ? "passed" : "FAILED");
+
+    return (ok ? 0 : 1);
+}
@@ -37,6 +37,99 @@
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+static
+PRO_INT64
+GetCpuTime_i() /* microseconds */
+{
+#if defined(WIN32)
+    FILETIME creationTime;
+    FILETIME exitTime;
+    FILETIME kernelTime;
+    FILETIME userTime;
+    if (!::GetProcessTimes(
+        ::GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+    {
+        return (0);
+    }
+
+    ULARGE_INTEGER kernel;
+    ULARGE_INTEGER user;
+    kernel.LowPart  = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart    = userTime.dwLowDateTime;
+    user.HighPart   = userTime.dwHighDateTime;
+
+    return ((PRO_INT64)((kernel.QuadPart + user.QuadPart) / 10)); /* 100ns */
+#else
+    return ((PRO_INT64)clock() * 1000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+/*
+ * the pingpong rate and the cpu time per pingpong since the last call.
+ * each connection has one pingpong in flight, so the round-trip time is
+ * the connections divided by the rate
+ */
+static
+void
+PrintMsgRate_i(const CTest*  tester,
+               unsigned long connectionCount)
+{
+    static PRO_UINT64 s_msgCount = 0;
+    static PRO_INT64  s_tick     = ProGetTickCount64();
+    static PRO_INT64  s_cpuTime  = GetCpuTime_i();
+
+    const PRO_UINT64 msgCount = tester->GetMsgCount();
+    const PRO_INT64  tick     = ProGetTickCount64();
+    const PRO_INT64  cpuTime  = GetCpuTime_i();
+
+    const PRO_UINT64 msgs     = msgCount - s_msgCount;
+    const PRO_INT64  ms       = tick     - s_tick;
+
+    printf(
+        " [ Msg  Rate ] : %u/s, %.2f us-cpu/msg, %.2f us-rtt \n"
+        ,
+        ms   > 0 ? (unsigned int)(msgs * 1000 / ms)                   : 0,
+        msgs > 0 ? (double)(cpuTime - s_cpuTime) / (double)msgs       : 0.0,
+        msgs > 0 ? (double)ms * 1000 * connectionCount / (double)msgs : 0.0
+        );
+
+    PRO_UINT64 fullCount    = 0;
+    PRO_UINT64 resumedCount = 0;
+    tester->GetSslHandshakeCounts(fullCount, resumedCount);
+
+    if (fullCount + resumedCount > 0)
+    {
+        printf(
+            " [ SSL  Hshk ] : %u full, %u resumed \n"
+            ,
+            (unsigned int)fullCount,
+            (unsigned int)resumedCount
+            );
+    }
+
+    PRO_UINT64 ctxCount    = 0;
+    PRO_UINT64 bufferBytes = 0;
+    tester->GetSslBufferInfo(ctxCount, bufferBytes);
+
+    if (ctxCount > 0)
+    {
+        printf(
+            " [ SSL  Bufs ] : %u bytes, %u bytes/conn \n"
+            ,
+            (unsigned int)bufferBytes,
+            (unsigned int)(bufferBytes / ctxCount)
+            );
+    }
+
+    s_msgCount = msgCount;
+    s_tick     = tick;
+    s_cpuTime  = cpuTime;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
 int main(int argc, char* argv[])
 {
     ProNetInit();
@@ -150,6 +243,18 @@ int main(int argc, char* argv[])
                     configInfo.tcpc_thread_count = value;
                 }
             }
+            else if (stricmp(configName.c_str(), "tcpc_io_uring") == 0)
+            {
+                configInfo.tcpc_io_uring = atoi(configValue.c_str()) != 0;
+            }
+            else if (stricmp(configName.c_str(), "tcpc_busy_poll_us") == 0)
+            {
+                const int value = atoi(configValue.c_str());
+                if (value >= 0 && value <= 1000000)
+                {
+                    configInfo.tcpc_busy_poll_us = value;
+                }
+            }
             else if (stricmp(configName.c_str(), "tcpc_server_ip") == 0)
             {
                 if (!configValue.empty())
@@ -236,6 +341,14 @@ int main(int argc, char* argv[])
                     configInfo.tcpc_recvpool_size = value;
                 }
             }
+            else if (stricmp(configName.c_str(), "tcpc_pingpong_bytes") == 0)
+            {
+                const int value = atoi(configValue.c_str());
+                if (value == 0 || (value >= 4 && value <= 1024))
+                {
+                    configInfo.tcpc_pingpong_bytes = value;
+                }
+            }
             else if (stricmp(configName.c_str(), "tcpc_enable_ssl") == 0)
             {
                 configInfo.tcpc_enable_ssl = atoi(configValue.c_str()) != 0;
@@ -244,6 +357,22 @@ int main(int argc, char* argv[])
             {
                 configInfo.tcpc_ssl_enable_sha1cert = atoi(configValue.c_str()) != 0;
             }
+            else if (stricmp(configName.c_str(), "tcpc_ssl_session_reuse") == 0)
+            {
+                configInfo.tcpc_ssl_session_reuse = atoi(configValue.c_str()) != 0;
+            }
+            else if (stricmp(configName.c_str(), "tcpc_ssl_dynamic_buffers") == 0)
+            {
+                configInfo.tcpc_ssl_dynamic_buffers = atoi(configValue.c_str()) != 0;
+            }
+            else if (stricmp(configName.c_str(), "tcpc_ssl_crypto_threads") == 0)
+            {
+                const int value = atoi(configValue.c_str());
+                if (value >= 0 && value <= 100)
+                {
+                    configInfo.tcpc_ssl_crypto_threads = value;
+                }
+            }
             else if (stricmp(configName.c_str(), "tcpc_ssl_cafile") == 0)
             {
                 if (!configValue.empty())
@@ -285,7 +414,15 @@ int main(int argc, char* argv[])
     static char s_traceInfo[2048] = "";
     s_traceInfo[sizeof(s_traceInfo) - 1] = '\0';
 
-    reactor = ProCreateReactor(configInfo.tcpc_thread_count);
+    {
+        PRO_REACTOR_OPTIONS options;
+        memset(&options, 0, sizeof(PRO_REACTOR_OPTIONS));
+        options.ioUring          = configInfo.tcpc_io_uring;
+        options.busyPollUs       = configInfo.tcpc_busy_poll_us;
+        options.sslCryptoThreads = configInfo.tcpc_ssl_crypto_threads;
+
+        reactor = ProCreateReactorEx(configInfo.tcpc_thread_count, 0, &options);
+    }
     if (reactor == NULL)
     {
         printf("\n test_tcp_client --- error! can't create reactor. \n");
@@ -319,6 +456,7 @@ int main(int argc, char* argv[])
     reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
     printf("%s", s_traceInfo);
     printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+    PrintMsgRate_i(tester, configInfo.tcpc_connection_count);
 
     while (1)
     {
@@ -366,6 +504,7 @@ int main(int argc, char* argv[])
             reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
             printf("%s", s_traceInfo);
             printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+            PrintMsgRate_i(tester, configInfo.tcpc_connection_count);
             continue;
         }
 
@@ -398,6 +537,7 @@ int main(int argc, char* argv[])
             reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
             printf("%s", s_traceInfo);
             printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+            PrintMsgRate_i(tester, configInfo.tcpc_connection_count);
         }
         else if (strnicmp(p, "htbtsize ", 9) == 0)
         {
@@ -415,6 +555,7 @@ int main(int argc, char* argv[])
             reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
             printf("%s", s_traceInfo);
             printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+            PrintMsgRate_i(tester, configInfo.tcpc_connection_count);
         }
         else
         {
@@ -50,6 +50,8 @@ CTest::CTest()
     m_heartbeatData[0] = 0;
     m_heartbeatData[1] = 0;
     m_heartbeatSize    = sizeof(PRO_UINT16);
+    m_pingpongSize     = 0;
+    m_msgCount         = 0;
 }
 
 CTest::~CTest()
@@ -88,6 +90,8 @@ CTest::Init(IProReactor*                  reactor,
             }
 
             ProSslClientConfig_EnableSha1Cert(sslConfig, configInfo.tcpc_ssl_enable_sha1cert);
+            ProSslClientConfig_EnableSessionReuse(sslConfig, configInfo.tcpc_ssl_session_reuse);
+            ProSslClientConfig_EnableDynamicBuffers(sslConfig, configInfo.tcpc_ssl_dynamic_buffers);
 
             CProStlVector<const char*>      caFiles;
             CProStlVector<const char*>      crlFiles;
@@ -139,6 +143,28 @@ CTest::Init(IProReactor*                  reactor,
             }
         }
 
+        /*
+         * a pingpong packet is a packet for testing purposes, and the
+         * server will echo it. [0, 'P', 0, 0, ...]
+         */
+        if (configInfo.tcpc_pingpong_bytes > 0)
+        {
+            unsigned long size = configInfo.tcpc_pingpong_bytes;
+            if (size < sizeof(PRO_UINT16) * 2)
+            {
+                size = sizeof(PRO_UINT16) * 2;
+            }
+            if (size > sizeof(m_pingpongData))
+            {
+                size = sizeof(m_pingpongData);
+            }
+
+            memset(m_pingpongData, 0, sizeof(m_pingpongData));
+            m_pingpongData[0]          = pbsd_hton16((PRO_UINT16)(size - sizeof(PRO_UINT16)));
+            ((char*)m_pingpongData)[3] = 'P';
+            m_pingpongSize             = size;
+        }
+
         m_reactor    = reactor;
         m_configInfo = configInfo;
         m_sslConfig  = sslConfig;
@@ -284,6 +310,50 @@ CTest::GetHeartbeatDataSize() const
     return (size);
 }
 
+PRO_UINT64
+CTest::GetMsgCount() const
+{
+    PRO_UINT64 count = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        count = m_msgCount;
+    }
+
+    return (count);
+}
+
+void
+CTest::GetSslHandshakeCounts(PRO_UINT64& fullCount,
+                             PRO_UINT64& resumedCount) const
+{
+    fullCount    = 0;
+    resumedCount = 0;
+
+    CProThreadMutexGuard mon(m_lock);
+
+    if (m_sslConfig != NULL)
+    {
+        ProSslClientConfig_GetHandshakeCounts(m_sslConfig, &fullCount, &resumedCount);
+    }
+}
+
+void
+CTest::GetSslBufferInfo(PRO_UINT64& ctxCount,
+                        PRO_UINT64& bufferBytes) const
+{
+    ctxCount    = 0;
+    bufferBytes = 0;
+
+    CProThreadMutexGuard mon(m_lock);
+
+    if (m_sslConfig != NULL)
+    {
+        ProSslClientConfig_GetBufferInfo(m_sslConfig, &ctxCount, &bufferBytes);
+    }
+}
+
 void
 CTest::SendMsg(const char* msg)
 {
@@ -549,6 +619,11 @@ CTest::OnHandshakeOk(IProTcpHandshaker* handshaker,
         {
             trans->StartHeartbeat();
             m_transports.insert(trans);
+
+            if (m_pingpongSize > 0)
+            {
+                trans->SendData(m_pingpongData, m_pingpongSize);
+            }
         }
 
         m_tcpHandshakers.erase(handshaker);
@@ -661,6 +736,11 @@ CTest::OnHandshakeOk(IProSslHandshaker* handshaker,
         {
             trans->StartHeartbeat();
             m_transports.insert(trans);
+
+            if (m_pingpongSize > 0)
+            {
+                trans->SendData(m_pingpongData, m_pingpongSize);
+            }
         }
 
         m_sslHandshakers.erase(handshaker);
@@ -770,6 +850,23 @@ CTest::OnRecv(IProTransport*          trans,
                 continue;
             }
 
+            /*
+             * a pingpong packet echoed by the server
+             */
+            if (m_pingpongSize > 0 && length == m_pingpongSize - sizeof(PRO_UINT16))
+            {
+                char head[2] = { 0 };
+                recvPool.PeekData(head, sizeof(head));
+                if (head[0] == '\0' && head[1] == 'P')
+                {
+                    recvPool.Flush(length);
+                    ++m_msgCount;
+
+                    trans->SendData(m_pingpongData, m_pingpongSize);
+                    continue;
+                }
+            }
+
             buf = (char*)ProMalloc(length + 1);
             if (buf == NULL)
             {
@@ -36,6 +36,8 @@ struct TCP_CLIENT_CONFIG_INFO
     TCP_CLIENT_CONFIG_INFO()
     {
         tcpc_thread_count        = 10;
+        tcpc_io_uring            = false;
+        tcpc_busy_poll_us        = 0;
         tcpc_server_ip           = "127.0.0.1";
         tcpc_server_port         = 3000;
         tcpc_local_ip            = "0.0.0.0";
@@ -47,9 +49,13 @@ struct TCP_CLIENT_CONFIG_INFO
         tcpc_sockbuf_size_recv   = 2048;
         tcpc_sockbuf_size_send   = 2048;
         tcpc_recvpool_size       = 2048;
+        tcpc_pingpong_bytes      = 0;
 
         tcpc_enable_ssl          = false;
         tcpc_ssl_enable_sha1cert = true;
+        tcpc_ssl_session_reuse   = true;
+        tcpc_ssl_dynamic_buffers = false;
+        tcpc_ssl_crypto_threads  = 0;
         tcpc_ssl_sni             = "server.libpro.org";
         tcpc_ssl_aes256          = false;
 
@@ -64,6 +70,8 @@ struct TCP_CLIENT_CONFIG_INFO
         CProConfigStream configStream;
 
         configStream.AddUint("tcpc_thread_count"       , tcpc_thread_count);
+        configStream.AddInt ("tcpc_io_uring"           , tcpc_io_uring);
+        configStream.AddUint("tcpc_busy_poll_us"       , tcpc_busy_poll_us);
         configStream.Add    ("tcpc_server_ip"          , tcpc_server_ip);
         configStream.AddUint("tcpc_server_port"        , tcpc_server_port);
         configStream.Add    ("tcpc_local_ip"           , tcpc_local_ip);
@@ -75,9 +83,13 @@ struct TCP_CLIENT_CONFIG_INFO
         configStream.AddUint("tcpc_sockbuf_size_recv"  , tcpc_sockbuf_size_recv);
         configStream.AddUint("tcpc_sockbuf_size_send"  , tcpc_sockbuf_size_send);
         configStream.AddUint("tcpc_recvpool_size"      , tcpc_recvpool_size);
+        configStream.AddUint("tcpc_pingpong_bytes"     , tcpc_pingpong_bytes);
 
         configStream.AddInt ("tcpc_enable_ssl"         , tcpc_enable_ssl);
         configStream.AddInt ("tcpc_ssl_enable_sha1cert", tcpc_ssl_enable_sha1cert);
+        configStream.AddInt ("tcpc_ssl_session_reuse"  , tcpc_ssl_session_reuse);
+        configStream.AddInt ("tcpc_ssl_dynamic_buffers", tcpc_ssl_dynamic_buffers);
+        configStream.AddUint("tcpc_ssl_crypto_threads" , tcpc_ssl_crypto_threads);
         configStream.Add    ("tcpc_ssl_cafile"         , tcpc_ssl_cafile);
         configStream.Add    ("tcpc_ssl_crlfile"        , tcpc_ssl_crlfile);
         configStream.Add    ("tcpc_ssl_sni"            , tcpc_ssl_sni);
@@ -87,6 +99,8 @@ struct TCP_CLIENT_CONFIG_INFO
     }
 
     unsigned int                 tcpc_thread_count;      /* 1 ~ 100 */
+    bool                         tcpc_io_uring;
+    unsigned int                 tcpc_busy_poll_us;      /* 0 ~ 1000000 */
     CProStlString                tcpc_server_ip;
     unsigned short               tcpc_server_port;
     CProStlString                tcpc_local_ip;
@@ -98,9 +112,13 @@ struct TCP_CLIENT_CONFIG_INFO
     unsigned int                 tcpc_sockbuf_size_recv; /* >= 1024 */
     unsigned int                 tcpc_sockbuf_size_send; /* >= 1024 */
     unsigned int                 tcpc_recvpool_size;     /* >= 1024 */
+    unsigned int                 tcpc_pingpong_bytes;    /* 0 or 4 ~ 1024 */
 
     bool                         tcpc_enable_ssl;
     bool                         tcpc_ssl_enable_sha1cert;
+    bool                         tcpc_ssl_session_reuse;
+    bool                         tcpc_ssl_dynamic_buffers;
+    unsigned int                 tcpc_ssl_crypto_threads; /* 0 ~ 100 */
     CProStlVector<CProStlString> tcpc_ssl_cafile;
     CProStlVector<CProStlString> tcpc_ssl_crlfile;
     CProStlString                tcpc_ssl_sni;
@@ -142,6 +160,18 @@ public:
 
     void SendMsg(const char* msg);
 
+    PRO_UINT64 GetMsgCount() const; /* the received pingpong packets */
+
+    void GetSslHandshakeCounts(
+        PRO_UINT64& fullCount,
+        PRO_UINT64& resumedCount
+        ) const;
+
+    void GetSslBufferInfo(
+        PRO_UINT64& ctxCount,
+        PRO_UINT64& bufferBytes
+        ) const;
+
 private:
 
     CTest();
@@ -240,6 +270,9 @@ private:
     CProStlSet<IProTransport*>     m_transports;
     PRO_UINT16                     m_heartbeatData[512];
     unsigned long                  m_heartbeatSize; /* 0 ~ 1024 */
+    PRO_UINT16                     m_pingpongData[512];
+    unsigned long                  m_pingpongSize;  /* 0 or 4 ~ 1024 */
+    PRO_UINT64                     m_msgCount;
 
     mutable CProThreadMutex        m_lock;
 
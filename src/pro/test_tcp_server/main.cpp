@@ -37,6 +37,95 @@
 /////////////////////////////////////////////////////////////////////////////
 ////
 
+static
+PRO_INT64
+GetCpuTime_i() /* microseconds */
+{
+#if defined(WIN32)
+    FILETIME creationTime;
+    FILETIME exitTime;
+    FILETIME kernelTime;
+    FILETIME userTime;
+    if (!::GetProcessTimes(
+        ::GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+    {
+        return (0);
+    }
+
+    ULARGE_INTEGER kernel;
+    ULARGE_INTEGER user;
+    kernel.LowPart  = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    user.LowPart    = userTime.dwLowDateTime;
+    user.HighPart   = userTime.dwHighDateTime;
+
+    return ((PRO_INT64)((kernel.QuadPart + user.QuadPart) / 10)); /* 100ns */
+#else
+    return ((PRO_INT64)clock() * 1000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+/*
+ * the pingpong rate and the cpu time per pingpong since the last call
+ */
+static
+void
+PrintMsgRate_i(const CTest* tester)
+{
+    static PRO_UINT64 s_msgCount = 0;
+    static PRO_INT64  s_tick     = ProGetTickCount64();
+    static PRO_INT64  s_cpuTime  = GetCpuTime_i();
+
+    const PRO_UINT64 msgCount = tester->GetMsgCount();
+    const PRO_INT64  tick     = ProGetTickCount64();
+    const PRO_INT64  cpuTime  = GetCpuTime_i();
+
+    const PRO_UINT64 msgs     = msgCount - s_msgCount;
+    const PRO_INT64  ms       = tick     - s_tick;
+
+    printf(
+        " [ Msg  Rate ] : %u/s, %.2f us-cpu/msg \n"
+        ,
+        ms   > 0 ? (unsigned int)(msgs * 1000 / ms)             : 0,
+        msgs > 0 ? (double)(cpuTime - s_cpuTime) / (double)msgs : 0.0
+        );
+
+    PRO_UINT64 fullCount    = 0;
+    PRO_UINT64 resumedCount = 0;
+    tester->GetSslHandshakeCounts(fullCount, resumedCount);
+
+    if (fullCount + resumedCount > 0)
+    {
+        printf(
+            " [ SSL  Hshk ] : %u full, %u resumed \n"
+            ,
+            (unsigned int)fullCount,
+            (unsigned int)resumedCount
+            );
+    }
+
+    PRO_UINT64 ctxCount    = 0;
+    PRO_UINT64 bufferBytes = 0;
+    tester->GetSslBufferInfo(ctxCount, bufferBytes);
+
+    if (ctxCount > 0)
+    {
+        printf(
+            " [ SSL  Bufs ] : %u bytes, %u bytes/conn \n"
+            ,
+            (unsigned int)bufferBytes,
+            (unsigned int)(bufferBytes / ctxCount)
+            );
+    }
+
+    s_msgCount = msgCount;
+    s_tick     = tick;
+    s_cpuTime  = cpuTime;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+////
+
 int main(int argc, char* argv[])
 {
     ProNetInit();
@@ -127,6 +216,18 @@ int main(int argc, char* argv[])
                     configInfo.tcps_thread_count = value;
                 }
             }
+            else if (stricmp(configName.c_str(), "tcps_io_uring") == 0)
+            {
+                configInfo.tcps_io_uring = atoi(configValue.c_str()) != 0;
+            }
+            else if (stricmp(configName.c_str(), "tcps_busy_poll_us") == 0)
+            {
+                const int value = atoi(configValue.c_str());
+                if (value >= 0 && value <= 1000000)
+                {
+                    configInfo.tcps_busy_poll_us = value;
+                }
+            }
             else if (stricmp(configName.c_str(), "tcps_using_hub") == 0)
             {
                 configInfo.tcps_using_hub = atoi(configValue.c_str()) != 0;
@@ -195,6 +296,22 @@ int main(int argc, char* argv[])
             {
                 configInfo.tcps_ssl_enable_sha1cert = atoi(configValue.c_str()) != 0;
             }
+            else if (stricmp(configName.c_str(), "tcps_ssl_session_reuse") == 0)
+            {
+                configInfo.tcps_ssl_session_reuse = atoi(configValue.c_str()) != 0;
+            }
+            else if (stricmp(configName.c_str(), "tcps_ssl_dynamic_buffers") == 0)
+            {
+                configInfo.tcps_ssl_dynamic_buffers = atoi(configValue.c_str()) != 0;
+            }
+            else if (stricmp(configName.c_str(), "tcps_ssl_crypto_threads") == 0)
+            {
+                const int value = atoi(configValue.c_str());
+                if (value >= 0 && value <= 100)
+                {
+                    configInfo.tcps_ssl_crypto_threads = value;
+                }
+            }
             else if (stricmp(configName.c_str(), "tcps_ssl_cafile") == 0)
             {
                 if (!configValue.empty())
@@ -229,7 +346,15 @@ int main(int argc, char* argv[])
     static char s_traceInfo[2048] = "";
     s_traceInfo[sizeof(s_traceInfo) - 1] = '\0';
 
-    reactor = ProCreateReactor(configInfo.tcps_thread_count);
+    {
+        PRO_REACTOR_OPTIONS options;
+        memset(&options, 0, sizeof(PRO_REACTOR_OPTIONS));
+        options.ioUring          = configInfo.tcps_io_uring;
+        options.busyPollUs       = configInfo.tcps_busy_poll_us;
+        options.sslCryptoThreads = configInfo.tcps_ssl_crypto_threads;
+
+        reactor = ProCreateReactorEx(configInfo.tcps_thread_count, 0, &options);
+    }
     if (reactor == NULL)
     {
         printf("\n test_tcp_server --- error! can't create reactor. \n");
@@ -268,6 +393,7 @@ int main(int argc, char* argv[])
     reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
     printf("%s", s_traceInfo);
     printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+    PrintMsgRate_i(tester);
 
     while (1)
     {
@@ -312,6 +438,7 @@ int main(int argc, char* argv[])
             reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
             printf("%s", s_traceInfo);
             printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+            PrintMsgRate_i(tester);
             continue;
         }
 
@@ -344,6 +471,7 @@ int main(int argc, char* argv[])
             reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
             printf("%s", s_traceInfo);
             printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+            PrintMsgRate_i(tester);
         }
         else if (strnicmp(p, "htbtsize ", 9) == 0)
         {
@@ -361,12 +489,14 @@ int main(int argc, char* argv[])
             reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
             printf("%s", s_traceInfo);
             printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+            PrintMsgRate_i(tester);
         }
         else
         {
             reactor->GetTraceInfo(s_traceInfo, sizeof(s_traceInfo));
             printf("%s", s_traceInfo);
             printf(" [ HTBT Size ] : %u \n", (unsigned int)tester->GetHeartbeatDataSize());
+            PrintMsgRate_i(tester);
         }
     } /* end of while (...) */
 
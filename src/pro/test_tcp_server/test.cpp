@@ -49,6 +49,7 @@ CTest::CTest()
     m_heartbeatData[0] = 0;
     m_heartbeatData[1] = 0;
     m_heartbeatSize    = sizeof(PRO_UINT16);
+    m_msgCount         = 0;
 }
 
 CTest::~CTest()
@@ -94,6 +95,14 @@ CTest::Init(IProReactor*                  reactor,
 
             ProSslServerConfig_EnableSha1Cert(sslConfig, configInfo.tcps_ssl_enable_sha1cert);
 
+            if (configInfo.tcps_ssl_session_reuse)
+            {
+                ProSslServerConfig_EnableSessionTickets(sslConfig, true, 0);
+                ProSslServerConfig_SetSessionCache(sslConfig, 10000, 0);
+            }
+
+            ProSslServerConfig_EnableDynamicBuffers(sslConfig, configInfo.tcps_ssl_dynamic_buffers);
+
             CProStlVector<const char*> caFiles;
             CProStlVector<const char*> crlFiles;
             CProStlVector<const char*> certFiles;
@@ -314,6 +323,50 @@ CTest::GetTransportCount() const
     return (count);
 }
 
+PRO_UINT64
+CTest::GetMsgCount() const
+{
+    PRO_UINT64 count = 0;
+
+    {
+        CProThreadMutexGuard mon(m_lock);
+
+        count = m_msgCount;
+    }
+
+    return (count);
+}
+
+void
+CTest::GetSslHandshakeCounts(PRO_UINT64& fullCount,
+                             PRO_UINT64& resumedCount) const
+{
+    fullCount    = 0;
+    resumedCount = 0;
+
+    CProThreadMutexGuard mon(m_lock);
+
+    if (m_sslConfig != NULL)
+    {
+        ProSslServerConfig_GetHandshakeCounts(m_sslConfig, &fullCount, &resumedCount);
+    }
+}
+
+void
+CTest::GetSslBufferInfo(PRO_UINT64& ctxCount,
+                        PRO_UINT64& bufferBytes) const
+{
+    ctxCount    = 0;
+    bufferBytes = 0;
+
+    CProThreadMutexGuard mon(m_lock);
+
+    if (m_sslConfig != NULL)
+    {
+        ProSslServerConfig_GetBufferInfo(m_sslConfig, &ctxCount, &bufferBytes);
+    }
+}
+
 void
 PRO_CALLTYPE
 CTest::OnAccept(IProAcceptor*  acceptor,
@@ -782,12 +835,20 @@ CTest::OnRecv(IProTransport*          trans,
              */
             if (buf[sizeof(PRO_UINT16)] == '\0')
             {
-                ProFree(buf);
-                continue;
+                /*
+                 * a pingpong packet. [0, 'P', 0, 0, ...]
+                 */
+                if (buf[sizeof(PRO_UINT16) + 1] != 'P')
+                {
+                    ProFree(buf);
+                    continue;
+                }
+
+                ++m_msgCount;
             }
         }
 
-        if (1)
+        if (buf[sizeof(PRO_UINT16)] != '\0')
         {{{
             char remoteIp[64] = "";
             trans->GetRemoteIp(remoteIp);
@@ -35,6 +35,8 @@ struct TCP_SERVER_CONFIG_INFO
     TCP_SERVER_CONFIG_INFO()
     {
         tcps_thread_count        = 40;
+        tcps_io_uring            = false;
+        tcps_busy_poll_us        = 0;
         tcps_using_hub           = false;
         tcps_port                = 3000;
         tcps_handshake_timeout   = 20;
@@ -46,6 +48,9 @@ struct TCP_SERVER_CONFIG_INFO
 
         tcps_enable_ssl          = true;
         tcps_ssl_enable_sha1cert = true;
+        tcps_ssl_session_reuse   = true;
+        tcps_ssl_dynamic_buffers = false;
+        tcps_ssl_crypto_threads  = 0;
         tcps_ssl_keyfile         = "./server.key";
 
         tcps_ssl_cafile.push_back("./ca.crt");
@@ -61,6 +66,8 @@ struct TCP_SERVER_CONFIG_INFO
         CProConfigStream configStream;
 
         configStream.AddUint("tcps_thread_count"       , tcps_thread_count);
+        configStream.AddInt ("tcps_io_uring"           , tcps_io_uring);
+        configStream.AddUint("tcps_busy_poll_us"       , tcps_busy_poll_us);
         configStream.AddInt ("tcps_using_hub"          , tcps_using_hub);
         configStream.AddUint("tcps_port"               , tcps_port);
         configStream.AddUint("tcps_handshake_timeout"  , tcps_handshake_timeout);
@@ -72,6 +79,9 @@ struct TCP_SERVER_CONFIG_INFO
 
         configStream.AddInt ("tcps_enable_ssl"         , tcps_enable_ssl);
         configStream.AddInt ("tcps_ssl_enable_sha1cert", tcps_ssl_enable_sha1cert);
+        configStream.AddInt ("tcps_ssl_session_reuse"  , tcps_ssl_session_reuse);
+        configStream.AddInt ("tcps_ssl_dynamic_buffers", tcps_ssl_dynamic_buffers);
+        configStream.AddUint("tcps_ssl_crypto_threads" , tcps_ssl_crypto_threads);
         configStream.Add    ("tcps_ssl_cafile"         , tcps_ssl_cafile);
         configStream.Add    ("tcps_ssl_crlfile"        , tcps_ssl_crlfile);
         configStream.Add    ("tcps_ssl_certfile"       , tcps_ssl_certfile);
@@ -81,6 +91,8 @@ struct TCP_SERVER_CONFIG_INFO
     }
 
     unsigned int                 tcps_thread_count;      /* 1 ~ 100 */
+    bool                         tcps_io_uring;
+    unsigned int                 tcps_busy_poll_us;      /* 0 ~ 1000000 */
     bool                         tcps_using_hub;
     unsigned short               tcps_port;
     unsigned int                 tcps_handshake_timeout;
@@ -92,6 +104,9 @@ struct TCP_SERVER_CONFIG_INFO
 
     bool                         tcps_enable_ssl;
     bool                         tcps_ssl_enable_sha1cert;
+    bool                         tcps_ssl_session_reuse;
+    bool                         tcps_ssl_dynamic_buffers;
+    unsigned int                 tcps_ssl_crypto_threads; /* 0 ~ 100 */
     CProStlVector<CProStlString> tcps_ssl_cafile;
     CProStlVector<CProStlString> tcps_ssl_crlfile;
     CProStlVector<CProStlString> tcps_ssl_certfile;
@@ -133,6 +148,18 @@ public:
 
     unsigned long GetTransportCount() const;
 
+    PRO_UINT64 GetMsgCount() const; /* the echoed pingpong packets */
+
+    void GetSslHandshakeCounts(
+        PRO_UINT64& fullCount,
+        PRO_UINT64& resumedCount
+        ) const;
+
+    void GetSslBufferInfo(
+        PRO_UINT64& ctxCount,
+        PRO_UINT64& bufferBytes
+        ) const;
+
 private:
 
     CTest();
@@ -222,6 +249,7 @@ private:
     CProStlSet<IProTransport*>                 m_transports;
     PRO_UINT16                                 m_heartbeatData[512];
     unsigned long                              m_heartbeatSize; /* 0 ~ 1024 */
+    PRO_UINT64                                 m_msgCount;
 
     mutable CProThreadMutex                    m_lock;
 